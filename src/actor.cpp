@@ -33,13 +33,13 @@ void Actor::setMap(Map *map)
 {
     // Remove Actor from potential previous map
     if (mMap)
-        mMap->removeActor(mMapActor);
+        mMap->removeActor(this);
 
     mMap = map;
 
     // Add Actor to potential new map
     if (mMap)
-        mMapActor = mMap->addActor(this);
+        mMap->addActor(this);
 }
 
 int Actor::getTileX() const
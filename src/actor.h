@@ -22,14 +22,14 @@
 
 #include "vector.h"
 
-#include <list>
+#include <vector>
 
 class Actor;
 class Graphics;
 class Image;
 class Map;
 
-using Actors = std::list<Actor *>;
+using Actors = std::vector<Actor *>;
 
 class Actor
 {
@@ -114,5 +114,7 @@ protected:
     Vector mPos;                /**< Position in pixels relative to map. */
 
 private:
-    Actors::iterator mMapActor;
+    friend class Map;
+
+    int mMapIndex = -1;         /**< Index in the actors of the map. */
 };
@@ -78,11 +78,19 @@ bool ActorSprite::drawSpriteAt(Graphics *graphics, int x, int y) const
 
 void ActorSprite::logic()
 {
-    // Update sprite animations
-    mSprites.update(Time::deltaTimeMs());
+    if (mNearby)
+    {
+        // Update sprite animations, catching up on any skipped time
+        mSprites.update(mSkippedAnimationTime + Time::deltaTimeMs());
+        mSkippedAnimationTime = 0;
 
-    if (mUsedTargetCursor)
-        mUsedTargetCursor->update(Time::deltaTimeMs());
+        if (mUsedTargetCursor)
+            mUsedTargetCursor->update(Time::deltaTimeMs());
+    }
+    else
+    {
+        mSkippedAnimationTime += Time::deltaTimeMs();
+    }
 
     // Erase all extinct particle effects
     mChildParticleEffects.erase(std::remove_if(mChildParticleEffects.begin(),
@@ -96,6 +104,21 @@ void ActorSprite::logic()
         p->moveTo(mPos.x, py);
 }
 
+void ActorSprite::setNearby(bool nearby)
+{
+    if (mNearby == nearby)
+        return;
+
+    mNearby = nearby;
+    setParticleEmissionPaused(!nearby);
+}
+
+void ActorSprite::setParticleEmissionPaused(bool paused)
+{
+    for (auto &particle : mChildParticleEffects)
+        particle->setEmissionPaused(paused);
+}
+
 void ActorSprite::setMap(Map* map)
 {
     Actor::setMap(map);
@@ -106,6 +129,10 @@ void ActorSprite::setMap(Map* map)
 
 void ActorSprite::controlParticle(Particle *particle)
 {
+    if (!particle)
+        return;
+
+    particle->setEmissionPaused(!mNearby);
     mChildParticleEffects.emplace_back(particle);
 }
 
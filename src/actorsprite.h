@@ -78,6 +78,14 @@ public:
 
     virtual void logic();
 
+    /**
+     * Sets whether the actor is near the visible area. Actors further away
+     * keep moving, but their animations are only caught up once they come
+     * near again, and their particle effects stop emitting.
+     */
+    void setNearby(bool nearby);
+    bool isNearby() const { return mNearby; }
+
     void setMap(Map* map) override;
 
     /**
@@ -113,6 +121,11 @@ public:
     int getWidth() const { return mSprites.getWidth(); }
     int getHeight() const { return mSprites.getHeight(); }
 
+    /**
+     * Returns a number that changes whenever the sprites look different.
+     */
+    unsigned getSpriteChangeCount() const { return mSprites.getChangeCount(); }
+
     /**
      * Returns the Y coordinate of the top of the sprite, taking the sprite
      * offset into account. Uses the smallest offset over all frames so that
@@ -128,6 +141,12 @@ protected:
     void setupSpriteDisplay(const SpriteDisplay &display,
                             bool forceDisplay = true);
 
+    /**
+     * Pauses or resumes the emission of the particle effects attached to
+     * this actor.
+     */
+    virtual void setParticleEmissionPaused(bool paused);
+
     int mId;
     std::vector<ParticleHandle> mChildParticleEffects;
 
@@ -156,4 +175,9 @@ private:
 
     /** Target cursor being used */
     SimpleAnimation *mUsedTargetCursor = nullptr;
+
+    bool mNearby = true;
+
+    /** Time in milliseconds the sprite animations are behind */
+    int mSkippedAnimationTime = 0;
 };
@@ -23,8 +23,11 @@
 
 #include "configuration.h"
 #include "game.h"
+#include "graphics.h"
 #include "localplayer.h"
 
+#include "gui/viewport.h"
+
 #include "net/net.h"
 #include "net/chathandler.h"
 
@@ -272,9 +275,37 @@ const ActorSprites &ActorSpriteManager::getAll() const
 
 void ActorSpriteManager::logic()
 {
+    // Actors within this area of the visible map get a full update
+    const int distance = config.actorLogicDistance;
+    const bool throttle = distance >= 0 && viewport;
+    gcn::Rectangle nearbyArea;
+
+    if (throttle)
+    {
+        nearbyArea = gcn::Rectangle(viewport->getCameraX() - distance,
+                                    viewport->getCameraY() - distance,
+                                    graphics->getWidth() + 2 * distance,
+                                    graphics->getHeight() + 2 * distance);
+    }
+
+    mNearbyUpdates = 0;
+    mDistantUpdates = 0;
+
     for (auto actor : mActors)
+    {
+        const bool nearby = !throttle || actor == local_player ||
+                nearbyArea.isPointInRect(actor->getPixelX(),
+                                         actor->getPixelY());
+
+        actor->setNearby(nearby);
         actor->logic();
 
+        if (nearby)
+            ++mNearbyUpdates;
+        else
+            ++mDistantUpdates;
+    }
+
     for (auto actor : mDeleteActors)
     {
         mActors.erase(actor);
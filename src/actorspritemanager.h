@@ -141,10 +141,22 @@ class ActorSpriteManager : public EventListener
 
         /**
          * Performs ActorSprite logic and deletes ActorSprite scheduled to be
-         * deleted.
+         * deleted. Actors far from the visible area get a reduced update.
          */
         void logic();
 
+        /**
+         * Returns the number of actors that got a full update in the last
+         * call to logic().
+         */
+        int getNearbyUpdateCount() const { return mNearbyUpdates; }
+
+        /**
+         * Returns the number of actors that got a reduced update in the last
+         * call to logic().
+         */
+        int getDistantUpdateCount() const { return mDistantUpdates; }
+
         /**
          * Destroys all ActorSprites except the local player
          */
@@ -167,6 +179,8 @@ class ActorSpriteManager : public EventListener
         ActorSprites mActors;
         ActorSprites mDeleteActors;
         Map *mMap;
+        int mNearbyUpdates = 0;
+        int mDistantUpdates = 0;
 };
 
 extern ActorSpriteManager *actorSpriteManager;
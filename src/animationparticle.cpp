@@ -31,13 +31,6 @@ AnimationParticle::AnimationParticle(Animation animation):
 {
 }
 
-AnimationParticle::AnimationParticle(XML::Node animationNode,
-                                     const std::string &dyePalettes):
-    ImageParticle(nullptr),
-    mAnimation(animationNode, dyePalettes)
-{
-}
-
 AnimationParticle::~AnimationParticle()
 {
     // Prevent ImageParticle from decreasing the reference count of the image
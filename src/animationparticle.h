@@ -24,16 +24,12 @@
 #include "imageparticle.h"
 #include "simpleanimation.h"
 
-#include "utils/xml.h"
-
 class Map;
 
 class AnimationParticle : public ImageParticle
 {
     public:
         explicit AnimationParticle(Animation animation);
-        explicit AnimationParticle(XML::Node animationNode,
-                                   const std::string &dyePalettes = std::string());
 
         ~AnimationParticle() override;
 
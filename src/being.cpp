@@ -62,6 +62,24 @@
 
 #include <cmath>
 
+/**
+ * Differences to the server position up to this many pixels are left to the
+ * movement along the path, when not predicting movement.
+ */
+static constexpr float POSITION_DIFF_TOLERANCE = 48.0f;
+
+/**
+ * With movement prediction, differences beyond this many pixels are
+ * corrected smoothly, and differences beyond the snap distance immediately.
+ */
+static constexpr float POSITION_SMOOTH_TOLERANCE = 4.0f;
+static constexpr int POSITION_SNAP_TILES = 3;
+
+/**
+ * The time over which smooth position corrections are applied.
+ */
+static constexpr int POSITION_CORRECTION_MS = 200;
+
 Being::Being(int id, Type type, int subtype, Map *map)
     : ActorSprite(id)
     , mInfo(BeingInfo::Unknown)
@@ -110,11 +128,13 @@ void Being::setType(Type type, int subtype)
         mInfo = MonsterDB::get(mSubType);
         setName(mInfo->name);
         setupSpriteDisplay(mInfo->display);
+        preloadSounds();
         break;
     case NPC:
         mInfo = NPCDB::get(mSubType);
         setupSpriteDisplay(mInfo->display, false);
         mShowName = true;
+        preloadSounds();
         break;
     case PLAYER: {
         mSprites.clear();
@@ -145,6 +165,13 @@ void Being::setType(Type type, int subtype)
     updateColors();
 }
 
+void Being::preloadSounds() const
+{
+    for (const auto &[_, files] : mInfo->getSounds())
+        for (const auto &file : files)
+            sound.preloadSfx(file);
+}
+
 bool Being::isTargetSelection() const
 {
     return mInfo->targetSelection;
@@ -185,6 +212,14 @@ int Being::getSpeechTextYPosition() const
 }
 
 void Being::setPosition(const Vector &pos)
+{
+    // An explicit position overrides any pending correction
+    stopPositionCorrection();
+
+    updatePosition(pos);
+}
+
+void Being::updatePosition(const Vector &pos)
 {
     Actor::setPosition(pos);
 
@@ -194,6 +229,55 @@ void Being::setPosition(const Vector &pos)
         mText->adviseXY(getPixelX(), getSpeechTextYPosition());
 }
 
+void Being::reconcilePosition(const Vector &serverPos)
+{
+    const float distance = (serverPos - mPos).length();
+
+    if (!config.movementPrediction)
+    {
+        // Don't set the position when we're close enough, since the movement
+        // algorithm can guess it and it would break the animation played.
+        if (distance > POSITION_DIFF_TOLERANCE)
+            setPosition(serverPos);
+        return;
+    }
+
+    const float snapDistance = mMap ? POSITION_SNAP_TILES * mMap->getTileWidth()
+                                    : POSITION_DIFF_TOLERANCE;
+
+    if (distance > snapDistance)
+    {
+        setPosition(serverPos);
+    }
+    else if (distance > POSITION_SMOOTH_TOLERANCE)
+    {
+        mPositionCorrection = serverPos - mPos;
+        mPositionCorrectionTime = POSITION_CORRECTION_MS;
+    }
+}
+
+void Being::reconcileMovement(const Vector &src, const Vector &dst,
+                              int latencyMs)
+{
+    Vector predicted = src;
+
+    // Dead reckoning: assume the being kept walking while the message was
+    // on its way, along a straight line towards its destination.
+    if (config.movementPrediction && latencyMs > 0)
+    {
+        const Vector toDest = dst - src;
+        const float distance = toDest.length();
+        const float walked = mSpeedPixelsPerSecond.x * latencyMs / 1000.0f;
+
+        if (distance > 0.0f)
+            predicted = walked >= distance ? dst
+                                           : src + toDest * (walked / distance);
+    }
+
+    reconcilePosition(predicted);
+    Being::setDestination(dst.x, dst.y);
+}
+
 void Being::setDestination(int dstX, int dstY)
 {
     // We can't calculate anything without a map anyway.
@@ -616,25 +700,28 @@ void Being::updateStatusEffect(int id, bool newStatus)
         return;
 
     if (Particle *particle = effect->getParticle(newStatus))
+    {
+        particle->setEmissionPaused(!isNearby());
         mStatusParticleEffects[id] = ParticleHandle(particle);
+    }
     else
         mStatusParticleEffects.erase(id);
 }
 
 void Being::setAction(Action action, int attackId)
 {
-    std::string currentAction = SpriteAction::INVALID;
+    ActionId currentAction = SpriteAction::INVALID_ID;
 
     switch (action)
     {
         case MOVE:
-            currentAction = SpriteAction::MOVE;
+            currentAction = SpriteAction::MOVE_ID;
             // Note: When adding a run action,
             // Differentiate walk and run with action name,
             // while using only the ACTION_MOVE.
             break;
         case SIT:
-            currentAction = SpriteAction::SIT;
+            currentAction = SpriteAction::SIT_ID;
             break;
         case ATTACK:
             if (mEquippedWeapon)
@@ -666,28 +753,28 @@ void Being::setAction(Action action, int attackId)
 
             break;
         case HURT:
-            //currentAction = SpriteAction::HURT;// Buggy: makes the player stop
+            //currentAction = SpriteAction::HURT_ID;// Buggy: makes the player stop
                                             // attacking and unable to attack
                                             // again until he moves.
                                             // TODO: fix this!
             break;
         case DEAD:
-            currentAction = SpriteAction::DEAD;
+            currentAction = SpriteAction::DEAD_ID;
             sound.playSfx(mInfo->getSound(SoundEvent::Die),
                           getPixelX(), getPixelY());
             break;
         case STAND:
-            currentAction = SpriteAction::STAND;
+            currentAction = SpriteAction::STAND_ID;
             break;
     }
 
-    if (currentAction != SpriteAction::INVALID)
+    if (currentAction != SpriteAction::INVALID_ID)
     {
         mSprites.play(currentAction);
         mAction = action;
     }
 
-    if (currentAction != SpriteAction::MOVE)
+    if (currentAction != SpriteAction::MOVE_ID)
         mActionTimer.set();
 }
 
@@ -831,6 +918,9 @@ void Being::logic()
         }
     }
 
+    if (mPositionCorrectionTime > 0)
+        updatePositionCorrection();
+
     if (mAction != DEAD && !mSpeedPixelsPerSecond.isNull())
     {
         updateMovement();
@@ -855,6 +945,24 @@ void Being::logic()
             actorSpriteManager->scheduleDelete(this);
 }
 
+void Being::updatePositionCorrection()
+{
+    const int dt = std::min<int>(Time::deltaTimeMs(), mPositionCorrectionTime);
+    const Vector step = mPositionCorrection * (static_cast<float>(dt) /
+                                               mPositionCorrectionTime);
+
+    mPositionCorrection -= step;
+    mPositionCorrectionTime -= dt;
+
+    updatePosition(mPos + step);
+}
+
+void Being::stopPositionCorrection()
+{
+    mPositionCorrection = Vector();
+    mPositionCorrectionTime = 0;
+}
+
 void Being::updateMovement()
 {
     float dt = Time::deltaTime();
@@ -895,7 +1003,7 @@ void Being::updateMovement()
             // Test if we don't miss the destination by a move too far:
             if (distanceToMove > distanceToDest)
             {
-                setPosition(dest);
+                updatePosition(dest);
 
                 // Also, if the destination is reached, try to get the next
                 // path point, if existing.
@@ -913,7 +1021,7 @@ void Being::updateMovement()
             else
             {
                 // Otherwise, go to it using the nominal speed.
-                setPosition(mPos + diff);
+                updatePosition(mPos + diff);
                 // And set the remaining time to 0.
                 dt = 0.f;
             }
@@ -953,6 +1061,10 @@ void Being::updateMovement()
         }
         else
         {
+            // Walking got us to the destination, so any correction left
+            // would only push us past it.
+            stopPositionCorrection();
+
             if (mAction == MOVE)
                 setAction(STAND);
             break;
@@ -1119,11 +1231,26 @@ void Being::addSpriteParticles(SpriteState &spriteState, const SpriteDisplay &di
 
     for (const auto &particle : display.particles)
     {
-        Particle *p = particleEngine->addEffect(particle, 0, 0, 0);
-        spriteState.particles.emplace_back(p);
+        if (Particle *p = particleEngine->addEffect(particle, 0, 0, 0))
+        {
+            p->setEmissionPaused(!isNearby());
+            spriteState.particles.emplace_back(p);
+        }
     }
 }
 
+void Being::setParticleEmissionPaused(bool paused)
+{
+    ActorSprite::setParticleEmissionPaused(paused);
+
+    for (auto &spriteState : mSpriteStates)
+        for (auto &particle : spriteState.particles)
+            particle->setEmissionPaused(paused);
+
+    for (auto &[_, particle] : mStatusParticleEffects)
+        particle->setEmissionPaused(paused);
+}
+
 void Being::restoreAllSpriteParticles()
 {
     if (mType != PLAYER)
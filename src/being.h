@@ -386,6 +386,21 @@ class Being : public ActorSprite, public EventListener, public gcn::DeathListene
             setPosition(Vector(x, y, z));
         }
 
+        /**
+         * Moves the being towards a position reported by the server. Small
+         * differences are left to the movement along the path, larger ones
+         * are corrected over a short time and large ones immediately.
+         */
+        void reconcilePosition(const Vector &serverPos);
+
+        /**
+         * Handles a movement from \a src to \a dst reported by the server
+         * \a latencyMs ago. With movement prediction, the being is assumed
+         * to have walked on towards the destination in the meantime.
+         */
+        void reconcileMovement(const Vector &src, const Vector &dst,
+                               int latencyMs);
+
         /**
          * Returns the being's pixel radius used to detect collisions.
          */
@@ -485,6 +500,8 @@ class Being : public ActorSprite, public EventListener, public gcn::DeathListene
         void addSpriteParticles(SpriteState &spriteState, const SpriteDisplay &display);
         void restoreAllSpriteParticles();
 
+        void setParticleEmissionPaused(bool paused) override;
+
         void updateColors();
         void updatePlayerSprites();
 
@@ -552,6 +569,26 @@ class Being : public ActorSprite, public EventListener, public gcn::DeathListene
     private:
         void updateMovement();
 
+        /**
+         * Moves the being without cancelling a pending position correction.
+         */
+        void updatePosition(const Vector &pos);
+
+        /**
+         * Applies part of the pending position correction.
+         */
+        void updatePositionCorrection();
+
+        /**
+         * Drops the pending position correction.
+         */
+        void stopPositionCorrection();
+
+        /**
+         * Starts loading the sounds of this being in the background.
+         */
+        void preloadSounds() const;
+
         Type mType = UNKNOWN;
 
         std::set<int> mStatusEffects;   /**< set of active status effects */
@@ -572,6 +609,9 @@ class Being : public ActorSprite, public EventListener, public gcn::DeathListene
          */
         Vector mSpeedPixelsPerSecond;
 
+        Vector mPositionCorrection;     /**< Remaining correction in pixels */
+        int mPositionCorrectionTime = 0;    /**< Remaining time in ms */
+
         int mDamageTaken = 0;
         int mIp = 0;
 };
@@ -0,0 +1,524 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "chathistory.h"
+
+#include "configuration.h"
+#include "log.h"
+
+#include "utils/mappedfile.h"
+#include "utils/mkdir.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+/**
+ * The history of a channel consists of two files. The ".chat" file holds the
+ * lines, each preceded by a LineHeader. The ".index" file holds a Posting for
+ * each distinct word of each line, in the order the lines were added.
+ *
+ * Both files start with a magic string and are stored in native byte order,
+ * since they never leave the machine.
+ */
+static constexpr char LINES_MAGIC[8] = "MANACHT";
+static constexpr char INDEX_MAGIC[8] = "MANAIDX";
+
+struct LineHeader
+{
+    int64_t time;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+struct Posting
+{
+    uint32_t word;
+    uint32_t line;
+};
+
+static_assert(sizeof(LineHeader) == 16);
+static_assert(sizeof(Posting) == 8);
+
+static uint32_t hashWord(std::string_view word)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : word)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Calls \a f with each word of the given line, in lower case. Color codes
+ * are skipped and any bytes outside of ASCII are considered part of a word.
+ */
+template<typename F>
+static void forEachWord(std::string_view text, F f)
+{
+    std::string word;
+    for (size_t i = 0; i <= text.size(); ++i)
+    {
+        const unsigned char c = i < text.size() ? text[i] : 0;
+
+        if (c == '#' && i + 2 < text.size() && text[i + 1] == '#')
+        {
+            i += 2;
+        }
+        else if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c >= 0x80)
+        {
+            word += static_cast<char>(c);
+            continue;
+        }
+        else if (c >= 'A' && c <= 'Z')
+        {
+            word += static_cast<char>(c - 'A' + 'a');
+            continue;
+        }
+
+        if (!word.empty())
+        {
+            f(word);
+            word.clear();
+        }
+    }
+}
+
+static std::vector<std::string> uniqueWords(std::string_view text)
+{
+    std::vector<std::string> words;
+    forEachWord(text, [&] (const std::string &word) {
+        if (std::find(words.begin(), words.end(), word) == words.end())
+            words.push_back(word);
+    });
+    return words;
+}
+
+static std::string secureName(std::string name)
+{
+    for (char &c : name)
+    {
+        const unsigned char ch = c;
+        if ((ch < '0' || ch > '9') &&
+            (ch < 'a' || ch > 'z') &&
+            (ch < 'A' || ch > 'Z') &&
+            ch != '-' && ch != '.' && ch != '#')
+        {
+            c = '_';
+        }
+    }
+    return name;
+}
+
+struct ChatHistory::Channel
+{
+    ~Channel();
+
+    bool open(const std::string &path);
+
+    void append(time_t time, std::string_view line);
+    Entry entry(size_t index);
+
+    /**
+     * Makes sure the mapping covers all lines written so far.
+     */
+    void updateMapping();
+
+    /**
+     * Loads the word index into memory, catching up on any lines that were
+     * not indexed, or rebuilding it when it is unusable.
+     */
+    void loadIndex();
+
+    void indexLine(uint32_t line, std::string_view text);
+
+    std::string linesPath;
+    std::string indexPath;
+    FILE *linesFile = nullptr;
+    FILE *indexFile = nullptr;
+
+    MappedFile lines;
+    uint64_t linesSize = 0;
+    std::vector<uint64_t> offsets;  /**< File offset of each line */
+
+    bool indexLoaded = false;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+};
+
+ChatHistory::Channel::~Channel()
+{
+    if (linesFile)
+        fclose(linesFile);
+    if (indexFile)
+        fclose(indexFile);
+}
+
+bool ChatHistory::Channel::open(const std::string &path)
+{
+    linesPath = path + ".chat";
+    indexPath = path + ".index";
+
+    std::error_code ec;
+    const auto existingSize = std::filesystem::file_size(linesPath, ec);
+
+    if (!ec && existingSize > 0)
+    {
+        if (!lines.map(linesPath))
+        {
+            Log::warn("Couldn't map chat history: %s", linesPath.c_str());
+            return false;
+        }
+
+        const uint8_t *data = lines.data();
+        const uint64_t size = lines.size();
+
+        if (size < sizeof(LINES_MAGIC) ||
+            memcmp(data, LINES_MAGIC, sizeof(LINES_MAGIC)) != 0)
+        {
+            Log::warn("Unsupported chat history: %s", linesPath.c_str());
+            return false;
+        }
+
+        // Find the start of each line, stopping at an incomplete line
+        uint64_t pos = sizeof(LINES_MAGIC);
+        while (size - pos >= sizeof(LineHeader))
+        {
+            LineHeader header;
+            memcpy(&header, data + pos, sizeof(header));
+
+            const uint64_t end = pos + sizeof(header) + header.length;
+            if (end > size)
+                break;
+
+            offsets.push_back(pos);
+            pos = end;
+        }
+
+        linesSize = pos;
+
+        if (linesSize < size)
+        {
+            Log::warn("Discarding incomplete line from chat history: %s",
+                      linesPath.c_str());
+            lines.unmap();
+            std::filesystem::resize_file(linesPath, linesSize, ec);
+            if (ec)
+                return false;
+        }
+
+        linesFile = fopen(linesPath.c_str(), "ab");
+    }
+    else
+    {
+        linesFile = fopen(linesPath.c_str(), "wb");
+        if (linesFile)
+        {
+            fwrite(LINES_MAGIC, sizeof(LINES_MAGIC), 1, linesFile);
+            fflush(linesFile);
+        }
+        linesSize = sizeof(LINES_MAGIC);
+
+        // Any index left behind belongs to lost lines
+        std::filesystem::remove(indexPath, ec);
+    }
+
+    if (!linesFile)
+    {
+        Log::warn("Couldn't open chat history: %s", linesPath.c_str());
+        return false;
+    }
+
+    indexFile = fopen(indexPath.c_str(), "ab");
+    if (indexFile && std::filesystem::file_size(indexPath, ec) == 0)
+    {
+        fwrite(INDEX_MAGIC, sizeof(INDEX_MAGIC), 1, indexFile);
+        fflush(indexFile);
+    }
+
+    return true;
+}
+
+void ChatHistory::Channel::append(time_t time, std::string_view line)
+{
+    LineHeader header {};
+    header.time = time;
+    header.length = static_cast<uint32_t>(line.size());
+
+    if (fwrite(&header, sizeof(header), 1, linesFile) != 1 ||
+        fwrite(line.data(), 1, line.size(), linesFile) != line.size() ||
+        fflush(linesFile) != 0)
+    {
+        Log::warn("Couldn't write to chat history: %s", linesPath.c_str());
+        return;
+    }
+
+    offsets.push_back(linesSize);
+    linesSize += sizeof(header) + line.size();
+
+    indexLine(static_cast<uint32_t>(offsets.size() - 1), line);
+}
+
+ChatHistory::Entry ChatHistory::Channel::entry(size_t index)
+{
+    const uint8_t *data = lines.data() + offsets[index];
+
+    LineHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    return {
+        static_cast<time_t>(header.time),
+        std::string(reinterpret_cast<const char *>(data + sizeof(header)),
+                    header.length)
+    };
+}
+
+void ChatHistory::Channel::updateMapping()
+{
+    if (lines.size() < linesSize)
+        lines.map(linesPath);
+}
+
+void ChatHistory::Channel::loadIndex()
+{
+    if (indexLoaded)
+        return;
+
+    indexLoaded = true;
+    updateMapping();
+
+    // The line from which the index needs to be caught up with
+    uint32_t nextLine = 0;
+    bool valid = false;
+
+    MappedFile index;
+    if (index.map(indexPath) && index.size() >= sizeof(INDEX_MAGIC) &&
+        memcmp(index.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0)
+    {
+        valid = true;
+
+        const uint64_t count =
+                (index.size() - sizeof(INDEX_MAGIC)) / sizeof(Posting);
+        const uint8_t *data = index.data() + sizeof(INDEX_MAGIC);
+
+        for (uint64_t i = 0; i < count && valid; ++i)
+        {
+            Posting posting;
+            memcpy(&posting, data + i * sizeof(Posting), sizeof(Posting));
+
+            auto &lineList = postings[posting.word];
+            if (posting.line >= offsets.size() ||
+                (!lineList.empty() && lineList.back() > posting.line))
+            {
+                valid = false;
+            }
+            else if (lineList.empty() || lineList.back() != posting.line)
+            {
+                lineList.push_back(posting.line);
+            }
+
+            // The postings of the last line may be incomplete
+            nextLine = posting.line;
+        }
+    }
+
+    if (!valid)
+    {
+        Log::info("Rebuilding chat history index: %s", indexPath.c_str());
+
+        postings.clear();
+        nextLine = 0;
+
+        // The index is rewritten, so it must not be mapped anymore
+        index.unmap();
+
+        if (indexFile)
+            fclose(indexFile);
+
+        indexFile = fopen(indexPath.c_str(), "wb");
+        if (indexFile)
+            fwrite(INDEX_MAGIC, sizeof(INDEX_MAGIC), 1, indexFile);
+    }
+
+    for (size_t line = nextLine; line < offsets.size(); ++line)
+        indexLine(static_cast<uint32_t>(line), entry(line).line);
+
+    if (indexFile)
+        fflush(indexFile);
+}
+
+void ChatHistory::Channel::indexLine(uint32_t line, std::string_view text)
+{
+    std::vector<Posting> newPostings;
+
+    for (const auto &word : uniqueWords(text))
+    {
+        const uint32_t hash = hashWord(word);
+
+        if (indexLoaded)
+        {
+            auto &lineList = postings[hash];
+            if (!lineList.empty() && lineList.back() == line)
+                continue;
+            lineList.push_back(line);
+        }
+
+        newPostings.push_back({ hash, line });
+    }
+
+    if (indexFile && !newPostings.empty())
+    {
+        fwrite(newPostings.data(), sizeof(Posting), newPostings.size(),
+               indexFile);
+        fflush(indexFile);
+    }
+}
+
+ChatHistory::ChatHistory() = default;
+ChatHistory::~ChatHistory() = default;
+
+void ChatHistory::setHistoryDir(const std::string &historyDir)
+{
+    mHistoryDir = historyDir;
+    mChannels.clear();
+}
+
+void ChatHistory::setServerName(const std::string &serverName)
+{
+    mServerName = serverName;
+    if (mServerName.empty() && !config.servers.empty())
+        mServerName = config.servers.front().hostname;
+
+    mServerName = secureName(mServerName);
+    mChannels.clear();
+}
+
+ChatHistory::Channel *ChatHistory::getChannel(const std::string &channel)
+{
+    if (mHistoryDir.empty() || mServerName.empty())
+        return nullptr;
+
+    auto it = mChannels.find(channel);
+    if (it != mChannels.end())
+        return it->second.get();
+
+    const std::string dir = mHistoryDir + "/" + mServerName;
+    mkdir_r(dir.c_str());
+
+    auto newChannel = std::make_unique<Channel>();
+    if (!newChannel->open(dir + "/" + secureName(channel)))
+        newChannel.reset();
+
+    // Also remember failures, to avoid retrying for each line
+    return (mChannels[channel] = std::move(newChannel)).get();
+}
+
+void ChatHistory::append(const std::string &channel, time_t time,
+                         std::string_view line)
+{
+    if (Channel *c = getChannel(channel))
+        c->append(time, line);
+}
+
+size_t ChatHistory::size(const std::string &channel)
+{
+    Channel *c = getChannel(channel);
+    return c ? c->offsets.size() : 0;
+}
+
+std::vector<ChatHistory::Entry> ChatHistory::read(const std::string &channel,
+                                                  size_t first, size_t count)
+{
+    std::vector<Entry> entries;
+
+    Channel *c = getChannel(channel);
+    if (!c || first >= c->offsets.size())
+        return entries;
+
+    c->updateMapping();
+
+    const size_t end = std::min(first + count, c->offsets.size());
+    entries.reserve(end - first);
+    for (size_t line = first; line < end; ++line)
+        entries.push_back(c->entry(line));
+
+    return entries;
+}
+
+std::vector<ChatHistory::Entry> ChatHistory::search(const std::string &channel,
+                                                    const std::string &query,
+                                                    size_t maxResults)
+{
+    std::vector<Entry> results;
+
+    const auto words = uniqueWords(query);
+    Channel *c = getChannel(channel);
+    if (!c || words.empty())
+        return results;
+
+    c->loadIndex();
+    c->updateMapping();
+
+    // Look up the lines containing each word, rarest word first
+    std::vector<const std::vector<uint32_t> *> lineLists;
+    for (const auto &word : words)
+    {
+        auto it = c->postings.find(hashWord(word));
+        if (it == c->postings.end())
+            return results;
+        lineLists.push_back(&it->second);
+    }
+
+    std::sort(lineLists.begin(), lineLists.end(), [] (auto a, auto b) {
+        return a->size() < b->size();
+    });
+
+    const auto &candidates = *lineLists.front();
+    for (auto it = candidates.rbegin();
+         it != candidates.rend() && results.size() < maxResults; ++it)
+    {
+        const uint32_t line = *it;
+
+        bool inAll = std::all_of(lineLists.begin() + 1, lineLists.end(),
+                                 [line] (auto lineList) {
+            return std::binary_search(lineList->begin(), lineList->end(), line);
+        });
+        if (!inAll)
+            continue;
+
+        // Rule out hash collisions
+        Entry entry = c->entry(line);
+        const auto lineWords = uniqueWords(entry.line);
+        inAll = std::all_of(words.begin(), words.end(), [&] (auto &word) {
+            return std::find(lineWords.begin(), lineWords.end(), word) !=
+                    lineWords.end();
+        });
+
+        if (inAll)
+            results.push_back(std::move(entry));
+    }
+
+    std::reverse(results.begin(), results.end());
+    return results;
+}
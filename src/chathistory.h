@@ -0,0 +1,92 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Keeps the chat history of each channel in an append-only file per server,
+ * which is memory-mapped for reading. Next to it an inverted word index is
+ * kept, so that the history can be searched without reading all of it.
+ */
+class ChatHistory
+{
+    public:
+        struct Entry
+        {
+            time_t time;
+            std::string line;   /**< Colored line, without timestamp */
+        };
+
+        ChatHistory();
+        ~ChatHistory();
+
+        void setHistoryDir(const std::string &historyDir);
+
+        void setServerName(const std::string &serverName);
+
+        /**
+         * Appends a line to the history of the given channel.
+         */
+        void append(const std::string &channel, time_t time,
+                    std::string_view line);
+
+        /**
+         * Returns the number of lines in the history of the given channel.
+         */
+        size_t size(const std::string &channel);
+
+        /**
+         * Returns up to \a count lines from the history of the given channel,
+         * starting at line \a first.
+         */
+        std::vector<Entry> read(const std::string &channel,
+                                size_t first, size_t count);
+
+        /**
+         * Returns up to \a maxResults of the most recent lines from the
+         * history of the given channel that contain all words of the query,
+         * in chronological order. Words are matched case-insensitively.
+         */
+        std::vector<Entry> search(const std::string &channel,
+                                  const std::string &query,
+                                  size_t maxResults);
+
+    private:
+        struct Channel;
+
+        /**
+         * Returns the opened history of the given channel, or nullptr when
+         * it is not available.
+         */
+        Channel *getChannel(const std::string &channel);
+
+        std::string mHistoryDir;
+        std::string mServerName;
+        std::map<std::string, std::unique_ptr<Channel>> mChannels;
+};
+
+extern ChatHistory *chatHistory;
@@ -21,7 +21,6 @@
 
 #include "chatlogger.h"
 
-#include <iostream>
 #include <dirent.h>
 
 #include <sys/stat.h>
@@ -35,6 +34,7 @@
 #endif
 
 #include "configuration.h"
+#include "log.h"
 
 #include "utils/stringutils.h"
 
@@ -83,28 +83,33 @@ static void makeDir(const std::string &dir)
 }
 
 
-ChatLogger::~ChatLogger() = default;
+ChatLogger::~ChatLogger()
+{
+    closeLogFiles();
+}
 
 void ChatLogger::setLogFile(const std::string &logFilename)
 {
-    if (mLogFile.is_open())
-        mLogFile.close();
+    if (!mLogFile.empty())
+        Log::closeFile(mLogFile);
 
-    mLogFile.open(logFilename, std::ios_base::app);
+    mLogFile = logFilename;
+}
 
-    if (!mLogFile.is_open())
-    {
-        std::cout << "Warning: error while opening " << logFilename <<
-            " for writing.\n";
-    }
+void ChatLogger::closeLogFiles()
+{
+    setLogFile(std::string());
+
+    for (auto &[_, logFile] : mChannelLogFiles)
+        Log::closeFile(logFile);
+    mChannelLogFiles.clear();
 }
 
 void ChatLogger::setLogDir(const std::string &logDir)
 {
     mLogDir = logDir;
 
-    if (mLogFile.is_open())
-        mLogFile.close();
+    closeLogFiles();
 
     DIR *dir = opendir(mLogDir.c_str());
     if (!dir)
@@ -116,7 +121,7 @@ void ChatLogger::setLogDir(const std::string &logDir)
 void ChatLogger::log(std::string str)
 {
     std::string dateStr = getDateString();
-    if (!mLogFile.is_open() || dateStr != mLogDate)
+    if (mLogFile.empty() || dateStr != mLogDate)
     {
         mLogDate = dateStr;
         setLogFile(strprintf("%s/%s/#General_%s.log",
@@ -126,25 +131,30 @@ void ChatLogger::log(std::string str)
     }
 
     removeColors(str);
-    mLogFile << str << std::endl;
+    str += '\n';
+    Log::writeToFile(mLogFile, std::move(str));
 }
 
 void ChatLogger::log(std::string name, std::string str)
 {
-    std::ofstream logFile;
-    logFile.open(strprintf("%s/%s/%s_%s.log",
-                           mLogDir.c_str(),
-                           mServerName.c_str(),
-                           secureName(name).c_str(),
-                           getDateString().c_str())
-                     .c_str(),
-                 std::ios_base::app);
-
-    if (!logFile.is_open())
-        return;
+    const std::string logFile = strprintf("%s/%s/%s_%s.log",
+                                          mLogDir.c_str(),
+                                          mServerName.c_str(),
+                                          secureName(name).c_str(),
+                                          getDateString().c_str());
+
+    // Close the file of the previous day
+    std::string &channelLogFile = mChannelLogFiles[name];
+    if (channelLogFile != logFile)
+    {
+        if (!channelLogFile.empty())
+            Log::closeFile(channelLogFile);
+        channelLogFile = logFile;
+    }
 
     removeColors(str);
-    logFile << str << std::endl;
+    str += '\n';
+    Log::writeToFile(logFile, std::move(str));
 }
 
 void ChatLogger::setServerName(const std::string &serverName)
@@ -153,8 +163,7 @@ void ChatLogger::setServerName(const std::string &serverName)
     if (mServerName.empty() && !config.servers.empty())
         mServerName = config.servers.front().hostname;
 
-    if (mLogFile.is_open())
-        mLogFile.close();
+    closeLogFiles();
 
     secureName(mServerName);
     if (!mLogDir.empty())
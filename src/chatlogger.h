@@ -21,8 +21,13 @@
 
 #pragma once
 
-#include <fstream>
+#include <map>
+#include <string>
 
+/**
+ * Writes chat messages to log files per channel and per day. The files are
+ * written by the log writer thread, which keeps them open while in use.
+ */
 class ChatLogger
 {
     public:
@@ -41,11 +46,17 @@ class ChatLogger
 
     private:
         /**
-         * Sets the file to log to and opens it
+         * Sets the file to log general chat to.
          */
         void setLogFile(const std::string &logFilename);
 
-        std::ofstream mLogFile;
+        /**
+         * Closes all log files.
+         */
+        void closeLogFiles();
+
+        std::string mLogFile;
+        std::map<std::string, std::string> mChannelLogFiles;
         std::string mLogDir;
         std::string mServerName;
         std::string mLogDate;
@@ -22,7 +22,9 @@
 #include "client.h"
 #include "main.h"
 
+#include "chathistory.h"
 #include "chatlogger.h"
+#include "compoundsprite.h"
 #include "configuration.h"
 #include "emoteshortcut.h"
 #include "event.h"
@@ -58,6 +60,7 @@
 #include "net/logindata.h"
 #include "net/loginhandler.h"
 #include "net/net.h"
+#include "net/packetcapture.h"
 #include "net/worldinfo.h"
 
 #include "resources/chardb.h"
@@ -76,6 +79,7 @@
 #include "utils/specialfolder.h"
 #endif
 #include "utils/stringutils.h"
+#include "utils/taskgraph.h"
 #include "utils/time.h"
 
 #include <SDL_image.h>
@@ -88,6 +92,7 @@
 #include <sys/stat.h>
 #include <cassert>
 #include <cstdlib>
+#include <iostream>
 
 #include <guichan/exception.hpp>
 
@@ -99,6 +104,7 @@ Config config;                /**< Global settings (config.xml) */
 Configuration branding;       /**< XML branding information reader */
 Configuration paths;          /**< XML default paths information reader */
 ChatLogger *chatLogger;       /**< Chat log object */
+ChatHistory *chatHistory;     /**< Searchable chat history */
 KeyboardConfig keyboard;
 
 UserPalette *userPalette;
@@ -137,37 +143,6 @@ bool isDoubleClick(int selected)
     return false;
 }
 
-/**
- * A simple but effective frame rate limiter.
- * Based on FPSmanager in SDL2_gfx.
- */
-void FpsManager::limitFps(int fpsLimit)
-{
-    if (fpsLimit <= 0)
-        return;
-
-    const auto ticks = SDL_GetTicks();
-
-    // Need to reset if the FPS limit changes
-    if (mBaseTicks > 0 && mFpsLimit == fpsLimit)
-    {
-        ++mFrameCount;
-        const auto targetTicks = mBaseTicks + mFrameCount * 1000 / mFpsLimit;
-
-        // Make sure ticks hasn't wrapped
-        if (ticks > mBaseTicks && targetTicks > ticks)
-        {
-            SDL_Delay(targetTicks - ticks);
-            return;
-        }
-    }
-
-    mFpsLimit = fpsLimit;
-    mFrameCount = 0;
-    mBaseTicks = ticks;
-}
-
-
 Client *Client::mInstance = nullptr;
 
 Client::Client(const Options &options):
@@ -177,6 +152,8 @@ Client::Client(const Options &options):
     assert(!mInstance);
     mInstance = this;
 
+    mStartTicks = SDL_GetTicks();
+
     // Set default values for configuration files
     branding.setDefaultValues(getBrandingDefaults());
     paths.setDefaultValues(getPathsDefaults());
@@ -194,6 +171,7 @@ Client::Client(const Options &options):
     // Configure logger
     Log::init();
     Log::setLogToStandardOut(config.logToStandardOut);
+    Log::setRateLimit(std::max(config.logRateLimit, 0));
     if (options.logFile == "-")
         Log::setLogToStandardOut(true);
     else if (!options.logFile.empty())
@@ -202,12 +180,18 @@ Client::Client(const Options &options):
         Log::setLogFile(mLocalDataDir + "/mana.log");
     Log::info("%s", FULL_VERSION);
 
+    if (!options.capturePackets.empty())
+        Net::startPacketCapture(options.capturePackets);
+
     chatLogger = new ChatLogger;
     if (options.chatLogDir.empty())
         chatLogger->setLogDir(mLocalDataDir + "/logs/");
     else
         chatLogger->setLogDir(options.chatLogDir);
 
+    chatHistory = new ChatHistory;
+    chatHistory->setHistoryDir(mLocalDataDir + "/history/");
+
     initScreenshotDir();
 
 #if SDL_VERSION_ATLEAST(2, 24, 0)
@@ -223,6 +207,11 @@ Client::Client(const Options &options):
     }
     atexit(SDL_Quit);
 
+    // Initialize the PNG loader up front, since images may be decoded on
+    // several threads at once
+    IMG_Init(IMG_INIT_PNG);
+    atexit(IMG_Quit);
+
     SDL_SetHint(SDL_HINT_MOUSE_FOCUS_CLICKTHROUGH, "1");
 
     if (!FS::setWriteDir(mLocalDataDir))
@@ -243,103 +232,113 @@ Client::Client(const Options &options):
 #else
     mPackageDir = PKG_DATADIR "data";
 #endif
-    ResourceManager::addToSearchPath(mPackageDir, false);
-    ResourceManager::addToSearchPath("data", false);
 
-    // Add branding/data to PhysFS search path
-    if (!options.brandingPath.empty())
-    {
-        std::string path = options.brandingPath;
+    // The independent parts of the startup run in parallel. Anything using
+    // the window or the renderer stays on the main thread.
+    using Thread = TaskGraph::Thread;
+    TaskGraph startup;
+    Gui::Preload guiPreload;
+    std::string soundError;
 
-        // Strip blah.mana from the path
+    const auto searchPaths = startup.add("search paths", Thread::Worker, [&] {
+        ResourceManager::addToSearchPath(mPackageDir, false);
+        ResourceManager::addToSearchPath("data", false);
+
+        // Add branding/data to PhysFS search path
+        if (!options.brandingPath.empty())
+        {
+            std::string path = options.brandingPath;
+
+            // Strip blah.mana from the path
 #ifdef _WIN32
-        int loc1 = path.find_last_of('/');
-        int loc2 = path.find_last_of('\\');
-        int loc = std::max(loc1, loc2);
+            int loc1 = path.find_last_of('/');
+            int loc2 = path.find_last_of('\\');
+            int loc = std::max(loc1, loc2);
 #else
-        int loc = path.find_last_of('/');
+            int loc = path.find_last_of('/');
 #endif
-        if (loc > 0)
-            ResourceManager::addToSearchPath(path.substr(0, loc + 1) + "data", false);
-    }
+            if (loc > 0)
+                ResourceManager::addToSearchPath(path.substr(0, loc + 1) + "data", false);
+        }
 
-    // Add the main data directories to our PhysicsFS search path
-    if (!options.dataPath.empty())
-        ResourceManager::addToSearchPath(options.dataPath, false);
+        // Add the main data directories to our PhysicsFS search path
+        if (!options.dataPath.empty())
+            ResourceManager::addToSearchPath(options.dataPath, false);
 
-    // Add the local data directory to PhysicsFS search path
-    ResourceManager::addToSearchPath(mLocalDataDir, false);
+        // Add the local data directory to PhysicsFS search path
+        ResourceManager::addToSearchPath(mLocalDataDir, false);
+    });
 
-    bool useOpenGL = !mOptions.noOpenGL && config.opengl;
+    const auto video = startup.add("video", Thread::Main, [&] {
+        bool useOpenGL = !mOptions.noOpenGL && config.opengl;
 
-    // Set up the transparency option for low CPU when not using OpenGL.
-    if (!useOpenGL && config.disableTransparency)
-        Image::SDLdisableTransparency();
+        // Set up the transparency option for low CPU when not using OpenGL.
+        if (!useOpenGL && config.disableTransparency)
+            Image::SDLdisableTransparency();
 
-    VideoSettings videoSettings;
-    videoSettings.windowMode = config.windowMode;
-    videoSettings.width = config.screenWidth;
-    videoSettings.height = config.screenHeight;
-    videoSettings.userScale = config.scale;
-    videoSettings.vsync = config.vsync;
-    videoSettings.openGL = useOpenGL;
+        VideoSettings videoSettings;
+        videoSettings.windowMode = config.windowMode;
+        videoSettings.width = config.screenWidth;
+        videoSettings.height = config.screenHeight;
+        videoSettings.userScale = config.scale;
+        videoSettings.vsync = config.vsync;
+        videoSettings.openGL = useOpenGL;
+        videoSettings.modernOpenGL = config.modernOpenGL;
 
-    // Try to set the desired video mode and create the graphics context
-    graphics = mVideo.initialize(videoSettings);
+        // Try to set the desired video mode and create the graphics context
+        graphics = mVideo.initialize(videoSettings);
 
-    SDL_SetWindowTitle(mVideo.window(),
-                       branding.getValue("appName", "Mana").c_str());
+        SDL_SetWindowTitle(mVideo.window(),
+                           branding.getValue("appName", "Mana").c_str());
+    });
 
-    std::string iconFile = branding.getValue("appIcon", "icons/mana");
-#ifdef _WIN32
-    iconFile += ".ico";
-#else
-    iconFile += ".png";
-#endif
-    iconFile = ResourceManager::getPath(iconFile);
-    Log::info("Loading icon from file: %s", iconFile.c_str());
-#ifdef _WIN32
-    static SDL_SysWMinfo pInfo;
-    SDL_GetWindowWMInfo(mVideo.window(), &pInfo);
-    // Attempt to load icon from .ico file
-    HICON icon = (HICON) LoadImage(NULL,
-                                   iconFile.c_str(),
-                                   IMAGE_ICON, 64, 64, LR_LOADFROMFILE);
-    // If it's failing, we load the default resource file.
-    if (!icon)
-        icon = LoadIcon(GetModuleHandle(NULL), "A");
+    startup.add("window icon", Thread::Main, [&] {
+        initWindowIcon();
+    }, { searchPaths, video });
 
-    if (icon)
-        SetClassLongPtr(pInfo.info.win.window, GCLP_HICON, (LONG_PTR) icon);
-#else
-    mIcon = IMG_Load(iconFile.c_str());
-    if (mIcon)
-    {
-        SDL_SetWindowIcon(mVideo.window(), mIcon);
-    }
-#endif
+    startup.add("sound", Thread::Worker, [&] {
+        try
+        {
+            if (config.sound)
+                sound.init();
 
-    // Initialize the item and emote shortcuts.
-    itemShortcut = new ItemShortcut;
-    emoteShortcut = new EmoteShortcut;
+            sound.setSfxVolume(config.sfxVolume);
+            sound.setNotificationsVolume(config.notificationsVolume);
+            sound.setMusicVolume(config.musicVolume);
+        }
+        catch (const char *err)
+        {
+            soundError = err;
+        }
+    });
 
-    gui = new Gui(graphics, Theme::prepareThemePath());
+    const auto themes = startup.add("themes", Thread::Worker, [&] {
+        Gui::loadThemes(guiPreload);
+    }, { searchPaths });
 
-    // Initialize sound engine
-    try
-    {
-        if (config.sound)
-            sound.init();
+    const auto fonts = startup.add("fonts", Thread::Worker, [&] {
+        Gui::loadFonts(guiPreload, graphics->getScale());
+    }, { searchPaths, video });
 
-        sound.setSfxVolume(config.sfxVolume);
-        sound.setNotificationsVolume(config.notificationsVolume);
-        sound.setMusicVolume(config.musicVolume);
-    }
-    catch (const char *err)
+    startup.add("gui", Thread::Main, [&] {
+        // Initialize the item and emote shortcuts.
+        itemShortcut = new ItemShortcut;
+        emoteShortcut = new EmoteShortcut;
+
+        gui = new Gui(graphics, guiPreload);
+
+        // Any images the theme did not use yet don't need to stay decoded
+        ResourceManager::clearPrefetchedImages();
+    }, { themes, fonts });
+
+    startup.run([this] (float progress) { drawStartupProgress(progress); });
+    printStartupTrace(startup);
+
+    if (!soundError.empty())
     {
         mState = State::Error;
-        errorMessage = err;
-        Log::warn("%s", err);
+        errorMessage = soundError;
+        Log::warn("%s", soundError.c_str());
     }
 
     // Initialize keyboard
@@ -360,6 +359,16 @@ Client::Client(const Options &options):
     loginData.username = options.username;
     loginData.password = options.password;
 
+    // When replaying, the server type comes from the capture and the address
+    // only needs to be valid
+    if (!options.replayPackets.empty() &&
+        Net::startPacketReplay(options.replayPackets, options.replayRealTime))
+    {
+        mCurrentServer.type = Net::getPacketReplay()->getServerType();
+        if (mCurrentServer.hostname.empty())
+            mCurrentServer.hostname = "localhost";
+    }
+
     if (mCurrentServer.type == ServerType::Unknown && mCurrentServer.port != 0)
     {
         mCurrentServer.type = ServerInfo::defaultServerTypeForPort(mCurrentServer.port);
@@ -386,6 +395,8 @@ Client::Client(const Options &options):
 
     if (chatLogger)
         chatLogger->setServerName(mCurrentServer.hostname);
+    if (chatHistory)
+        chatHistory->setServerName(mCurrentServer.hostname);
 
     if (loginData.username.empty() && config.remember)
         loginData.username = config.username;
@@ -416,6 +427,7 @@ Client::~Client()
     delete itemDb;
 
     ActorSprite::unload();
+    CompoundSprite::clearCache();
 
     // Before config.write() since it writes the shortcuts to the config
     delete itemShortcut;
@@ -433,6 +445,8 @@ Client::~Client()
 
     SDL_FreeSurface(mIcon);
 
+    Net::stopPacketCapture();
+
     Log::info("Quitting");
     delete userPalette;
 
@@ -542,12 +556,15 @@ void Client::update()
     {
         frame_count++;
         gui->draw();
-        mVideo.present();
-        mFpsManager.limitFps(config.fpsLimit);
+        mFramePacer.present(mVideo);
+        mFramePacer.waitForNextFrame(config.fpsLimit,
+                                     mVideo.settings().vsync,
+                                     mVideo.refreshRate(),
+                                     config.adaptiveFpsLimit);
     }
     else
     {
-        mFpsManager.limitFps(10);
+        mFramePacer.waitForNextFrame(config.inactiveFpsLimit, false, 0, false);
     }
 
     // TODO: Add connect timeouts
@@ -645,6 +662,15 @@ void Client::update()
 
             case State::Login:
                 Log::info("State: LOGIN");
+
+                if (mOptions.startupTrace && !mLoginReached)
+                {
+                    std::cout << "Time to login: "
+                              << SDL_GetTicks() - mStartTicks << " ms"
+                              << std::endl;
+                }
+                mLoginReached = true;
+
                 // Don't allow an alpha opacity
                 // lower than the default value
                 gui->getTheme()->setMinimumOpacity(0.8f);
@@ -724,6 +750,10 @@ void Client::update()
                         "customdata/",
                         "zip",
                         false);
+                    ResourceManager::searchAndAddArchives(
+                        "customdata/",
+                        "manapak",
+                        false);
                 }
 
                 // TODO remove this as soon as inventoryhandler stops using this event
@@ -1017,6 +1047,81 @@ void Client::widgetShown(const gcn::Event &event)
         mSetupButton->setSelected(true);
 }
 
+void Client::initWindowIcon()
+{
+    std::string iconFile = branding.getValue("appIcon", "icons/mana");
+#ifdef _WIN32
+    iconFile += ".ico";
+#else
+    iconFile += ".png";
+#endif
+    iconFile = ResourceManager::getPath(iconFile);
+    Log::info("Loading icon from file: %s", iconFile.c_str());
+#ifdef _WIN32
+    static SDL_SysWMinfo pInfo;
+    SDL_GetWindowWMInfo(mVideo.window(), &pInfo);
+    // Attempt to load icon from .ico file
+    HICON icon = (HICON) LoadImage(NULL,
+                                   iconFile.c_str(),
+                                   IMAGE_ICON, 64, 64, LR_LOADFROMFILE);
+    // If it's failing, we load the default resource file.
+    if (!icon)
+        icon = LoadIcon(GetModuleHandle(NULL), "A");
+
+    if (icon)
+        SetClassLongPtr(pInfo.info.win.window, GCLP_HICON, (LONG_PTR) icon);
+#else
+    mIcon = IMG_Load(iconFile.c_str());
+    if (mIcon)
+    {
+        SDL_SetWindowIcon(mVideo.window(), mIcon);
+    }
+#endif
+}
+
+void Client::drawStartupProgress(float progress)
+{
+    // Keep the window responsive while waiting
+    SDL_PumpEvents();
+
+    if (!graphics)
+        return;
+
+    const int width = graphics->getWidth();
+    const int height = graphics->getHeight();
+    const gcn::Rectangle bar(width / 4, height * 2 / 3, width / 2, 4);
+
+    graphics->_beginDraw();
+    graphics->setColor(gcn::Color(0, 0, 0));
+    graphics->fillRectangle(gcn::Rectangle(0, 0, width, height));
+    graphics->setColor(gcn::Color(64, 64, 64));
+    graphics->fillRectangle(bar);
+    graphics->setColor(gcn::Color(255, 255, 255));
+    graphics->fillRectangle(gcn::Rectangle(bar.x, bar.y,
+                                           static_cast<int>(bar.width * progress),
+                                           bar.height));
+    graphics->_endDraw();
+    graphics->updateScreen();
+}
+
+void Client::printStartupTrace(const TaskGraph &startup)
+{
+    std::string trace = strprintf("Startup took %.1f ms:", startup.getTotalMs());
+    for (const auto &timing : startup.getTimings())
+    {
+        trace += strprintf("\n  %-14s %-6s started at %7.1f ms, took %7.1f ms",
+                           timing.name.c_str(),
+                           timing.thread == TaskGraph::Thread::Main ? "main" : "worker",
+                           timing.startMs,
+                           timing.durationMs);
+    }
+
+    Log::info("%s", trace.c_str());
+
+    if (mOptions.startupTrace)
+        std::cout << trace << std::endl;
+}
+
 void Client::initRootDir()
 {
     mRootDir = FS::getBaseDir();
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "framepacer.h"
 #include "video.h"
 
 #include "net/serverinfo.h"
@@ -38,6 +39,7 @@ class Desktop;
 class LoginData;
 class Window;
 class QuitDialog;
+class TaskGraph;
 
 //manaserv uses 9601
 //static const short DEFAULT_PORT = 9601;
@@ -94,16 +96,6 @@ enum class State : int8_t {
     Exit
 };
 
-class FpsManager
-{
-    int mFpsLimit = 0;
-    uint32_t mFrameCount = 0;
-    uint32_t mBaseTicks = 0;
-
-public:
-    void limitFps(int fpsLimit);
-};
-
 /**
  * The core part of the client. This class initializes all subsystems, runs
  * the event loop, and shuts everything down again.
@@ -135,6 +127,10 @@ public:
         std::string localDataDir;
         std::string screenshotDir;
         std::string logFile;
+        std::string capturePackets;
+        std::string replayPackets;
+        bool replayRealTime = false;
+        bool startupTrace = false;
         ServerType serverType = ServerType::Unknown;
 
         std::string serverName;
@@ -188,6 +184,9 @@ public:
     static Video &getVideo()
     { return instance()->mVideo; }
 
+    static const FramePacer &getFramePacer()
+    { return instance()->mFramePacer; }
+
     void action(const gcn::ActionEvent &event) override;
 
     void widgetHidden(const gcn::Event &event) override;
@@ -210,6 +209,18 @@ private:
     void initConfiguration();
     bool initUpdatesDir();
     void initScreenshotDir();
+    void initWindowIcon();
+
+    /**
+     * Draws a progress bar while the startup tasks are running.
+     */
+    void drawStartupProgress(float progress);
+
+    /**
+     * Logs how long each startup task took, and prints it with
+     * --startup-trace.
+     */
+    void printStartupTrace(const TaskGraph &startup);
 
     void accountLogin(LoginData *loginData);
 
@@ -240,8 +251,11 @@ private:
 
     SDL_Surface *mIcon = nullptr;
 
+    uint32_t mStartTicks = 0;
+    bool mLoginReached = false;
+
     SDL_TimerID mSecondsCounterId = 0;
-    FpsManager mFpsManager;
+    FramePacer mFramePacer;
 
 #if defined(_WIN32) || defined(__APPLE__)
     /**
@@ -23,6 +23,7 @@
 
 #include "actorspritemanager.h"
 #include "channelmanager.h"
+#include "chathistory.h"
 #include "configuration.h"
 #include "game.h"
 #include "localplayer.h"
@@ -37,6 +38,11 @@
 #include "utils/gettext.h"
 #include "utils/stringutils.h"
 
+/**
+ * The maximum number of messages shown by the search command.
+ */
+static constexpr size_t MAX_SEARCH_RESULTS = 20;
+
 std::string booleanOptionInstructions(const char *command)
 {
     return strprintf(_("Options to /%s are \"yes\", \"no\", \"true\", \"false\", \"1\", \"0\"."),
@@ -95,6 +101,10 @@ void CommandHandler::handleCommand(const std::string &command, ChatTab *tab)
     {
         handleClear(args, tab);
     }
+    else if (type == "search")
+    {
+        handleSearch(args, tab);
+    }
     else if (type == "createparty")
     {
         handleCreateParty(args, tab);
@@ -166,6 +176,7 @@ void CommandHandler::handleHelp(const std::string &args, ChatTab *tab)
         tab->chatLog(_("/me > Tell something about yourself"));
 
         tab->chatLog(_("/clear > Clears this window"));
+        tab->chatLog(_("/search > Search the chat history of this window"));
 
         tab->chatLog(_("/msg > Send a private message to a user"));
         tab->chatLog(_("/whisper > Alias of msg"));
@@ -287,6 +298,12 @@ void CommandHandler::handleHelp(const std::string &args, ChatTab *tab)
         tab->chatLog(_("Command: /record"));
         tab->chatLog(_("This command finishes a recording session."));
     }
+    else if (args == "search")
+    {
+        tab->chatLog(_("Command: /search <words>"));
+        tab->chatLog(_("This command shows the most recent messages in the "
+                       "history of this window that contain all <words>."));
+    }
     else if (args == "toggle")
     {
         tab->chatLog(_("Command: /toggle <state>"));
@@ -414,6 +431,38 @@ void CommandHandler::handleClear(const std::string &args, ChatTab *tab)
     chatWindow->clearTab();
 }
 
+void CommandHandler::handleSearch(const std::string &args, ChatTab *tab)
+{
+    // The results are not recorded, so they won't turn up in later searches
+    if (args.empty())
+    {
+        tab->chatLog(_("Please specify the words to search for."),
+                     BY_SERVER, true);
+        return;
+    }
+
+    if (!config.enableChatHistory || !chatHistory)
+    {
+        tab->chatLog(_("The chat history is disabled."), BY_SERVER, true);
+        return;
+    }
+
+    const auto results = chatHistory->search(tab->getHistoryName(), args,
+                                             MAX_SEARCH_RESULTS);
+    if (results.empty())
+    {
+        tab->chatLog(strprintf(_("No messages found containing \"%s\"."),
+                               args.c_str()), BY_SERVER, true);
+        return;
+    }
+
+    tab->chatLog(strprintf(_("Messages containing \"%s\":"), args.c_str()),
+                 BY_SERVER, true);
+
+    for (const auto &entry : results)
+        tab->addHistoryEntry(entry);
+}
+
 void CommandHandler::handleJoin(const std::string &args, ChatTab *tab)
 {
     std::string::size_type pos = args.find(' ');
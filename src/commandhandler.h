@@ -89,6 +89,11 @@ class CommandHandler
          */
         static void handleClear(const std::string &args, ChatTab *tab);
 
+        /**
+         * Handle a search command.
+         */
+        static void handleSearch(const std::string &args, ChatTab *tab);
+
         /**
          * Handle a createparty command.
          */
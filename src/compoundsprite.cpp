@@ -21,22 +21,157 @@
 #include "compoundsprite.h"
 
 #include "graphics.h"
+#include "log.h"
 #include "map.h"
 #include "sprite.h"
 
+#include "resources/animation.h"
 #include "resources/image.h"
 
 #include "utils/dtor.h"
 
-#include <SDL.h>
+#include <climits>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+/**
+ * The current frames of all layers rendered into a single image, so that a
+ * compound sprite can be drawn as one quad.
+ */
+struct LayerComposite
+{
+    std::unique_ptr<Image> image;
+    int x = 0;          /**< Position relative to the sprite origin. */
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    float scale = 1.0f; /**< Graphics scale the image was rendered at. */
+
+    /** Keeps the frames used as cache key alive. */
+    std::vector<ResourceRef<SpriteDef>> spriteDefs;
+};
+
+namespace {
+
+using CompositeKey = std::vector<const Frame *>;
+
+struct CompositeKeyHash
+{
+    size_t operator()(const CompositeKey &key) const
+    {
+        size_t hash = key.size();
+        for (auto frame : key)
+            hash = hash * 31 + std::hash<const Frame *>()(frame);
+        return hash;
+    }
+};
+
+/**
+ * Composites are shared between compound sprites showing the same frames,
+ * like players wearing the same outfit. The least recently used ones are
+ * dropped when the cache is full, and their images are kept for reuse by
+ * composites of the same size.
+ */
+class CompositeCache
+{
+public:
+    using CompositePtr = std::shared_ptr<LayerComposite>;
+
+    CompositePtr find(const CompositeKey &key)
+    {
+        auto it = mIndex.find(key);
+        if (it == mIndex.end())
+            return {};
+
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return it->second->second;
+    }
+
+    void insert(CompositeKey key, CompositePtr composite)
+    {
+        mEntries.emplace_front(key, std::move(composite));
+        mIndex[std::move(key)] = mEntries.begin();
+
+        if (mEntries.size() > MAX_COMPOSITES)
+        {
+            // The image can only be reused when no sprite still shows it
+            CompositePtr &evicted = mEntries.back().second;
+            if (evicted.use_count() == 1 && evicted->image)
+                recycleImage(evicted->width, evicted->height,
+                             std::move(evicted->image));
+
+            mIndex.erase(mEntries.back().first);
+            mEntries.pop_back();
+        }
+    }
+
+    /**
+     * Returns a previously used image of the given size, or nullptr when
+     * there is none.
+     */
+    std::unique_ptr<Image> takeImage(int width, int height)
+    {
+        auto it = mImagePool.find(imageSize(width, height));
+        if (it == mImagePool.end())
+            return {};
+
+        auto image = std::move(it->second.back());
+        it->second.pop_back();
+        if (it->second.empty())
+            mImagePool.erase(it);
+
+        --mPooledImages;
+        return image;
+    }
+
+    void clear()
+    {
+        mIndex.clear();
+        mEntries.clear();
+        mImagePool.clear();
+        mPooledImages = 0;
+    }
+
+private:
+    static constexpr size_t MAX_COMPOSITES = 256;
+    static constexpr size_t MAX_POOLED_IMAGES = 64;
+
+    static uint64_t imageSize(int width, int height)
+    {
+        return (static_cast<uint64_t>(width) << 32) |
+                static_cast<uint32_t>(height);
+    }
+
+    void recycleImage(int width, int height, std::unique_ptr<Image> image)
+    {
+        if (mPooledImages >= MAX_POOLED_IMAGES)
+            return;
+
+        mImagePool[imageSize(width, height)].push_back(std::move(image));
+        ++mPooledImages;
+    }
+
+    using Entry = std::pair<CompositeKey, CompositePtr>;
+
+    std::list<Entry> mEntries;   // Most recently used first
+    std::unordered_map<CompositeKey, std::list<Entry>::iterator,
+                       CompositeKeyHash> mIndex;
+
+    std::unordered_map<uint64_t, std::vector<std::unique_ptr<Image>>> mImagePool;
+    size_t mPooledImages = 0;
+};
+
+} // anonymous namespace
+
+static CompositeCache compositeCache;
+static float compositeCacheScale = 1.0f;
+static bool renderTargetFailureLogged = false;
 
 CompoundSprite::~CompoundSprite()
 {
     delete_all(mSprites);
-    delete mImage;
-    delete mAlphaImage;
 }
-
 bool CompoundSprite::reset()
 {
     bool ret = false;
@@ -50,6 +185,11 @@ bool CompoundSprite::reset()
 }
 
 bool CompoundSprite::play(const std::string &action)
+{
+    return play(SpriteAction::getId(action));
+}
+
+bool CompoundSprite::play(ActionId action)
 {
     bool ret = false;
 
@@ -83,27 +223,47 @@ bool CompoundSprite::draw(Graphics *graphics, int posX, int posY) const
     posX += mOffsetX;
     posY += mOffsetY;
 
-    if (mAlpha == 1.0f && mImage)
+    // Render targets can't be nested, so the layers are drawn separately
+    // while for example a cached window is being rendered.
+    if (!graphics->isRenderingToTarget())
     {
-        return graphics->drawImage(mImage, posX, posY);
-    }
+        if (mComposite && mComposite->scale != graphics->getScale())
+            mCompositeDirty = true;
 
-    if (mAlpha && mAlphaImage)
-    {
-        mAlphaImage->setAlpha(mAlpha);
-        return graphics->drawImage(mAlphaImage, posX, posY);
+        if (mCompositeDirty)
+        {
+            mComposite = getComposite(graphics);
+            mCompositeDirty = false;
+        }
+
+        if (mComposite)
+        {
+            if (!mAlpha)
+                return false;
+
+            mComposite->image->setAlpha(mAlpha);
+            graphics->drawRenderTarget(mComposite->image.get(),
+                                       posX + mComposite->x,
+                                       posY + mComposite->y,
+                                       mComposite->width,
+                                       mComposite->height);
+            return true;
+        }
     }
 
+    bool drawn = false;
     for (auto sprite : mSprites)
     {
         if (sprite)
         {
             sprite->setAlpha(mAlpha);
-            sprite->draw(graphics, posX - sprite->getWidth() / 2, posY - sprite->getHeight());
+            drawn |= sprite->draw(graphics,
+                                  posX - sprite->getWidth() / 2,
+                                  posY - sprite->getHeight());
         }
     }
 
-    return false;
+    return drawn;
 }
 
 int CompoundSprite::getMinOffsetY() const
@@ -127,7 +287,8 @@ bool CompoundSprite::setDirection(SpriteDirection direction)
 
 int CompoundSprite::getNumberOfLayers() const
 {
-    if (mImage || mAlphaImage)
+    // The composite is only up to date once it has been drawn again
+    if (mComposite && !mNeedsRedraw && !mCompositeDirty)
         return 1;
 
     return size();
@@ -180,134 +341,118 @@ int CompoundSprite::getMaxDuration() const
     return duration;
 }
 
-#if 0
-static void updateValues(int &dimension, int &pos, int imgDimUL, int imgDimRD, int imgOffset)
+void CompoundSprite::clearCache()
 {
-    // Handle going beyond the left/up
-    int temp = -(pos + imgOffset - imgDimUL); // Negated for easier use
-    if (temp > 0)
-    {
-        pos += temp;
-        dimension += temp;
-    }
-
-    // Handle going beyond the right/down
-    temp = pos + imgOffset + imgDimRD;
-    if (temp > dimension)
-        dimension = temp;
+    compositeCache.clear();
 }
-#endif
 
 void CompoundSprite::redraw() const
 {
-#if 1   // TODO_SDL2: Does it make sense to implement CompoundSprite?
     auto baseSprite = mSprites.empty() ? nullptr : mSprites.at(0);
     mWidth = baseSprite ? baseSprite->getWidth() : 0;
     mHeight = baseSprite ? baseSprite->getHeight() : 0;
     mOffsetX = 0;
     mOffsetY = 0;
     mNeedsRedraw = false;
-#else
+    mCompositeDirty = true;
+    ++mChangeCount;
+}
 
-#ifdef USE_OPENGL
-    // TODO OpenGL support
-    if (Image::getLoadAsOpenGL())
+std::shared_ptr<LayerComposite>
+CompoundSprite::getComposite(Graphics *graphics) const
+{
+    CompositeKey key;
+    key.reserve(mSprites.size());
+
+    for (auto sprite : mSprites)
     {
-        mWidth = mSprites.at(0)->getWidth();
-        mHeight = mSprites.at(0)->getHeight();
-        mOffsetX = 0;
-        mOffsetY = 0;
-        mNeedsRedraw = false;
-        return;
+        const Frame *frame = sprite ? sprite->getFrame() : nullptr;
+        if (frame && frame->image)
+            key.push_back(frame);
+    }
+
+    // Compositing a single layer would not save anything
+    if (key.size() < 2)
+        return {};
+
+    const float scale = graphics->getScale();
+    if (scale != compositeCacheScale)
+    {
+        compositeCache.clear();
+        compositeCacheScale = scale;
     }
-#endif
 
-    mWidth = mHeight = mOffsetX = mOffsetY = 0;
+    // Composites without image remember the frames that failed to render
+    if (auto composite = compositeCache.find(key))
+        return composite->image ? composite : nullptr;
 
-    int posX = 0;
-    int posY = 0;
+    auto composite = std::make_shared<LayerComposite>();
+
+    // Determine the area covered by all layers, relative to the origin
+    int left = INT_MAX;
+    int top = INT_MAX;
+    int right = INT_MIN;
+    int bottom = INT_MIN;
 
     for (auto sprite : mSprites)
     {
-        if (!sprite)
+        if (!sprite || !sprite->getImage())
             continue;
 
-        updateValues(mWidth, posX,
-                     sprite->getWidth() / 2,
-                     sprite->getWidth() / 2,
-                     sprite->getOffsetX());
+        const int x = sprite->getOffsetX() - sprite->getWidth() / 2;
+        const int y = sprite->getOffsetY() - sprite->getHeight();
+
+        left = std::min(left, x);
+        top = std::min(top, y);
+        right = std::max(right, x + sprite->getWidth());
+        bottom = std::max(bottom, y + sprite->getHeight());
 
-        updateValues(mHeight, posY,
-                     sprite->getHeight(),
-                     0,
-                     sprite->getOffsetY());
+        composite->spriteDefs.emplace_back(sprite->getSpriteDef());
     }
 
-    if (mWidth == 0 && mHeight == 0)
+    composite->x = left;
+    composite->y = top;
+    composite->width = right - left;
+    composite->height = bottom - top;
+    composite->scale = scale;
+    composite->image = compositeCache.takeImage(composite->width,
+                                                composite->height);
+    if (!composite->image)
+        composite->image = graphics->createRenderTarget(composite->width,
+                                                        composite->height);
+
+    if (!composite->image)
     {
-        mNeedsRedraw = false;
-        return;
-    }
+        if (!renderTargetFailureLogged)
+        {
+            Log::info("Failed to create a render target, compound sprites "
+                      "will be drawn layer by layer where needed.");
+            renderTargetFailureLogged = true;
+        }
 
-    mOffsetX -= posX;
-    mOffsetY -= posY;
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-    int rmask = 0xff000000;
-    int gmask = 0x00ff0000;
-    int bmask = 0x0000ff00;
-    int amask = 0x000000ff;
-#else
-    int rmask = 0x000000ff;
-    int gmask = 0x0000ff00;
-    int bmask = 0x00ff0000;
-    int amask = 0xff000000;
-#endif
-
-    SDL_Surface *surface = SDL_CreateRGBSurface(0, mWidth, mHeight,
-                                            32, rmask, gmask, bmask, amask);
-
-    if (!surface)
-        return;
+        compositeCache.insert(std::move(key), composite);
+        return {};
+    }
 
-    Graphics *graphics = new Graphics();
-    graphics->setBlitMode(Graphics::BLIT_GFX);
-    graphics->setTarget(surface);
-    graphics->_beginDraw();
+    graphics->beginRenderToTarget(composite->image.get(),
+                                  composite->width, composite->height);
 
     for (auto sprite : mSprites)
     {
-        if (!sprite)
+        if (!sprite || !sprite->getImage())
             continue;
 
+        // The alpha is applied when drawing the composite
+        const float alpha = sprite->getAlpha();
+        sprite->setAlpha(1.0f);
         sprite->draw(graphics,
-                     posX - sprite->getWidth() / 2,
-                     posY - sprite->getHeight());
+                     -left - sprite->getWidth() / 2,
+                     -top - sprite->getHeight());
+        sprite->setAlpha(alpha);
     }
 
-    // Uncomment to see buffer sizes
-    /*graphics->fillRectangle(gcn::Rectangle(0, 0, 3, 3));
-    graphics->fillRectangle(gcn::Rectangle(mWidth - 3, 0, 3, 3));
-    graphics->fillRectangle(gcn::Rectangle(mWidth - 3, mHeight - 3, 3, 3));
-    graphics->fillRectangle(gcn::Rectangle(0, mHeight - 3, 3, 3));*/
-
-    delete graphics;
-
-    SDL_Surface *surfaceA = SDL_CreateRGBSurface(0, mWidth, mHeight,
-                                            32, rmask, gmask, bmask, amask);
+    graphics->endRenderToTarget();
 
-    SDL_SetAlpha(surface, 0, SDL_ALPHA_OPAQUE);
-    SDL_BlitSurface(surface, nullptr, surfaceA, nullptr);
-
-    delete mImage;
-    delete mAlphaImage;
-
-    mImage = Image::load(surface);
-    SDL_FreeSurface(surface);
-
-    mAlphaImage = Image::load(surfaceA);
-    SDL_FreeSurface(surfaceA);
-
-    mNeedsRedraw = false;
-#endif
+    compositeCache.insert(std::move(key), composite);
+    return composite;
 }
@@ -22,10 +22,12 @@
 
 #include "resources/spritedef.h"
 
+#include <memory>
 #include <vector>
 
 class Graphics;
 class Sprite;
+struct LayerComposite;
 
 class CompoundSprite
 {
@@ -34,6 +36,7 @@ public:
     ~CompoundSprite();
 
     bool reset();
+    bool play(ActionId action);
     bool play(const std::string &action);
     bool update(int time);
     bool draw(Graphics *graphics, int posX, int posY) const;
@@ -63,6 +66,12 @@ public:
 
     int getMaxDuration() const;
 
+    /**
+     * Returns a number that changes whenever the sprites look different,
+     * for detecting changes since they were last drawn.
+     */
+    unsigned getChangeCount() const { doRedraw(); return mChangeCount; }
+
     size_t size() const { return mSprites.size(); }
 
     void add(Sprite *sprite);
@@ -72,16 +81,29 @@ public:
 
     void doRedraw() const;
 
+    /**
+     * Releases all cached layer composites. Needs to be called before the
+     * graphics backend and resource manager are destroyed.
+     */
+    static void clearCache();
+
 private:
     void redraw() const;
 
-    mutable Image *mImage = nullptr;
-    mutable Image *mAlphaImage = nullptr;
+    /**
+     * Looks up or renders the composite of the current frames of all
+     * layers. Returns nullptr when the layers can't be composited.
+     */
+    std::shared_ptr<LayerComposite> getComposite(Graphics *graphics) const;
+
+    mutable std::shared_ptr<LayerComposite> mComposite;
+    mutable bool mCompositeDirty = true;
 
     mutable int mWidth = 0, mHeight = 0;
     mutable int mOffsetX = 0, mOffsetY = 0;
 
     mutable bool mNeedsRedraw = false;
+    mutable unsigned mChangeCount = 0;
 
     float mAlpha = 1.0f;
     std::vector<Sprite*> mSprites;
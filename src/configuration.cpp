@@ -355,11 +355,16 @@ void serdeOptions(T option)
     option("particleMaxCount",              &Config::particleMaxCount);
     option("particleFastPhysics",           &Config::particleFastPhysics);
     option("particleEmitterSkip",           &Config::particleEmitterSkip);
+    option("actorLogicDistance",            &Config::actorLogicDistance);
+    option("resourceCacheSize",             &Config::resourceCacheSize);
     option("particleeffects",               &Config::particleEffects);
     option("logToStandardOut",              &Config::logToStandardOut);
+    option("logRateLimit",                  &Config::logRateLimit);
     option("opengl",                        &Config::opengl);
+    option("modernOpenGL",                  &Config::modernOpenGL);
     option("vsync",                         &Config::vsync);
     option("reduceInputLag",                &Config::reduceInputLag);
+    option("cacheWindows",                  &Config::cacheWindows);
     option("windowmode",                    &Config::windowMode);
     option("screenwidth",                   &Config::screenWidth);
     option("screenheight",                  &Config::screenHeight);
@@ -369,6 +374,8 @@ void serdeOptions(T option)
     option("notificationsVolume",           &Config::notificationsVolume);
     option("musicVolume",                   &Config::musicVolume);
     option("fpslimit",                      &Config::fpsLimit);
+    option("inactiveFpsLimit",              &Config::inactiveFpsLimit);
+    option("adaptiveFpsLimit",              &Config::adaptiveFpsLimit);
 
     option("remember",                      &Config::remember);
     option("username",                      &Config::username);
@@ -379,6 +386,7 @@ void serdeOptions(T option)
     option("useScreenshotDirectorySuffix",  &Config::useScreenshotDirectorySuffix);
 
     option("EnableSync",                    &Config::enableSync);
+    option("movementPrediction",            &Config::movementPrediction);
 
     option("joystickEnabled",               &Config::joystickEnabled);
     option("upTolerance",                   &Config::upTolerance);
@@ -391,6 +399,7 @@ void serdeOptions(T option)
     option("guialpha",                      &Config::guiAlpha);
     option("ChatLogLength",                 &Config::chatLogLength);
     option("enableChatLog",                 &Config::enableChatLog);
+    option("enableChatHistory",             &Config::enableChatHistory);
     option("whispertab",                    &Config::whisperTab);
     option("customcursor",                  &Config::customCursor);
     option("showownname",                   &Config::showOwnName);
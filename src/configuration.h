@@ -185,11 +185,16 @@ struct Config
     int particleMaxCount = 3000;
     int particleFastPhysics = 0;
     int particleEmitterSkip = 1;
+    int actorLogicDistance = 256;
+    int resourceCacheSize = 256;    // Memory budget for unused resources in MiB
     bool particleEffects = true;
     bool logToStandardOut = false;
+    int logRateLimit = 0;
     bool opengl = false;
+    bool modernOpenGL = false;
     bool vsync = true;
     bool reduceInputLag = true;
+    bool cacheWindows = false;
     WindowMode windowMode = WindowMode::Windowed;
     int screenWidth = defaultScreenWidth;
     int screenHeight = defaultScreenHeight;
@@ -199,6 +204,8 @@ struct Config
     int notificationsVolume = 100;
     int musicVolume = 60;
     int fpsLimit = 0;
+    int inactiveFpsLimit = 10;
+    bool adaptiveFpsLimit = true;   // Lower the frame rate to keep it steady
 
     bool remember = true;
     std::string username;
@@ -210,6 +217,7 @@ struct Config
     bool useScreenshotDirectorySuffix = true;
 
     bool enableSync = false;    // Should we honor server "Stop Walking" packets
+    bool movementPrediction = true; // Smooth and extrapolate server positions
 
     bool joystickEnabled = false;
     int upTolerance = 100;
@@ -222,6 +230,7 @@ struct Config
     float guiAlpha = 0.9f;
     int chatLogLength = 256;
     bool enableChatLog = false;
+    bool enableChatHistory = false;
     bool whisperTab = true;
     bool customCursor = true;
     bool showOwnName = false;
@@ -179,6 +179,14 @@ void Event::trigger(Channel channel, const Event &event)
         listener->event(channel, event);
 }
 
+const std::set<EventListener *> &Event::getListeners(Channel channel)
+{
+    static const std::set<EventListener *> noListeners;
+
+    auto it = mBindings.find(channel);
+    return it != mBindings.end() ? it->second : noListeners;
+}
+
 void Event::bind(EventListener *listener, Channel channel)
 {
     mBindings[channel].insert(listener);
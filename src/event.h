@@ -288,6 +288,11 @@ public:
     static void trigger(Channel channel, Type type)
     { trigger(channel, Event(type)); }
 
+    /**
+     * Returns the classes listening to the given channel.
+     */
+    static const std::set<EventListener *> &getListeners(Channel channel);
+
 protected:
     friend class EventListener;
 
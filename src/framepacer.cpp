@@ -0,0 +1,235 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "framepacer.h"
+
+#include "video.h"
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * The number of recent frames used for the frame time percentiles.
+ */
+static constexpr size_t FRAME_HISTORY = 240;
+
+/**
+ * The number of frames over which the adaptive target is evaluated, and the
+ * lowest target it may choose.
+ */
+static constexpr int ADAPTIVE_WINDOW = 60;
+static constexpr int ADAPTIVE_MIN_FPS = 20;
+
+FramePacer::FramePacer()
+    : mFrequency(SDL_GetPerformanceFrequency())
+    , mFrameStart(SDL_GetPerformanceCounter())
+{
+    mFrameTimes.reserve(FRAME_HISTORY);
+}
+
+void FramePacer::present(Video &video)
+{
+    const uint64_t start = SDL_GetPerformanceCounter();
+    video.present();
+    mPresentTicks = SDL_GetPerformanceCounter() - start;
+
+    // Smooth the present time, since it jumps around when waiting for vsync
+    mPresentTime += (static_cast<float>(toMs(mPresentTicks)) - mPresentTime) * 0.05f;
+}
+
+void FramePacer::waitForNextFrame(int fpsLimit, bool vsync, int refreshRate,
+                                  bool adaptive)
+{
+    const uint64_t now = SDL_GetPerformanceCounter();
+    const double workMs = toMs(now - mFrameStart - std::min(mPresentTicks,
+                                                            now - mFrameStart));
+
+    const int targetFps = updateTargetFps(fpsLimit, vsync, refreshRate,
+                                          adaptive, workMs);
+
+    // Presenting already waits for the refresh when running at its rate
+    const bool paced = targetFps > 0 &&
+            !(vsync && refreshRate > 0 && targetFps >= refreshRate);
+
+    if (paced)
+    {
+        const uint64_t period = mFrequency / targetFps;
+
+        // Start a new cadence when the target changed or we fell behind by
+        // more than a frame, rather than rushing to catch up
+        if (targetFps != mTargetFps || mNextFrame == 0 ||
+                now > mNextFrame + period)
+            mNextFrame = now;
+        else
+            waitUntil(mNextFrame);
+
+        mNextFrame += period;
+    }
+    else
+    {
+        mNextFrame = 0;
+    }
+
+    mTargetFps = paced ? targetFps : 0;
+
+    // Record the time since the start of the previous frame
+    const uint64_t frameStart = SDL_GetPerformanceCounter();
+    const auto frameTime = static_cast<float>(toMs(frameStart - mFrameStart));
+
+    if (mFrameTimes.size() < FRAME_HISTORY)
+        mFrameTimes.push_back(frameTime);
+    else
+        mFrameTimes[mNextFrameTime] = frameTime;
+    mNextFrameTime = (mNextFrameTime + 1) % FRAME_HISTORY;
+
+    mFrameStart = frameStart;
+    mPresentTicks = 0;
+}
+
+FramePacer::Stats FramePacer::getStats() const
+{
+    Stats stats;
+    stats.presentTime = mPresentTime;
+    stats.targetFps = mTargetFps;
+
+    if (mFrameTimes.empty())
+        return stats;
+
+    std::vector<float> frameTimes = mFrameTimes;
+    auto percentile = [&] (size_t percent) {
+        auto it = frameTimes.begin() + (frameTimes.size() - 1) * percent / 100;
+        std::nth_element(frameTimes.begin(), it, frameTimes.end());
+        return *it;
+    };
+
+    stats.frameTimeP50 = percentile(50);
+    stats.frameTimeP99 = percentile(99);
+    return stats;
+}
+
+int FramePacer::updateTargetFps(int fpsLimit, bool vsync, int refreshRate,
+                                bool adaptive, double workMs)
+{
+    const bool refreshSteps = vsync && refreshRate > 0;
+
+    // The highest rate we would like to reach
+    int maxFps = fpsLimit;
+    if (refreshSteps && (maxFps <= 0 || maxFps > refreshRate))
+        maxFps = refreshRate;
+
+    if (maxFps <= 0)
+    {
+        mAdaptiveFps = 0;
+        return 0;
+    }
+
+    // Snap to the refresh rate divided by a whole number
+    auto snap = [&] (int fps) {
+        if (!refreshSteps)
+            return fps;
+        const int divisor = (refreshRate + fps - 1) / fps;
+        return refreshRate / divisor;
+    };
+
+    maxFps = snap(maxFps);
+
+    if (!adaptive)
+    {
+        mAdaptiveFps = 0;
+        return maxFps;
+    }
+
+    const int targetFps = mAdaptiveFps > 0 ? std::min(mAdaptiveFps, maxFps)
+                                           : maxFps;
+
+    // Count the frames that used up most of their time
+    const double budgetMs = 1000.0 / targetFps;
+    if (workMs > budgetMs * 0.9)
+        ++mSlowFrames;
+    mMaxWorkMs = std::max(mMaxWorkMs, workMs);
+
+    if (++mAdaptiveFrames < ADAPTIVE_WINDOW)
+        return targetFps;
+
+    int newFps = targetFps;
+
+    if (mSlowFrames > ADAPTIVE_WINDOW / 4)
+    {
+        // Step down to a rate we can sustain
+        if (refreshSteps)
+            newFps = refreshRate / (refreshRate / targetFps + 1);
+        else
+            newFps = targetFps * 3 / 4;
+
+        newFps = std::max(newFps, std::min(ADAPTIVE_MIN_FPS, maxFps));
+    }
+    else if (targetFps < maxFps)
+    {
+        // Step back up when even the slowest frame would fit comfortably
+        int higherFps;
+        if (refreshSteps)
+            higherFps = refreshRate / std::max(refreshRate / targetFps - 1, 1);
+        else
+            higherFps = targetFps * 4 / 3 + 1;
+
+        higherFps = std::min(higherFps, maxFps);
+        if (mSlowFrames == 0 && mMaxWorkMs < 1000.0 / higherFps * 0.6)
+            newFps = higherFps;
+    }
+
+    mAdaptiveFps = newFps < maxFps ? newFps : 0;
+    mAdaptiveFrames = 0;
+    mSlowFrames = 0;
+    mMaxWorkMs = 0.0;
+
+    return newFps;
+}
+
+void FramePacer::waitUntil(uint64_t deadline)
+{
+    for (;;)
+    {
+        const uint64_t now = SDL_GetPerformanceCounter();
+        if (now >= deadline)
+            return;
+
+        const double remainingMs = toMs(deadline - now);
+
+        if (remainingMs > mSleepOverrunMs + 1.0)
+        {
+            // Sleep for most of the remaining time
+            const auto sleepMs = static_cast<uint32_t>(remainingMs - mSleepOverrunMs);
+            SDL_Delay(sleepMs);
+
+            // Track the worst recent overrun, slowly forgetting about it
+            const double overrunMs =
+                    toMs(SDL_GetPerformanceCounter() - now) - sleepMs;
+            mSleepOverrunMs = std::clamp(std::max(overrunMs, mSleepOverrunMs * 0.99),
+                                         0.25, 4.0);
+        }
+        else
+        {
+            // Spin for the rest, while letting other threads run
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Video;
+
+/**
+ * Paces the frames to a target frame rate using the high-resolution
+ * performance counter. Since SDL_Delay may overshoot by a millisecond or
+ * more, the pacer sleeps for most of the remaining time and spins for the
+ * rest.
+ *
+ * When vsync is enabled, the target is rounded to an even divisor of the
+ * refresh rate, so that each frame is shown for the same number of refreshes.
+ * In adaptive mode, the target is lowered while the frames take longer than
+ * the target allows, since steady frame times look smoother than a higher
+ * but uneven frame rate.
+ *
+ * Also keeps track of recent frame times, for the debug window.
+ */
+class FramePacer
+{
+public:
+    struct Stats
+    {
+        float frameTimeP50 = 0.0f;  /**< Median frame time in ms */
+        float frameTimeP99 = 0.0f;  /**< 99th percentile frame time in ms */
+        float presentTime = 0.0f;   /**< Average time spent presenting in ms */
+        int targetFps = 0;          /**< Paced frame rate, 0 when unpaced */
+    };
+
+    FramePacer();
+
+    /**
+     * Presents the frame, measuring how long this takes.
+     */
+    void present(Video &video);
+
+    /**
+     * Waits until the next frame is due.
+     *
+     * @param fpsLimit    the maximum frame rate, or 0 for no limit
+     * @param vsync       whether presenting waits for the display refresh
+     * @param refreshRate the display refresh rate, or 0 when unknown
+     * @param adaptive    whether to lower the target when frames take too long
+     */
+    void waitForNextFrame(int fpsLimit, bool vsync, int refreshRate,
+                          bool adaptive);
+
+    Stats getStats() const;
+
+private:
+    /**
+     * Returns the frame rate to aim for, adapting it to the time taken by
+     * the last frame when requested.
+     */
+    int updateTargetFps(int fpsLimit, bool vsync, int refreshRate,
+                        bool adaptive, double workMs);
+
+    void waitUntil(uint64_t deadline);
+
+    double toMs(uint64_t ticks) const
+    { return ticks * 1000.0 / mFrequency; }
+
+    uint64_t mFrequency;
+    uint64_t mFrameStart;
+    uint64_t mNextFrame = 0;
+    uint64_t mPresentTicks = 0;
+    int mTargetFps = 0;
+
+    /** Estimated amount by which SDL_Delay oversleeps, in ms */
+    double mSleepOverrunMs = 1.0;
+
+    /** Lowered target in adaptive mode, or 0 when not lowered */
+    int mAdaptiveFps = 0;
+    int mAdaptiveFrames = 0;
+    int mSlowFrames = 0;
+    double mMaxWorkMs = 0.0;
+
+    std::vector<float> mFrameTimes;     /**< Ring buffer of frame times */
+    size_t mNextFrameTime = 0;
+    float mPresentTime = 0.0f;
+};
@@ -26,6 +26,7 @@
 #include "channelmanager.h"
 #include "client.h"
 #include "commandhandler.h"
+#include "compoundsprite.h"
 #include "configuration.h"
 #include "effectmanager.h"
 #include "emoteshortcut.h"
@@ -259,6 +260,8 @@ Game::~Game()
     del_0(viewport)
     del_0(mCurrentMap)
 
+    CompoundSprite::clearCache();
+
     mInstance = nullptr;
 
     Event::trigger(Event::GameChannel, Event::Destructed);
@@ -26,6 +26,9 @@
 
 #include <guichan/exception.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 
 void Graphics::updateSize(int width, int height, float /*scale*/)
 {
@@ -117,19 +120,20 @@ void Graphics::drawRescaledImagePattern(const Image *image,
                              scaledHeight);
 }
 
-void Graphics::drawImageRect(const ImageRect &imgRect, int x, int y, int w, int h)
+void ImageRect::appendQuads(std::vector<ImageQuad> &quads,
+                            int x, int y, int w, int h) const
 {
     const int srcGridX[4] = {0,
-                             imgRect.left,
-                             imgRect.image->getWidth() - imgRect.right,
-                             imgRect.image->getWidth()};
+                             left,
+                             image->getWidth() - right,
+                             image->getWidth()};
     const int srcGridY[4] = {0,
-                             imgRect.top,
-                             imgRect.image->getHeight() - imgRect.bottom,
-                             imgRect.image->getHeight()};
+                             top,
+                             image->getHeight() - bottom,
+                             image->getHeight()};
 
-    const int dstGridX[4] = {x, x + imgRect.left, x + w - imgRect.right, x + w};
-    const int dstGridY[4] = {y, y + imgRect.top, y + h - imgRect.bottom, y + h};
+    const int dstGridX[4] = {x, x + left, x + w - right, x + w};
+    const int dstGridY[4] = {y, y + top, y + h - bottom, y + h};
 
     for (unsigned ix = 0; ix < 3; ix++)
     {
@@ -144,32 +148,59 @@ void Graphics::drawImageRect(const ImageRect &imgRect, int x, int y, int w, int
             if (srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0)
                 continue;
 
-            switch (imgRect.fillMode)
+            switch (fillMode)
             {
             case FillMode::Stretch:
-                drawRescaledImage(imgRect.image.get(),
-                                  srcGridX[ix],
-                                  srcGridY[iy],
-                                  dstGridX[ix],
-                                  dstGridY[iy],
-                                  srcW, srcH,
-                                  dstW, dstH);
+                quads.push_back({ srcGridX[ix], srcGridY[iy], srcW, srcH,
+                                  dstGridX[ix], dstGridY[iy], dstW, dstH });
                 break;
             case FillMode::Repeat:
-                drawRescaledImagePattern(imgRect.image.get(),
-                                         srcGridX[ix],
-                                         srcGridY[iy],
-                                         srcW, srcH,
-                                         dstGridX[ix],
-                                         dstGridY[iy],
-                                         dstW, dstH,
-                                         srcW, srcH);
+                // The section is repeated at its original size, with the
+                // last repetition cut off at the edge of the area
+                for (int py = 0; py < dstH; py += srcH)
+                {
+                    const int tileH = std::min(srcH, dstH - py);
+
+                    for (int px = 0; px < dstW; px += srcW)
+                    {
+                        const int tileW = std::min(srcW, dstW - px);
+
+                        quads.push_back({ srcGridX[ix], srcGridY[iy],
+                                          tileW, tileH,
+                                          dstGridX[ix] + px, dstGridY[iy] + py,
+                                          tileW, tileH });
+                    }
+                }
                 break;
             }
         }
     }
 }
 
+void Graphics::drawImageRect(const ImageRect &imgRect, int x, int y, int w, int h)
+{
+    mImageRectQuads.clear();
+    imgRect.appendQuads(mImageRectQuads, x, y, w, h);
+    drawImageQuads(imgRect.image.get(),
+                   mImageRectQuads.data(), mImageRectQuads.size(),
+                   0, 0);
+}
+
+void Graphics::drawImageQuads(const Image *image,
+                              const ImageQuad *quads, size_t count,
+                              int x, int y)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ImageQuad &quad = quads[i];
+        drawRescaledImage(image,
+                          quad.srcX, quad.srcY,
+                          x + quad.dstX, y + quad.dstY,
+                          quad.srcW, quad.srcH,
+                          quad.dstW, quad.dstH);
+    }
+}
+
 void Graphics::drawText(const std::string &text,
                         int x, int y,
                         gcn::Graphics::Alignment alignment,
@@ -236,6 +267,12 @@ void Graphics::drawText(const std::string &text,
              format.shadowColor);
 }
 
+void Graphics::fillRectangles(const std::vector<gcn::Rectangle> &rectangles)
+{
+    for (const auto &rectangle : rectangles)
+        fillRectangle(rectangle);
+}
+
 void Graphics::_beginDraw()
 {
     pushClipArea(gcn::Rectangle(0, 0, mWidth, mHeight));
@@ -246,6 +283,46 @@ void Graphics::_endDraw()
     popClipArea();
 }
 
+void Graphics::beginRenderToTarget(Image *target, int width, int height)
+{
+    assert(!mScreenState);
+
+    // Pending drawing still targets the screen at its size
+    flush();
+
+    mScreenState = ScreenState { std::move(mClipStack),
+                                 std::move(mClipRects),
+                                 mWidth,
+                                 mHeight };
+    mClipStack = {};
+    mClipRects = {};
+    mWidth = width;
+    mHeight = height;
+
+    setRenderTarget(target);
+    updateClipRect();
+    _beginDraw();
+}
+
+void Graphics::endRenderToTarget()
+{
+    assert(mScreenState);
+
+    _endDraw();
+
+    // Pending drawing still targets the render target at its size
+    flush();
+    setRenderTarget(nullptr);
+
+    mClipStack = std::move(mScreenState->clipStack);
+    mClipRects = std::move(mScreenState->clipRects);
+    mWidth = mScreenState->width;
+    mHeight = mScreenState->height;
+    mScreenState.reset();
+
+    updateClipRect();
+}
+
 void Graphics::pushClipRect(const gcn::Rectangle &rect)
 {
     const gcn::ClipRectangle &carea = mClipStack.top();
@@ -30,6 +30,8 @@
 
 #include <memory>
 #include <optional>
+#include <stack>
+#include <vector>
 
 struct TextFormat;
 
@@ -39,6 +41,16 @@ enum class FillMode
     Repeat,
 };
 
+/**
+ * A section of an image drawn stretched to a destination rectangle. The
+ * destination is relative to the position at which the quads are drawn.
+ */
+struct ImageQuad
+{
+    int srcX, srcY, srcW, srcH;
+    int dstX, dstY, dstW, dstH;
+};
+
 /**
  * An image reference along with the margins specifying how to render this
  * image at different sizes. The margins divide the image into 9 sections as
@@ -69,6 +81,13 @@ struct ImageRect
 
     int minWidth() const { return left + right; }
     int minHeight() const { return top + bottom; }
+
+    /**
+     * Appends the quads needed to draw this image rectangle at the given
+     * area. Repeated sections are split into one quad per repetition.
+     */
+    void appendQuads(std::vector<ImageQuad> &quads,
+                     int x, int y, int w, int h) const;
 };
 
 /**
@@ -186,6 +205,15 @@ class Graphics : public gcn::Graphics
             drawImageRect(imgRect, area.x, area.y, area.width, area.height);
         }
 
+        /**
+         * Draws a number of precomputed quads of the same image, offset by
+         * the given position. Backends may override this to submit them all
+         * at once.
+         */
+        virtual void drawImageQuads(const Image *image,
+                                    const ImageQuad *quads, size_t count,
+                                    int x, int y);
+
         using gcn::Graphics::drawText;
 
         void drawText(const std::string &text,
@@ -205,6 +233,12 @@ class Graphics : public gcn::Graphics
                       gcn::Font *font,
                       const TextFormat &format);
 
+        /**
+         * Fills the given rectangles with the current color. Backends may
+         * override this to draw them all at once.
+         */
+        virtual void fillRectangles(const std::vector<gcn::Rectangle> &rectangles);
+
         /**
          * Updates the screen. This is done by either copying the buffer to the
          * screen or swapping pages.
@@ -241,6 +275,38 @@ class Graphics : public gcn::Graphics
          */
         virtual SDL_Surface *getScreenshot() = 0;
 
+        /**
+         * Creates an image that can be drawn to, for caching drawing results.
+         * The size is given in logical pixels, but the image has the
+         * resolution of the screen. Returns <code>nullptr</code> when
+         * rendering to images is not supported.
+         */
+        virtual std::unique_ptr<Image> createRenderTarget(int width, int height)
+        { return {}; }
+
+        /**
+         * Redirects drawing to the given render target, which is cleared to
+         * transparent. Until endRenderToTarget is called, drawing happens
+         * as if the target was a screen of the given logical size.
+         */
+        void beginRenderToTarget(Image *target, int width, int height);
+        void endRenderToTarget();
+
+        /**
+         * Returns whether drawing currently goes to a render target. Render
+         * targets can't be nested.
+         */
+        bool isRenderingToTarget() const { return mScreenState.has_value(); }
+
+        /**
+         * Draws a render target at the given logical size, using the alpha
+         * of the target image. Render targets hold premultiplied alpha, so
+         * they are drawn with a different blend mode than regular images.
+         */
+        virtual void drawRenderTarget(const Image *target,
+                                      int x, int y,
+                                      int width, int height) {}
+
         gcn::Font *getFont() const { return mFont; }
 
         void drawImage(const gcn::Image *image,
@@ -264,6 +330,19 @@ class Graphics : public gcn::Graphics
     protected:
         virtual void updateClipRect() = 0;
 
+        /**
+         * Draws anything the backend has batched so far. Called before the
+         * logical size changes, since pending drawing depends on it.
+         */
+        virtual void flush() {}
+
+        /**
+         * Makes the backend draw to the given render target, or to the screen
+         * when <code>nullptr</code> is passed. The logical size has already
+         * been set to that of the target.
+         */
+        virtual void setRenderTarget(Image *target) {}
+
         int mWidth = 0;
         int mHeight = 0;
         float mScale = 1.0f;
@@ -271,6 +350,20 @@ class Graphics : public gcn::Graphics
 
         // Actual clipping rects. Clipping by gcn::Graphics::mClipStack is disabled.
         std::stack<gcn::Rectangle> mClipRects;
+
+    private:
+        std::vector<ImageQuad> mImageRectQuads;     /**< Reused by drawImageRect */
+
+        // Screen state while drawing to a render target
+        struct ScreenState
+        {
+            std::stack<gcn::ClipRectangle> clipStack;
+            std::stack<gcn::Rectangle> clipRects;
+            int width;
+            int height;
+        };
+
+        std::optional<ScreenState> mScreenState;
 };
 
 extern Graphics *graphics;
@@ -447,6 +447,17 @@ void ChatWindow::setVisible(bool isVisible)
     mTmpVisible = false;
 }
 
+void ChatWindow::logic()
+{
+    Window::logic();
+
+    if (!isVisible())
+        return;
+
+    if (ChatTab *tab = getFocused())
+        tab->pageInHistory();
+}
+
 void ChatWindow::setRecordingFile(const std::string &msg)
 {
     mRecorder->setRecordingFile(msg);
@@ -147,6 +147,11 @@ class ChatWindow : public Window,
         /** Override to reset mTmpVisible */
         void setVisible(bool visible) override;
 
+        /**
+         * Pages in chat history when the current tab is scrolled to the top.
+         */
+        void logic() override;
+
         void mousePressed(gcn::MouseEvent &event) override;
         void mouseDragged(gcn::MouseEvent &event) override;
 
@@ -21,6 +21,7 @@
 
 #include "gui/debugwindow.h"
 
+#include "actorspritemanager.h"
 #include "client.h"
 #include "game.h"
 #include "particle.h"
@@ -39,6 +40,7 @@
 #include "gui/widgets/tabbedarea.h"
 
 #include "resources/image.h"
+#include "resources/resourcemanager.h"
 
 #include "utils/gettext.h"
 #include "utils/stringutils.h"
@@ -61,21 +63,31 @@ public:
         }
 
         mFPSLabel = new Label(std::string());
+        mFrameTimeLabel = new Label(std::string());
+        mFramePacingLabel = new Label(std::string());
         mMusicFileLabel = new Label(std::string());
         mMapLabel = new Label(std::string());
         mMinimapLabel = new Label(std::string());
         mTileMouseLabel = new Label(std::string());
         mParticleCountLabel = new Label(std::string());
+        mActorUpdatesLabel = new Label(std::string());
+        mResourceCountsLabel = new Label(std::string());
+        mResourceMemoryLabel = new Label(std::string());
 
         LayoutHelper h(this);
         ContainerPlacer place = h.getPlacer(0, 0);
 
         place(0, 0, mFPSLabel, 1);
-        place(0, 1, mMusicFileLabel, 1);
-        place(0, 2, mMapLabel, 1);
-        place(0, 3, mMinimapLabel, 1);
-        place(0, 4, mTileMouseLabel, 1);
-        place(0, 5, mParticleCountLabel, 1);
+        place(0, 1, mFrameTimeLabel, 1);
+        place(0, 2, mFramePacingLabel, 1);
+        place(0, 3, mMusicFileLabel, 1);
+        place(0, 4, mMapLabel, 1);
+        place(0, 5, mMinimapLabel, 1);
+        place(0, 6, mTileMouseLabel, 1);
+        place(0, 7, mParticleCountLabel, 1);
+        place(0, 8, mActorUpdatesLabel, 1);
+        place(0, 9, mResourceCountsLabel, 1);
+        place(0, 10, mResourceMemoryLabel, 1);
 
         h.reflowLayout(0, 0);
     }
@@ -87,6 +99,23 @@ public:
 
         mFPSLabel->setCaption(strprintf(mFPSText.c_str(), fps));
 
+        const auto frameStats = Client::getFramePacer().getStats();
+        mFrameTimeLabel->setCaption(
+                    strprintf(_("Frame time: %.1f ms median, %.1f ms 99th percentile"),
+                              frameStats.frameTimeP50, frameStats.frameTimeP99));
+        if (frameStats.targetFps > 0)
+        {
+            mFramePacingLabel->setCaption(
+                        strprintf(_("Frame pacing: %d FPS, present %.1f ms"),
+                                  frameStats.targetFps, frameStats.presentTime));
+        }
+        else
+        {
+            mFramePacingLabel->setCaption(
+                        strprintf(_("Frame pacing: off, present %.1f ms"),
+                                  frameStats.presentTime));
+        }
+
         if (const Map *map = Game::instance()->getCurrentMap())
         {
             // Get the current mouse position
@@ -108,22 +137,49 @@ public:
         mParticleCountLabel->setCaption(strprintf(_("Particle count: %d"),
                                         Particle::particleCount));
 
+        if (actorSpriteManager)
+        {
+            mActorUpdatesLabel->setCaption(
+                        strprintf(_("Actor updates: %d full, %d reduced"),
+                                  actorSpriteManager->getNearbyUpdateCount(),
+                                  actorSpriteManager->getDistantUpdateCount()));
+        }
+
+        const auto &stats = ResourceManager::getInstance()->getStats();
+        mResourceCountsLabel->setCaption(
+                    strprintf(_("Resources: %u hits, %u misses, %u evictions"),
+                              stats.hits, stats.misses, stats.evictions));
+        mResourceMemoryLabel->setCaption(
+                    strprintf(_("Resource memory: %.1f MiB (%.1f MiB unused)"),
+                              stats.residentBytes / (1024.0 * 1024.0),
+                              stats.orphanedBytes / (1024.0 * 1024.0)));
+
         mFPSLabel->adjustSize();
+        mFrameTimeLabel->adjustSize();
+        mFramePacingLabel->adjustSize();
         mMusicFileLabel->adjustSize();
         mMapLabel->adjustSize();
         mMinimapLabel->adjustSize();
         mTileMouseLabel->adjustSize();
         mParticleCountLabel->adjustSize();
+        mActorUpdatesLabel->adjustSize();
+        mResourceCountsLabel->adjustSize();
+        mResourceMemoryLabel->adjustSize();
     }
 
 private:
     std::string mFPSText;
     Label *mFPSLabel;
+    Label *mFrameTimeLabel;
+    Label *mFramePacingLabel;
     Label *mMusicFileLabel;
     Label *mMapLabel;
     Label *mMinimapLabel;
     Label *mTileMouseLabel;
     Label *mParticleCountLabel;
+    Label *mActorUpdatesLabel;
+    Label *mResourceCountsLabel;
+    Label *mResourceMemoryLabel;
 };
 
 class DebugSwitches : public Container, public gcn::ActionListener
@@ -239,6 +295,8 @@ DebugWindow::DebugWindow()
     setMinWidth(100);
     setMinHeight(100);
     setDefaultSize(0, 120, 300, 190);
+    // Shows statistics that change every frame
+    setCacheable(false);
 
     auto *tabs = new TabbedArea;
     place(0, 0, tabs, 2, 2);
@@ -56,10 +56,60 @@ gcn::Font *monoFont = nullptr;
 
 bool Gui::debugDraw;
 
-Gui::Gui(Graphics *graphics, const std::string &themePath)
-    : mAvailableThemes(Theme::getAvailableThemes())
+void Gui::loadThemes(Preload &preload)
+{
+    preload.themePath = Theme::prepareThemePath();
+    preload.availableThemes = Theme::getAvailableThemes();
+
+    for (const ThemeInfo &theme : preload.availableThemes)
+    {
+        if (theme.getPath() == preload.themePath)
+        {
+            Theme::prefetchImages(theme);
+            break;
+        }
+    }
+}
+
+void Gui::loadFonts(Preload &preload, float scale)
+{
+    // Initialize the font scale before creating the fonts
+    TrueTypeFont::updateFontScale(scale);
+
+    const int fontSize = config.fontSize;
+    std::string fontFile;
+
+    try
+    {
+        // Set global font
+        fontFile = branding.getValue("font", "fonts/dejavusans.ttf");
+        std::string path = ResourceManager::getPath(fontFile);
+        preload.guiFont = new TrueTypeFont(path, fontSize);
+        preload.infoParticleFont = new TrueTypeFont(path, fontSize, TTF_STYLE_BOLD);
+
+        // Set bold font
+        fontFile = branding.getValue("boldFont", "fonts/dejavusans-bold.ttf");
+        path = ResourceManager::getPath(fontFile);
+        preload.boldFont = new TrueTypeFont(path, fontSize);
+
+        // Set mono font
+        fontFile = branding.getValue("monoFont", "fonts/dejavusans-mono.ttf");
+        path = ResourceManager::getPath(fontFile);
+        preload.monoFont = new TrueTypeFont(path, fontSize);
+    }
+    catch (gcn::Exception e)
+    {
+        preload.error = std::string("Unable to load '") + fontFile +
+                "': " + e.getMessage();
+    }
+}
+
+Gui::Gui(Graphics *graphics, Preload &preload)
+    : mAvailableThemes(std::move(preload.availableThemes))
     , mCustomCursorScale(Client::getVideo().settings().scale())
 {
+    const std::string &themePath = preload.themePath;
+
     // Try to find the requested theme, using the first one as fallback
     auto themeIt = std::find_if(mAvailableThemes.begin(),
                                 mAvailableThemes.end(),
@@ -89,50 +139,13 @@ Gui::Gui(Graphics *graphics, const std::string &themePath)
     Window::setWindowContainer(guiTop);
     setTop(guiTop);
 
-    // Set global font
-    const int fontSize = config.fontSize;
-    std::string fontFile = branding.getValue("font", "fonts/dejavusans.ttf");
-    std::string path = ResourceManager::getPath(fontFile);
-
-    // Initialize the font scale before creating the fonts
-    TrueTypeFont::updateFontScale(graphics->getScale());
-
-    try
-    {
-        mGuiFont = new TrueTypeFont(path, fontSize);
-        mInfoParticleFont = new TrueTypeFont(path, fontSize, TTF_STYLE_BOLD);
-    }
-    catch (gcn::Exception e)
-    {
-        Log::critical(std::string("Unable to load '") + fontFile +
-                      "': " + e.getMessage());
-    }
-
-    // Set bold font
-    fontFile = branding.getValue("boldFont", "fonts/dejavusans-bold.ttf");
-    path = ResourceManager::getPath(fontFile);
-    try
-    {
-        boldFont = new TrueTypeFont(path, fontSize);
-    }
-    catch (gcn::Exception e)
-    {
-        Log::critical(std::string("Unable to load '") + fontFile +
-                      "': " + e.getMessage());
-    }
+    if (!preload.error.empty())
+        Log::critical(preload.error);
 
-    // Set mono font
-    fontFile = branding.getValue("monoFont", "fonts/dejavusans-mono.ttf");
-    path = ResourceManager::getPath(fontFile);
-    try
-    {
-        monoFont = new TrueTypeFont(path, fontSize);
-    }
-    catch (gcn::Exception e)
-    {
-        Log::critical(std::string("Unable to load '") + fontFile +
-                      "': " + e.getMessage());
-    }
+    mGuiFont = preload.guiFont;
+    mInfoParticleFont = preload.infoParticleFont;
+    boldFont = preload.boldFont;
+    monoFont = preload.monoFont;
 
     loadCustomCursors();
     loadSystemCursors();
@@ -144,6 +157,12 @@ Gui::Gui(Graphics *graphics, const std::string &themePath)
     setUseCustomCursor(config.customCursor);
 
     listen(Event::ConfigChannel);
+
+    // The windows listening to these need to be redrawn when cached
+    listen(Event::AttributesChannel);
+    listen(Event::ChatChannel);
+    listen(Event::NoticesChannel);
+    listen(Event::QuestsChannel);
 }
 
 Gui::~Gui()
@@ -173,6 +192,15 @@ void Gui::logic()
 
     Palette::advanceGradients();
 
+    const bool hasInput = !guiInput->isMouseQueueEmpty() ||
+                          !guiInput->isKeyQueueEmpty() ||
+                          !guiInput->isTextQueueEmpty();
+
+    // Input affects the windows under the mouse and with the focus, both
+    // before and after it has been handled
+    if (hasInput)
+        invalidateInputWindows();
+
     gcn::Gui::logic();
 
     while (!guiInput->isTextQueueEmpty())
@@ -180,6 +208,9 @@ void Gui::logic()
         TextInput textInput = guiInput->dequeueTextInput();
         handleTextInput(textInput);
     }
+
+    if (hasInput)
+        invalidateInputWindows();
 }
 
 void Gui::draw()
@@ -202,13 +233,22 @@ void Gui::draw()
 
 void Gui::event(Event::Channel channel, const Event &event)
 {
-    if (channel == Event::ConfigChannel)
+    if (channel != Event::ConfigChannel)
     {
-        if (event.getType() == Event::ConfigOptionChanged &&
-            event.hasValue(&Config::customCursor))
-        {
-            setUseCustomCursor(config.customCursor);
-        }
+        // Only the windows handling the event may have changed
+        for (EventListener *listener : Event::getListeners(channel))
+            if (auto widget = dynamic_cast<gcn::Widget*>(listener))
+                Window::invalidateWindowOf(widget);
+        return;
+    }
+
+    // Options may change how any window is drawn, but rarely change
+    static_cast<WindowContainer*>(getTop())->invalidateWindows();
+
+    if (event.getType() == Event::ConfigOptionChanged &&
+        event.hasValue(&Config::customCursor))
+    {
+        setUseCustomCursor(config.customCursor);
     }
 }
 
@@ -235,6 +275,7 @@ bool Gui::videoResized(int width, int height)
 
     top->setSize(width, height);
     top->adjustAfterResize(oldWidth, oldHeight);
+    top->invalidateWindows();
     return true;
 }
 
@@ -259,6 +300,15 @@ void Gui::setCursorType(Cursor cursor)
 void Gui::setTheme(const ThemeInfo &theme)
 {
     mTheme = std::make_unique<Theme>(theme);
+
+    if (auto top = static_cast<WindowContainer*>(getTop()))
+        top->invalidateWindows();
+}
+
+void Gui::invalidateInputWindows()
+{
+    Window::invalidateWindowOf(getWidgetAt(mMouseX, mMouseY));
+    Window::invalidateWindowOf(mFocusHandler->getFocused());
 }
 
 void Gui::updateCursor()
@@ -85,7 +85,34 @@ class Gui final : public gcn::Gui,
                   public gcn::KeyListener
 {
     public:
-        Gui(Graphics *screen, const std::string &themePath);
+        /**
+         * Data used by the GUI that can be loaded before it is created,
+         * on another thread.
+         */
+        struct Preload
+        {
+            std::string themePath;
+            std::vector<ThemeInfo> availableThemes;
+            gcn::Font *guiFont = nullptr;
+            gcn::Font *infoParticleFont = nullptr;
+            gcn::Font *boldFont = nullptr;
+            gcn::Font *monoFont = nullptr;
+            std::string error;      /**< Set when a font failed to load */
+        };
+
+        /**
+         * Finds the available themes and decodes the images of the chosen
+         * theme. Does not create any textures.
+         */
+        static void loadThemes(Preload &preload);
+
+        /**
+         * Loads the fonts for the given scale. No other fonts may be loaded
+         * at the same time.
+         */
+        static void loadFonts(Preload &preload, float scale);
+
+        Gui(Graphics *screen, Preload &preload);
 
         ~Gui() override;
 
@@ -165,6 +192,7 @@ class Gui final : public gcn::Gui,
         void handleTextInput(const TextInput &textInput);
 
     private:
+        void invalidateInputWindows();
         void updateCursor();
         void updateDragTargetFromPosition(int x, int y);
 
@@ -23,6 +23,7 @@
 
 #include "actorspritemanager.h"
 #include "being.h"
+#include "client.h"
 #include "configuration.h"
 #include "graphics.h"
 #include "localplayer.h"
@@ -31,6 +32,7 @@
 #include "gui/setup.h"
 
 #include "resources/image.h"
+#include "resources/minimapgenerator.h"
 #include "resources/resourcemanager.h"
 #include "resources/userpalette.h"
 
@@ -48,6 +50,8 @@ Minimap::Minimap():
     // set this to false as the minimap window size is changed
     //depending on the map size
     setResizable(false);
+    // The player and being dots move every frame
+    setCacheable(false);
     setupWindow->registerWindowForReset(this);
 
     setDefaultVisible(true);
@@ -58,6 +62,9 @@ Minimap::Minimap():
 
     loadWindowState();
     setVisible(config.showMinimap, isSticky());
+
+    mGenerator = std::make_unique<MinimapGenerator>(
+                Client::getLocalDataDirectory() + "/minimaps");
 }
 
 Minimap::~Minimap() = default;
@@ -77,6 +84,9 @@ void Minimap::setMap(Map *map)
 
     // Adapt the image
     mMapImage = nullptr;
+    mGeneratedImage.reset();
+    mGenerator->cancel();
+    mGenerating = false;
 
     if (map)
     {
@@ -92,27 +102,77 @@ void Minimap::setMap(Map *map)
 
         if (!minimapName.empty())
             mMapImage = resman->getImage(minimapName);
+
+        if (!mMapImage)
+        {
+            mGenerator->generate(map);
+            mGenerating = true;
+        }
+    }
+
+    // The window is updated once the generated minimap is done
+    if (!mGenerating)
+        updateImageSize();
+}
+
+void Minimap::toggle()
+{
+    setVisible(!isVisible(), isSticky());
+    config.showMinimap = isVisible();
+}
+
+void Minimap::logic()
+{
+    Window::logic();
+
+    if (!mGenerating)
+        return;
+
+    SDL_Surface *surface;
+    if (!mGenerator->takeResult(surface))
+        return;
+
+    if (surface)
+    {
+        mGeneratedImage.reset(Image::load(surface));
+        SDL_FreeSurface(surface);
     }
 
+    // Without an image, this hides the window
+    mGenerating = false;
+    updateImageSize();
+}
+
+const Image *Minimap::getMapImage() const
+{
     if (mMapImage)
+        return mMapImage;
+    return mGeneratedImage.get();
+}
+
+void Minimap::updateImageSize()
+{
+    const Image *mapImage = getMapImage();
+
+    if (mapImage && mMap)
     {
         const int offsetX = 2 * getPadding();
         const int offsetY = getTitleBarHeight() + getPadding();
         const int titleWidth = getFont()->getWidth(getCaption()) + 15;
-        const int mapWidth = mMapImage->getWidth() < 100 ?
-                             mMapImage->getWidth() + offsetX : 100;
-        const int mapHeight = mMapImage->getHeight() < 100 ?
-                              mMapImage->getHeight() + offsetY : 100;
+        const int mapWidth = mapImage->getWidth() < 100 ?
+                             mapImage->getWidth() + offsetX : 100;
+        const int mapHeight = mapImage->getHeight() < 100 ?
+                              mapImage->getHeight() + offsetY : 100;
 
         setMinWidth(mapWidth > titleWidth ? mapWidth : titleWidth);
         setMinHeight(mapHeight);
 
-        mWidthProportion = (float) mMapImage->getWidth() / map->getWidth();
-        mHeightProportion = (float) mMapImage->getHeight() / map->getHeight();
+        mWidthProportion = (float) mapImage->getWidth() / mMap->getWidth();
+        mHeightProportion = (float) mapImage->getHeight() / mMap->getHeight();
 
-        setMaxWidth(mMapImage->getWidth() > titleWidth ?
-                    mMapImage->getWidth() + offsetX : titleWidth);
-        setMaxHeight(mMapImage->getHeight() + offsetY);
+        setMaxWidth(mapImage->getWidth() > titleWidth ?
+                    mapImage->getWidth() + offsetX : titleWidth);
+        setMaxHeight(mapImage->getHeight() + offsetY);
 
         setDefaultSize(getX(), getY(), getWidth(), getHeight());
         resetToDefaultSize();
@@ -127,12 +187,6 @@ void Minimap::setMap(Map *map)
     }
 }
 
-void Minimap::toggle()
-{
-    setVisible(!isVisible(), isSticky());
-    config.showMinimap = isVisible();
-}
-
 void Minimap::draw(gcn::Graphics *graphics)
 {
     Window::draw(graphics);
@@ -152,11 +206,11 @@ void Minimap::draw(gcn::Graphics *graphics)
     int mapOriginX = 0;
     int mapOriginY = 0;
 
-    if (mMapImage)
+    if (const Image *mapImage = getMapImage())
     {
         const Vector &p = local_player->getPosition();
-        const int minOriginX = a.width - mMapImage->getWidth();
-        const int minOriginY = a.height - mMapImage->getHeight();
+        const int minOriginX = a.width - mapImage->getWidth();
+        const int minOriginY = a.height - mapImage->getHeight();
 
         if (minOriginX < 0)
         {
@@ -169,9 +223,12 @@ void Minimap::draw(gcn::Graphics *graphics)
             mapOriginY = std::clamp(mapOriginY, minOriginY, 0);
         }
 
-        g->drawImage(mMapImage, mapOriginX, mapOriginY);
+        g->drawImage(mapImage, mapOriginX, mapOriginY);
     }
 
+    for (auto &[_, markers] : mMarkers)
+        markers.clear();
+
     for (auto actor : actorSpriteManager->getAll())
     {
         if (actor->getType() == ActorSprite::FLOOR_ITEM)
@@ -212,18 +269,26 @@ void Minimap::draw(gcn::Graphics *graphics)
             }
         }
 
-        graphics->setColor(userPalette->getColor(type));
-
         const int offsetHeight = (int) ((dotSize - 1) * mHeightProportion);
         const int offsetWidth = (int) ((dotSize - 1) * mWidthProportion);
         const Vector &pos = being->getPosition();
 
-        g->fillRectangle(
-            gcn::Rectangle((int) (pos.x * mWidthProportion) / tileWidth + mapOriginX - offsetWidth,
-                           (int) (pos.y * mHeightProportion) / tileHeight + mapOriginY
-                               - offsetHeight,
-                           dotSize,
-                           dotSize));
+        mMarkers[type].emplace_back(
+            (int) (pos.x * mWidthProportion) / tileWidth + mapOriginX - offsetWidth,
+            (int) (pos.y * mHeightProportion) / tileHeight + mapOriginY
+                - offsetHeight,
+            dotSize,
+            dotSize);
+    }
+
+    // Draw the markers of each color at once
+    for (const auto &[type, markers] : mMarkers)
+    {
+        if (markers.empty())
+            continue;
+
+        g->setColor(userPalette->getColor(type));
+        g->fillRectangles(markers);
     }
 
     g->popClipArea();
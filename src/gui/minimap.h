@@ -25,15 +25,21 @@
 
 #include "resources/resource.h"
 
+#include <map>
+#include <memory>
+#include <vector>
+
 class Image;
 class Map;
+class MinimapGenerator;
 
 /**
  * Minimap window. Shows a minimap image and the name of the current map.
  *
  * The name of the map is defined by the map property "name". The minimap image
  * is defined by the map property "minimap". The path to the image should be
- * given relative to the root of the client data.
+ * given relative to the root of the client data. When a map has no minimap
+ * image, one is generated from its tiles.
  *
  * \ingroup Interface
  */
@@ -53,14 +59,32 @@ class Minimap : public Window
          */
         void toggle();
 
+        /**
+         * Picks up a generated minimap once it is done.
+         */
+        void logic() override;
+
         /**
          * Draws the minimap.
          */
         void draw(gcn::Graphics *graphics) override;
 
     private:
+        const Image *getMapImage() const;
+
+        /**
+         * Adapts the window size to the current minimap image.
+         */
+        void updateImageSize();
+
         Map *mMap = nullptr;
         ResourceRef<Image> mMapImage;
+        std::unique_ptr<Image> mGeneratedImage;
+        std::unique_ptr<MinimapGenerator> mGenerator;
+        bool mGenerating = false;
+
+        /** Being markers by color, reused between frames */
+        std::map<int, std::vector<gcn::Rectangle>> mMarkers;
         float mWidthProportion = 0.5;
         float mHeightProportion = 0.5;
 };
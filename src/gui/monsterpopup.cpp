@@ -78,7 +78,7 @@ void MonsterPopup::loadSpriteDisplay(const SpriteDisplay &display)
         {
             // Ensure we are using idle-looking-down to query offsets
             s->setDirection(DIRECTION_DOWN);
-            s->play(SpriteAction::STAND);
+            s->play(SpriteAction::STAND_ID);
 
             minOffsetY = std::min(minOffsetY, s->getOffsetY());
 
@@ -91,7 +91,7 @@ void MonsterPopup::loadSpriteDisplay(const SpriteDisplay &display)
 
     // Ensure compound uses the same action/direction
     mSprite.setDirection(DIRECTION_DOWN);
-    mSprite.play(SpriteAction::STAND);
+    mSprite.play(SpriteAction::STAND_ID);
 
     // Cache metrics
     mSpriteWidth = mSprite.getWidth();
@@ -606,6 +606,10 @@ void NpcEventListener::event(Event::Channel channel,
     if (channel != Event::NpcChannel)
         return;
 
+    // Any existing dialog is changed below, so a cached one needs redrawing
+    if (NpcDialog *dialog = findDialog(event.getInt("id", 0)))
+        dialog->invalidate();
+
     if (event.getType() == Event::Message)
     {
         NpcDialog *dialog = getDialog(event.getInt("id"));
@@ -21,6 +21,7 @@
 
 #include "gui/serverdialog.h"
 
+#include "chathistory.h"
 #include "chatlogger.h"
 #include "client.h"
 #include "configuration.h"
@@ -264,6 +265,7 @@ void ServerDialog::action(const gcn::ActionEvent &event)
             saveCustomServers(*mServerInfo);
 
             chatLogger->setServerName(mServerInfo->hostname);
+            chatHistory->setServerName(mServerInfo->hostname);
 
             Client::setState(State::ConnectServer);
         }
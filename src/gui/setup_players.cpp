@@ -215,7 +215,9 @@ Setup_Players::Setup_Players():
     mDeleteButton(new Button(_("Delete"), ACTION_DELETE, this)),
     mWhisperTabCheckBox(new CheckBox(_("Put all whispers in tabs"), config.whisperTab)),
     mShowGenderCheckBox(new CheckBox(_("Show gender"), config.showGender)),
-    mEnableChatLogCheckBox(new CheckBox(_("Enable Chat log"), config.enableChatLog))
+    mEnableChatLogCheckBox(new CheckBox(_("Enable Chat log"), config.enableChatLog)),
+    mEnableChatHistoryCheckBox(new CheckBox(_("Enable Chat history"),
+                                            config.enableChatHistory))
 {
     setName(_("Players"));
 
@@ -269,6 +271,7 @@ Setup_Players::Setup_Players():
     place(0, 5, mDeleteButton);
     place(0, 6, mShowGenderCheckBox, 2);
     place(0, 7, mEnableChatLogCheckBox, 2);
+    place(2, 7, mEnableChatHistoryCheckBox, 2);
     place(2, 5, ignore_action_label);
     place(2, 6, mIgnoreActionChoicesBox, 2);
     place(0, 8, mDefaultTrading);
@@ -313,6 +316,7 @@ void Setup_Players::apply()
 
     config.whisperTab = mWhisperTabCheckBox->isSelected();
     config.enableChatLog = mEnableChatLogCheckBox->isSelected();
+    config.enableChatHistory = mEnableChatHistoryCheckBox->isSelected();
 
     mShowGender = config.showGender;
 }
@@ -322,6 +326,7 @@ void Setup_Players::cancel()
     mWhisperTabCheckBox->setSelected(config.whisperTab);
     mShowGenderCheckBox->setSelected(mShowGender);
     mEnableChatLogCheckBox->setSelected(config.enableChatLog);
+    mEnableChatHistoryCheckBox->setSelected(config.enableChatHistory);
 
     setConfigValue(&Config::showGender, mShowGender);
 }
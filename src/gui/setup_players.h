@@ -68,4 +68,5 @@ private:
     gcn::CheckBox *mWhisperTabCheckBox;
     gcn::CheckBox *mShowGenderCheckBox;
     gcn::CheckBox *mEnableChatLogCheckBox;
+    gcn::CheckBox *mEnableChatHistoryCheckBox;
 };
@@ -212,6 +212,20 @@ static const char *particleDetailToString(int detail)
     return "";
 }
 
+enum Renderer
+{
+    RENDERER_SDL,
+    RENDERER_OPENGL_LEGACY,
+    RENDERER_OPENGL_3
+};
+
+static int rendererIndex(const VideoSettings &settings)
+{
+    if (!settings.openGL)
+        return RENDERER_SDL;
+    return settings.modernOpenGL ? RENDERER_OPENGL_3 : RENDERER_OPENGL_LEGACY;
+}
+
 Setup_Video::Setup_Video():
     mVideoSettings(Client::getVideo().settings()),
     mCustomCursorEnabled(config.customCursor),
@@ -219,15 +233,18 @@ Setup_Video::Setup_Video():
     mFps(config.fpsLimit),
     mSDLTransparencyDisabled(config.disableTransparency),
     mReduceInputLagEnabled(config.reduceInputLag),
+    mCacheWindowsEnabled(config.cacheWindows),
     mWindowModeListModel(new StringListModel({ _("Windowed"), _("Windowed Fullscreen"), _("Fullscreen") })),
     mResolutionListModel(new ResolutionListModel),
     mScaleListModel(new ScaleListModel(mVideoSettings)),
+    mRendererListModel(new StringListModel({ _("SDL"), _("OpenGL (Legacy)"), _("OpenGL 3.3") })),
     mWindowModeDropDown(new DropDown(mWindowModeListModel.get())),
     mResolutionDropDown(new DropDown(mResolutionListModel.get())),
     mScaleDropDown(new DropDown(mScaleListModel.get())),
     mVSyncCheckBox(new CheckBox(_("VSync"), mVideoSettings.vsync)),
     mReduceInputLagCheckBox(new CheckBox(_("Reduce input lag (call glFinish)"), mReduceInputLagEnabled)),
-    mOpenGLCheckBox(new CheckBox(_("OpenGL (Legacy)"), mVideoSettings.openGL)),
+    mCacheWindowsCheckBox(new CheckBox(_("Cache window rendering"), mCacheWindowsEnabled)),
+    mRendererDropDown(new DropDown(mRendererListModel.get())),
     mCustomCursorCheckBox(new CheckBox(_("Custom cursor"), mCustomCursorEnabled)),
     mParticleEffectsCheckBox(new CheckBox(_("Particle effects"), mParticleEffectsEnabled)),
     mFpsCheckBox(new CheckBox(_("FPS limit:"))),
@@ -248,8 +265,9 @@ Setup_Video::Setup_Video():
     auto overlayDetailLabel = new Label(_("Ambient FX:"));
     auto particleDetailLabel = new Label(_("Particle detail:"));
 
+    mRendererDropDown->setSelected(rendererIndex(mVideoSettings));
 #ifndef USE_OPENGL
-    mOpenGLCheckBox->setEnabled(false);
+    mRendererDropDown->setEnabled(false);
 #endif
 
     mFpsLabel->setCaption(mFps > 0 ? toString(mFps) : _("None"));
@@ -282,7 +300,7 @@ Setup_Video::Setup_Video():
     mFpsSlider->setActionEventId("fpslimitslider");
     mOverlayDetailSlider->setActionEventId("overlaydetailslider");
     mOverlayDetailField->setActionEventId("overlaydetailfield");
-    mOpenGLCheckBox->setActionEventId("opengl");
+    mRendererDropDown->setActionEventId("renderer");
     mParticleDetailSlider->setActionEventId("particledetailslider");
     mParticleDetailField->setActionEventId("particledetailfield");
 
@@ -290,7 +308,7 @@ Setup_Video::Setup_Video():
     mWindowModeDropDown->addActionListener(this);
     mResolutionDropDown->addActionListener(this);
     mCustomCursorCheckBox->addActionListener(this);
-    mOpenGLCheckBox->addActionListener(this);
+    mRendererDropDown->addActionListener(this);
     mParticleEffectsCheckBox->addActionListener(this);
     mDisableSDLTransparencyCheckBox->addActionListener(this);
     mFpsCheckBox->addActionListener(this);
@@ -318,7 +336,9 @@ Setup_Video::Setup_Video():
     place(1, 2, mScaleDropDown, 2).setPadding(2);
     place(0, 3, mVSyncCheckBox, 4);
     place(0, 4, mReduceInputLagCheckBox, 4);
-    place(0, 5, mOpenGLCheckBox, 4);
+    place(0, 5, new Label(_("Renderer:")));
+    place(1, 5, mRendererDropDown, 2).setPadding(2);
+    place(0, 6, mCacheWindowsCheckBox, 4);
 
     place = getPlacer(0, 1);
     place.getCell().setHAlign(LayoutCell::FILL);
@@ -377,13 +397,15 @@ void Setup_Video::apply()
         new OkDialog(_("Error"), _("Failed to change video mode."));
     }
 
-    // OpenGL change
-    if (mOpenGLCheckBox->isSelected() != mVideoSettings.openGL)
+    // Renderer change
+    const int renderer = mRendererDropDown->getSelected();
+    if (renderer != rendererIndex(mVideoSettings))
     {
-        config.opengl = mOpenGLCheckBox->isSelected();
+        config.opengl = renderer != RENDERER_SDL;
+        config.modernOpenGL = renderer == RENDERER_OPENGL_3;
 
-        // OpenGL can currently only be changed by restarting, notify user.
-        if (mOpenGLCheckBox->isSelected())
+        // The renderer can currently only be changed by restarting, notify user.
+        if (config.opengl && !mVideoSettings.openGL)
         {
             new OkDialog(_("Changing to OpenGL"),
                          _("Applying change to OpenGL requires restart.\n\n"
@@ -391,6 +413,11 @@ void Setup_Video::apply()
                            "restart the game with the command line option "
                            "\"--no-opengl\"."));
         }
+        else if (config.opengl)
+        {
+            new OkDialog(_("Changing renderer"),
+                         _("Applying change to the renderer requires restart."));
+        }
         else
         {
             new OkDialog(_("Deactivating OpenGL"),
@@ -425,15 +452,20 @@ void Setup_Video::apply()
     // Reduce input lag change
     config.reduceInputLag = mReduceInputLagCheckBox->isSelected();
 
+    // Window caching change
+    setConfigValue(&Config::cacheWindows, mCacheWindowsCheckBox->isSelected());
+
     // We sync old and new values at apply time
     mVideoSettings.windowMode = config.windowMode;
     mVideoSettings.vsync = config.vsync;
     mVideoSettings.openGL = config.opengl;
+    mVideoSettings.modernOpenGL = config.modernOpenGL;
     mCustomCursorEnabled = config.customCursor;
     mParticleEffectsEnabled = config.particleEffects;
     mOverlayDetail = config.overlayDetail;
     mSDLTransparencyDisabled = config.disableTransparency;
     mReduceInputLagEnabled = config.reduceInputLag;
+    mCacheWindowsEnabled = config.cacheWindows;
 }
 
 void Setup_Video::cancel()
@@ -446,7 +478,8 @@ void Setup_Video::cancel()
     mScaleDropDown->setSelected(mVideoSettings.userScale);
     mVSyncCheckBox->setSelected(mVideoSettings.vsync);
     mReduceInputLagCheckBox->setSelected(mReduceInputLagEnabled);
-    mOpenGLCheckBox->setSelected(mVideoSettings.openGL);
+    mCacheWindowsCheckBox->setSelected(mCacheWindowsEnabled);
+    mRendererDropDown->setSelected(rendererIndex(mVideoSettings));
     mCustomCursorCheckBox->setSelected(mCustomCursorEnabled);
     mParticleEffectsCheckBox->setSelected(mParticleEffectsEnabled);
     mFpsCheckBox->setSelected(mFps > 0);
@@ -464,8 +497,10 @@ void Setup_Video::cancel()
     setConfigValue(&Config::customCursor, mCustomCursorEnabled);
     config.particleEffects = mParticleEffectsEnabled;
     config.opengl = mVideoSettings.openGL;
+    config.modernOpenGL = mVideoSettings.modernOpenGL;
     config.disableTransparency = mSDLTransparencyDisabled;
     config.reduceInputLag = mReduceInputLagEnabled;
+    setConfigValue(&Config::cacheWindows, mCacheWindowsEnabled);
 }
 
 void Setup_Video::action(const gcn::ActionEvent &event)
@@ -535,10 +570,10 @@ void Setup_Video::action(const gcn::ActionEvent &event)
         mFpsSlider->setValue(mFps);
         mFpsSlider->setEnabled(mFps > 0);
     }
-    else if (id == "opengl" || id == "disableTransparency")
+    else if (id == "renderer" || id == "disableTransparency")
     {
         // Disable transparency disabling when in OpenGL.
-        if (mOpenGLCheckBox->isSelected())
+        if (mRendererDropDown->getSelected() != RENDERER_SDL)
         {
             mDisableSDLTransparencyCheckBox->setSelected(false);
             mDisableSDLTransparencyCheckBox->setEnabled(false);
@@ -54,17 +54,20 @@ class Setup_Video : public SetupTab, public gcn::ActionListener,
         int mFps;
         bool mSDLTransparencyDisabled;
         bool mReduceInputLagEnabled;
+        bool mCacheWindowsEnabled;
 
         std::unique_ptr<gcn::ListModel> mWindowModeListModel;
         std::unique_ptr<ResolutionListModel> mResolutionListModel;
         std::unique_ptr<ScaleListModel> mScaleListModel;
+        std::unique_ptr<gcn::ListModel> mRendererListModel;
 
         gcn::DropDown *mWindowModeDropDown;
         gcn::DropDown *mResolutionDropDown;
         DropDown *mScaleDropDown;
         gcn::CheckBox *mVSyncCheckBox;
         gcn::CheckBox *mReduceInputLagCheckBox;
-        gcn::CheckBox *mOpenGLCheckBox;
+        gcn::CheckBox *mCacheWindowsCheckBox;
+        gcn::DropDown *mRendererDropDown;
         gcn::CheckBox *mCustomCursorCheckBox;
         gcn::CheckBox *mParticleEffectsCheckBox;
 
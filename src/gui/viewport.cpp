@@ -402,8 +402,8 @@ void Viewport::_drawPath(Graphics *graphics, const Path &path,
         graphics->fillRectangle(gcn::Rectangle(squareX - 4, squareY - 4,
                                                 8, 8));
         graphics->drawText(
-                toString(mMap->getMetaTile(pos.x / mMap->getTileWidth(),
-                                           pos.y / mMap->getTileHeight())->Gcost),
+                toString(mMap->getPathCost(pos.x / mMap->getTileWidth(),
+                                           pos.y / mMap->getTileHeight())),
                 squareX + 4, squareY + 12, gcn::Graphics::CENTER);
     }
 }
@@ -27,6 +27,7 @@
 #include "gui/gui.h"
 #include "gui/truetypefont.h"
 #include "gui/widgets/linkhandler.h"
+#include "gui/widgets/window.h"
 
 #include "resources/theme.h"
 
@@ -138,51 +139,12 @@ void BrowserBox::addRows(std::string_view rows)
     }
 }
 
-void BrowserBox::addRow(std::string_view row)
+int BrowserBox::addRow(std::string_view row)
 {
-    TextRow &newRow = mTextRows.emplace_back();
-
-    // Use links and user defined colors
-    if (mUseLinksAndUserColors)
-    {
-        // Check for links in format "@@link|Caption@@"
-        auto linkStart = row.find("@@");
-        while (linkStart != std::string::npos)
-        {
-            const auto linkSep = row.find("|", linkStart);
-            const auto linkEnd = row.find("@@", linkSep);
-
-            if (linkSep == std::string::npos || linkEnd == std::string::npos)
-                break;
+    Window::invalidateWindowOf(this);
 
-            BrowserLink &link = newRow.links.emplace_back();
-            link.link = row.substr(linkStart + 2, linkSep - (linkStart + 2));
-            link.caption = row.substr(linkSep + 1, linkEnd - (linkSep + 1));
-
-            if (link.caption.empty() && mLinkHandler)
-                link.caption = mLinkHandler->captionForLink(link.link);
-
-            newRow.text += row.substr(0, linkStart);
-            newRow.text += "##<" + link.caption;
-
-            row = row.substr(linkEnd + 2);
-            if (!row.empty())
-            {
-                newRow.text += "##>";
-            }
-            linkStart = row.find("@@");
-        }
-
-        newRow.text += row;
-    }
-    // Don't use links and user defined colors
-    else
-    {
-        newRow.text = row;
-    }
-
-    if (mEnableKeys)
-        replaceKeys(newRow.text);
+    TextRow &newRow = mTextRows.emplace_back();
+    parseRow(newRow, row);
 
     // Layout the newly added row
     LayoutContext context(getFont(), gui->getTheme()->getPalette(mPalette));
@@ -214,10 +176,50 @@ void BrowserBox::addRow(std::string_view row)
     }
 
     setHeight(context.y - removedHeight);
+    return removedHeight;
+}
+
+int BrowserBox::prependRows(const std::vector<std::string> &rows)
+{
+    if (rows.empty())
+        return 0;
+
+    Window::invalidateWindowOf(this);
+
+    const int oldHeight = getHeight();
+
+    for (auto it = rows.rbegin(); it != rows.rend(); ++it)
+        parseRow(mTextRows.emplace_front(), *it);
+
+    mHoveredLink.reset();
+    relayoutText();
+
+    return getHeight() - oldHeight;
+}
+
+void BrowserBox::removeLastRows(size_t count)
+{
+    count = std::min(count, mTextRows.size());
+    if (count == 0)
+        return;
+
+    Window::invalidateWindowOf(this);
+
+    int removedHeight = 0;
+    for (; count > 0; --count)
+    {
+        removedHeight += mTextRows.back().height;
+        mTextRows.pop_back();
+    }
+
+    mHoveredLink.reset();
+    setHeight(getHeight() - removedHeight);
 }
 
 void BrowserBox::clearRows()
 {
+    Window::invalidateWindowOf(this);
+
     mTextRows.clear();
     setSize(mMode == AUTO_SIZE ? 0 : getWidth(), 0);
     mHoveredLink.reset();
@@ -307,6 +309,51 @@ void BrowserBox::draw(gcn::Graphics *graphics)
     }
 }
 
+void BrowserBox::parseRow(TextRow &newRow, std::string_view row)
+{
+    // Use links and user defined colors
+    if (mUseLinksAndUserColors)
+    {
+        // Check for links in format "@@link|Caption@@"
+        auto linkStart = row.find("@@");
+        while (linkStart != std::string::npos)
+        {
+            const auto linkSep = row.find("|", linkStart);
+            const auto linkEnd = row.find("@@", linkSep);
+
+            if (linkSep == std::string::npos || linkEnd == std::string::npos)
+                break;
+
+            BrowserLink &link = newRow.links.emplace_back();
+            link.link = row.substr(linkStart + 2, linkSep - (linkStart + 2));
+            link.caption = row.substr(linkSep + 1, linkEnd - (linkSep + 1));
+
+            if (link.caption.empty() && mLinkHandler)
+                link.caption = mLinkHandler->captionForLink(link.link);
+
+            newRow.text += row.substr(0, linkStart);
+            newRow.text += "##<" + link.caption;
+
+            row = row.substr(linkEnd + 2);
+            if (!row.empty())
+            {
+                newRow.text += "##>";
+            }
+            linkStart = row.find("@@");
+        }
+
+        newRow.text += row;
+    }
+    // Don't use links and user defined colors
+    else
+    {
+        newRow.text = row;
+    }
+
+    if (mEnableKeys)
+        replaceKeys(newRow.text);
+}
+
 /**
  * Relayouts all text rows and returns the new height of the BrowserBox.
  */
@@ -114,6 +114,16 @@ class BrowserBox : public gcn::Widget,
          */
         void setMaxRows(unsigned maxRows) { mMaxRows = maxRows; }
 
+        /**
+         * Returns the maximum numbers of rows in the browser box.
+         */
+        unsigned getMaxRows() const { return mMaxRows; }
+
+        /**
+         * Returns the number of rows in the browser box.
+         */
+        size_t getRowCount() const { return mTextRows.size(); }
+
         /**
          * Disable links & user defined colors to be used in chat input.
          */
@@ -130,9 +140,22 @@ class BrowserBox : public gcn::Widget,
         void addRows(std::string_view rows);
 
         /**
-         * Adds a text row to the browser.
+         * Adds a text row to the browser. Returns the height of the rows
+         * dropped at the top when the row limit is reached.
+         */
+        int addRow(std::string_view row);
+
+        /**
+         * Adds the given rows above the existing rows. Returns the height
+         * by which the contents grew. The row limit is not applied until the
+         * next row is added.
+         */
+        int prependRows(const std::vector<std::string> &rows);
+
+        /**
+         * Removes up to \a count rows at the bottom.
          */
-        void addRow(std::string_view row);
+        void removeLastRows(size_t count);
 
         /**
          * Remove all rows.
@@ -167,6 +190,7 @@ class BrowserBox : public gcn::Widget,
         };
 
     private:
+        void parseRow(TextRow &row, std::string_view text);
         void relayoutText();
         void layoutTextRow(TextRow &row, LayoutContext &context);
         void updateHoveredLink(int x, int y);
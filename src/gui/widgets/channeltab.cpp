@@ -38,6 +38,11 @@ ChannelTab::~ChannelTab()
 {
 }
 
+std::string ChannelTab::getHistoryName() const
+{
+    return "#Channel_" + mChannel->getName();
+}
+
 void ChannelTab::handleInput(const std::string &msg)
 {
     Net::getChatHandler()->sendToChannel(getChannel()->getId(), msg);
@@ -38,6 +38,8 @@ class ChannelTab : public ChatTab
         bool handleCommand(const std::string &type,
                            const std::string &args) override;
 
+        std::string getHistoryName() const override;
+
     protected:
         friend class Channel;
 
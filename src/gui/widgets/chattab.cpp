@@ -22,6 +22,7 @@
 #include "gui/widgets/chattab.h"
 
 #include "actorspritemanager.h"
+#include "chathistory.h"
 #include "chatlogger.h"
 #include "client.h"
 #include "commandhandler.h"
@@ -45,7 +46,38 @@
 #include "utils/stringutils.h"
 
 #include <guichan/widgets/tabbedarea.hpp>
-#include <iomanip>
+
+#include <ctime>
+
+/**
+ * The number of lines added from the chat history at a time.
+ */
+static constexpr size_t HISTORY_PAGE_SIZE = 32;
+
+/**
+ * Formats the timestamp shown in front of each line.
+ */
+static std::string formatTimestamp(time_t t, bool withDate)
+{
+    char buffer[32];
+    strftime(buffer, sizeof(buffer),
+             withDate ? "[%Y-%m-%d %H:%M] " : "[%H:%M] ", gmtime(&t));
+    return buffer;
+}
+
+/**
+ * Inserts the timestamp of a line from the chat history after its color.
+ */
+static std::string formatHistoryEntry(const ChatHistory::Entry &entry,
+                                      bool withDate)
+{
+    const std::string &line = entry.line;
+    const size_t colorLength = line.compare(0, 2, "##") == 0 ? 3 : 0;
+
+    return line.substr(0, colorLength) +
+            formatTimestamp(entry.time, withDate) +
+            line.substr(std::min(colorLength, line.size()));
+}
 
 ChatTab::ChatTab(const std::string &name)
 {
@@ -207,29 +239,39 @@ void ChatTab::chatLog(std::string line, Own own, bool ignoreRecord)
     time_t t;
     time(&t);
 
-    // Format the time string properly
-    std::stringstream timeStr;
-    timeStr << std::setfill('0')
-            << "[" << std::setw(2) << (t / 3600) % 24
-            << ":" << std::setw(2) << (t / 60) % 60
-            << "] ";
+    std::optional<size_t> historyIndex;
+    if (config.enableChatHistory && chatHistory && !ignoreRecord)
+    {
+        initHistory();
+
+        const size_t index = chatHistory->size(getHistoryName());
+        chatHistory->append(getHistoryName(), t,
+                            lineColor + tmp.nick + tmp.text);
+        if (chatHistory->size(getHistoryName()) > index)
+            historyIndex = index;
+    }
 
-    line = lineColor + timeStr.str() + tmp.nick + tmp.text;
+    line = lineColor + formatTimestamp(t, false) + tmp.nick + tmp.text;
 
     if (config.enableChatLog && !ignoreRecord)
         saveToLogFile(line);
 
-    // We look if the Vertical Scroll Bar is set at the max before
-    // adding a row, otherwise the max will always be a row higher
-    // at comparison.
-    if (mScrollArea->getVerticalScrollAmount() >= mScrollArea->getVerticalMaxScroll())
+    // While older history is shown, recorded lines are paged in with the
+    // rest of the history when scrolling down
+    if (!mHistoryEnd || !historyIndex)
     {
-        mTextOutput->addRow(line);
-        mScrollArea->setVerticalScrollAmount(mScrollArea->getVerticalMaxScroll());
-    }
-    else
-    {
-        mTextOutput->addRow(line);
+        // We look if the Vertical Scroll Bar is set at the max before
+        // adding a row, otherwise the max will always be a row higher
+        // at comparison.
+        if (mScrollArea->getVerticalScrollAmount() >= mScrollArea->getVerticalMaxScroll())
+        {
+            addTextRow(line, historyIndex);
+            mScrollArea->setVerticalScrollAmount(mScrollArea->getVerticalMaxScroll());
+        }
+        else
+        {
+            addTextRow(line, historyIndex);
+        }
     }
 
     mScrollArea->logic();
@@ -312,6 +354,145 @@ void ChatTab::scroll(int amount)
 void ChatTab::clearText()
 {
     mTextOutput->clearRows();
+    mRowHistory.clear();
+
+    // Don't bring back the cleared lines until the user scrolls up
+    mHistoryAutoFill = false;
+    mHistoryEnd.reset();
+    if (chatHistory)
+        mHistoryStart = chatHistory->size(getHistoryName());
+}
+
+void ChatTab::initHistory()
+{
+    if (!mHistoryStart)
+        mHistoryStart = chatHistory->size(getHistoryName());
+}
+
+int ChatTab::addTextRow(const std::string &row,
+                        std::optional<size_t> historyIndex)
+{
+    const size_t rowCount = mTextOutput->getRowCount();
+    const int removedHeight = mTextOutput->addRow(row);
+    mRowHistory.push_back(historyIndex);
+
+    const size_t droppedRows = rowCount + 1 - mTextOutput->getRowCount();
+    if (droppedRows == 0)
+        return removedHeight;
+
+    mRowHistory.erase(mRowHistory.begin(), mRowHistory.begin() + droppedRows);
+
+    // Dropped history lines need to be paged in again when scrolling up
+    for (const auto &index : mRowHistory)
+    {
+        if (index)
+        {
+            mHistoryStart = *index;
+            break;
+        }
+    }
+
+    return removedHeight;
+}
+
+void ChatTab::pageInHistory()
+{
+    if (!config.enableChatHistory || !chatHistory)
+        return;
+
+    if (mHistoryEnd && mScrollArea->getVerticalScrollAmount() >=
+            mScrollArea->getVerticalMaxScroll())
+    {
+        pageInNewerHistory();
+        return;
+    }
+
+    // Older lines are only needed when scrolled to the top. A tab that
+    // doesn't fill its area yet is filled up with history.
+    if (mScrollArea->getVerticalScrollAmount() > 0)
+        return;
+    if (!mHistoryAutoFill && mScrollArea->getVerticalMaxScroll() == 0)
+        return;
+
+    initHistory();
+    if (*mHistoryStart == 0)
+        return;
+
+    size_t count = std::min(*mHistoryStart, HISTORY_PAGE_SIZE);
+
+    // At the row limit, the newest rows make room for the older ones
+    if (const unsigned maxRows = mTextOutput->getMaxRows())
+    {
+        count = std::min<size_t>(count, maxRows);
+
+        const size_t rowCount = mTextOutput->getRowCount();
+        if (rowCount + count > maxRows)
+        {
+            const size_t removedRows = rowCount + count - maxRows;
+            mTextOutput->removeLastRows(removedRows);
+
+            for (size_t i = 0; i < removedRows; ++i)
+            {
+                if (mRowHistory.back())
+                    mHistoryEnd = *mRowHistory.back();
+                mRowHistory.pop_back();
+            }
+        }
+    }
+
+    *mHistoryStart -= count;
+
+    const time_t today = time(nullptr) / (24 * 60 * 60);
+    std::vector<std::string> rows;
+    for (auto &entry : chatHistory->read(getHistoryName(),
+                                         *mHistoryStart, count))
+    {
+        const bool withDate = entry.time / (24 * 60 * 60) != today;
+        rows.push_back(formatHistoryEntry(entry, withDate));
+    }
+
+    for (size_t i = rows.size(); i > 0; --i)
+        mRowHistory.push_front(*mHistoryStart + i - 1);
+
+    // Keep the same lines in view
+    const int addedHeight = mTextOutput->prependRows(rows);
+    mScrollArea->logic();
+    mScrollArea->setVerticalScrollAmount(addedHeight);
+}
+
+void ChatTab::pageInNewerHistory()
+{
+    const size_t historySize = chatHistory->size(getHistoryName());
+    size_t count = std::min(historySize - std::min(*mHistoryEnd, historySize),
+                            HISTORY_PAGE_SIZE);
+    if (const unsigned maxRows = mTextOutput->getMaxRows())
+        count = std::min<size_t>(count, maxRows);
+
+    const int scrollAmount = mScrollArea->getVerticalScrollAmount();
+    const time_t today = time(nullptr) / (24 * 60 * 60);
+    int removedHeight = 0;
+    for (auto &entry : chatHistory->read(getHistoryName(),
+                                         *mHistoryEnd, count))
+    {
+        const bool withDate = entry.time / (24 * 60 * 60) != today;
+        removedHeight += addTextRow(formatHistoryEntry(entry, withDate),
+                                    (*mHistoryEnd)++);
+    }
+
+    // Once the newest line is shown, new lines are added as they come in
+    if (*mHistoryEnd >= historySize)
+        mHistoryEnd.reset();
+
+    // Keep the same lines in view
+    mScrollArea->logic();
+    mScrollArea->setVerticalScrollAmount(scrollAmount - removedHeight);
+}
+
+void ChatTab::addHistoryEntry(const ChatHistory::Entry &entry)
+{
+    addTextRow(formatHistoryEntry(entry, true));
+    mScrollArea->setVerticalScrollAmount(mScrollArea->getVerticalMaxScroll());
+    mScrollArea->logic();
 }
 
 void ChatTab::handleInput(const std::string &msg)
@@ -21,10 +21,15 @@
 
 #pragma once
 
+#include "chathistory.h"
+
 #include "gui/chatwindow.h"
 
 #include "gui/widgets/tab.h"
 
+#include <deque>
+#include <optional>
+
 class BrowserBox;
 class Recorder;
 class ScrollArea;
@@ -78,6 +83,25 @@ class ChatTab : public Tab, public AutoCompleteLister, public EventListener
          */
         void clearText();
 
+        /**
+         * Adds a page of older lines from the chat history when the tab is
+         * scrolled to the top. Once the row limit is reached, the newest
+         * rows make room and are paged in again when scrolled to the bottom.
+         */
+        void pageInHistory();
+
+        /**
+         * Adds a line from the chat history below the existing lines, for
+         * example a search result.
+         */
+        void addHistoryEntry(const ChatHistory::Entry &entry);
+
+        /**
+         * Returns the name of the channel under which the lines of this tab
+         * are kept in the chat history.
+         */
+        virtual std::string getHistoryName() const { return "#General"; }
+
         /**
          * Add any extra help text to the output. Allows tabs to define help
          * for commands defined by the tab itself.
@@ -127,8 +151,42 @@ class ChatTab : public Tab, public AutoCompleteLister, public EventListener
          */
         void updateTextFormat(int alpha);
 
+        /**
+         * Remembers the current end of the chat history, if not done yet.
+         */
+        void initHistory();
+
+        /**
+         * Adds a row to the text output, which shows the given line from
+         * the chat history, if any. Returns the height of the rows dropped
+         * at the top when the row limit is reached.
+         */
+        int addTextRow(const std::string &row,
+                       std::optional<size_t> historyIndex = {});
+
+        /**
+         * Adds the page of newer history lines below the last row, after
+         * they made room for older ones.
+         */
+        void pageInNewerHistory();
+
         ScrollArea *mScrollArea;
         BrowserBox *mTextOutput;
+
+        /** The oldest line from the chat history that has been shown. */
+        std::optional<size_t> mHistoryStart;
+
+        /**
+         * The history line following the last row, when the newest rows
+         * made room for older ones. New lines only show up once paged in.
+         */
+        std::optional<size_t> mHistoryEnd;
+
+        /** The chat history line shown by each row, if any. */
+        std::deque<std::optional<size_t>> mRowHistory;
+
+        /** Whether history may be paged in without scrolling up. */
+        bool mHistoryAutoFill = true;
         //Recorder *mRecorder;
 };
 
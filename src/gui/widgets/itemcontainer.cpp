@@ -44,6 +44,8 @@
 #include <guichan/mouseinput.hpp>
 #include <guichan/selectionlistener.hpp>
 
+#include <algorithm>
+
 ItemContainer::ItemContainer(Inventory *inventory):
     mInventory(inventory)
 {
@@ -55,14 +57,23 @@ ItemContainer::ItemContainer(Inventory *inventory):
     addKeyListener(this);
     addMouseListener(this);
     addWidgetListener(this);
+
+    mInventory->addInventoryListener(this);
 }
 
-ItemContainer::~ItemContainer() = default;
+ItemContainer::~ItemContainer()
+{
+    if (mInventory)
+        mInventory->removeInventoryListener(this);
+}
 
 void ItemContainer::logic()
 {
     gcn::Widget::logic();
 
+    if (!mInventory)
+        return;
+
     const int lastUsedSlot = mInventory->getLastUsedSlot();
 
     if (lastUsedSlot != mLastUsedSlot)
@@ -79,32 +90,6 @@ void ItemContainer::draw(gcn::Graphics *graphics)
 
     g->setFont(getFont());
 
-    mFilteredMap.clear();
-    int currentIndex = 0;
-    //Filter checking
-    for (int i = 0; i < mGridColumns; i++)
-    {
-        for (int j = 0; j < mGridRows; j++)
-        {
-            int itemIndex = j * mGridColumns + i;
-            Item *item = mInventory->getItem(itemIndex);
-            if (!item || item->getId() == 0)
-                continue;
-
-            if (!mFilter.empty())
-            {
-                if (normalize(item->getInfo().name).find(mFilter) == std::string::npos)
-                    continue;
-                mFilteredMap[currentIndex] = item;
-                currentIndex++;
-            }
-            else
-            {
-                mFilteredMap[itemIndex] = item;
-            }
-        }
-    }
-
     auto theme = gui->getTheme();
     auto &slotSkin = theme->getSkin(SkinType::ItemSlot);
     WidgetState slotState;
@@ -196,13 +181,85 @@ Item *ItemContainer::getSelectedItem() const
 
 Item *ItemContainer::getItemAt(int index) const
 {
-    auto i = mFilteredMap.find(index);
-    return i == mFilteredMap.end() ? nullptr : i->second;
+    if (!mInventory)
+        return nullptr;
+
+    Item *item;
+    if (mFilter.empty())
+    {
+        item = mInventory->getItem(index);
+    }
+    else
+    {
+        if (index < 0 || index >= static_cast<int>(mFilteredSlots.size()))
+            return nullptr;
+
+        item = mInventory->getItem(mFilteredSlots[index]);
+    }
+
+    // Slots without an item id are empty
+    return item && item->getId() != 0 ? item : nullptr;
+}
+
+bool ItemContainer::matchesFilter(const Item *item) const
+{
+    return item->getInfo().normalizedName.find(mFilter) != std::string::npos;
 }
 
 void ItemContainer::setFilter(const std::string &filter)
 {
-    mFilter = normalize(filter);
+    std::string normalized = normalize(filter);
+    if (normalized == mFilter)
+        return;
+
+    mFilter = std::move(normalized);
+    updateFilteredSlots();
+}
+
+void ItemContainer::updateFilteredSlots()
+{
+    mFilteredSlots.clear();
+
+    if (mFilter.empty() || !mInventory)
+        return;
+
+    for (int i = 0; i < mInventory->getSize(); i++)
+    {
+        const Item *item = mInventory->getItem(i);
+        if (item && item->getId() != 0 && matchesFilter(item))
+            mFilteredSlots.push_back(i);
+    }
+}
+
+void ItemContainer::slotsChanged(Inventory *inventory)
+{
+    Window::invalidateWindowOf(this);
+    updateFilteredSlots();
+}
+
+void ItemContainer::slotChanged(Inventory *inventory, int index)
+{
+    Window::invalidateWindowOf(this);
+
+    if (mFilter.empty())
+        return;
+
+    const Item *item = mInventory->getItem(index);
+    const bool matches = item && item->getId() != 0 && matchesFilter(item);
+
+    auto it = std::lower_bound(mFilteredSlots.begin(), mFilteredSlots.end(), index);
+    const bool listed = it != mFilteredSlots.end() && *it == index;
+
+    if (matches && !listed)
+        mFilteredSlots.insert(it, index);
+    else if (!matches && listed)
+        mFilteredSlots.erase(it);
+}
+
+void ItemContainer::inventoryDestroyed(Inventory *inventory)
+{
+    mInventory = nullptr;
+    mFilteredSlots.clear();
 }
 
 void ItemContainer::distributeValueChangedEvent()
@@ -264,6 +321,9 @@ void ItemContainer::keyReleased(gcn::KeyEvent &event)
 
 void ItemContainer::mousePressed(gcn::MouseEvent &event)
 {
+    if (!mInventory)
+        return;
+
     const int button = event.getButton();
 
     if (button == gcn::MouseEvent::LEFT || button == gcn::MouseEvent::RIGHT)
@@ -302,7 +362,8 @@ void ItemContainer::mousePressed(gcn::MouseEvent &event)
 
 void ItemContainer::mouseDragged(gcn::MouseEvent &event)
 {
-    if (!mDragEnabled || event.getButton() != gcn::MouseEvent::LEFT)
+    if (!mDragEnabled || !mInventory ||
+            event.getButton() != gcn::MouseEvent::LEFT)
         return;
 
     if (mSelectionStatus != SEL_NONE &&
@@ -368,7 +429,7 @@ bool ItemContainer::handleDrop(const Drag &drag, int /*absX*/, int /*absY*/)
         return false;
 
     Item *item = drag.item.get();
-    if (!item || drag.source == this)
+    if (!item || drag.source == this || !mInventory)
         return false;
 
     const auto sourceType =
@@ -426,6 +487,7 @@ bool ItemContainer::handleDrop(const Drag &drag, int /*absX*/, int /*absY*/)
 void ItemContainer::dragFinished(const Drag &drag, DragResult result)
 {
     if (result == DragResult::Ignored &&
+        mInventory &&
         mInventory->getType() == Inventory::NPC &&
         drag.source == this &&
         drag.sourceIndex >= 0 &&
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "inventory.h"
+
 #include "gui/dragndrop.h"
 
 #include <guichan/deathlistener.hpp>
@@ -30,11 +32,10 @@
 #include <guichan/widgetlistener.hpp>
 
 #include <list>
-#include <map>
 #include <memory>
+#include <vector>
 
 class Image;
-class Inventory;
 class Item;
 class ItemPopup;
 
@@ -53,7 +54,8 @@ class ItemContainer : public gcn::Widget,
                       public gcn::KeyListener,
                       public gcn::MouseListener,
                       public gcn::WidgetListener,
-                      public gcn::DeathListener
+                      public gcn::DeathListener,
+                      public InventoryListener
 {
     public:
         /**
@@ -96,6 +98,11 @@ class ItemContainer : public gcn::Widget,
         // DeathListener
         void death(const gcn::Event &event) override;
 
+        // InventoryListener
+        void slotsChanged(Inventory *inventory) override;
+        void slotChanged(Inventory *inventory, int index) override;
+        void inventoryDestroyed(Inventory *inventory) override;
+
         /**
          * Returns the selected item.
          */
@@ -186,6 +193,13 @@ class ItemContainer : public gcn::Widget,
 
         Item *getItemAt(int) const;
 
+        bool matchesFilter(const Item *item) const;
+
+        /**
+         * Collects the slots of the items that match the filter.
+         */
+        void updateFilteredSlots();
+
         static const int NO_SLOT_INDEX = -1; /**< Slot has no index. */
 
         Inventory *mInventory;
@@ -201,10 +215,14 @@ class ItemContainer : public gcn::Widget,
         bool mAcceptTradeDrops = false;
         bool mDragEnabled = true;
 
-        std::map<int, Item*> mFilteredMap;
-
         std::string mFilter;
 
+        /**
+         * The slots of the items matching the filter, in ascending order.
+         * Only used while a filter is set.
+         */
+        std::vector<int> mFilteredSlots;
+
         std::unique_ptr<ItemPopup> mItemPopup;
 
         std::list<gcn::SelectionListener *> mSelectionListeners;
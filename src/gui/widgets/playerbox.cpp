@@ -24,11 +24,27 @@
 #include "being.h"
 #include "graphics.h"
 
+#include "gui/widgets/window.h"
+
 PlayerBox::PlayerBox(const Being *being)
     : mBeing(being)
 {
 }
 
+void PlayerBox::setPlayer(const Being *being)
+{
+    mBeing = being;
+    Window::invalidateWindowOf(this);
+}
+
+void PlayerBox::logic()
+{
+    ScrollArea::logic();
+
+    if (mBeing && mBeing->getSpriteChangeCount() != mDrawnChangeCount)
+        Window::invalidateWindowOf(this);
+}
+
 void PlayerBox::draw(gcn::Graphics *graphics)
 {
     ScrollArea::draw(graphics);
@@ -39,5 +55,7 @@ void PlayerBox::draw(gcn::Graphics *graphics)
         const int x = getWidth() / 2;
         const int y = (getHeight() + mBeing->getHeight()) / 2 - 12;
         mBeing->drawSpriteAt(static_cast<Graphics*>(graphics), x, y);
+
+        mDrawnChangeCount = mBeing->getSpriteChangeCount();
     }
 }
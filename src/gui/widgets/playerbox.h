@@ -44,8 +44,12 @@ class PlayerBox : public ScrollArea
          * player to <code>NULL</code> causes the box not to draw any
          * character.
          */
-        void setPlayer(const Being *being)
-        { mBeing = being; }
+        void setPlayer(const Being *being);
+
+        /**
+         * Redraws the window when the player looks different.
+         */
+        void logic() override;
 
         /**
          * Draws the scroll area and the player.
@@ -54,4 +58,5 @@ class PlayerBox : public ScrollArea
 
     private:
         const Being *mBeing; /**< The character used for display */
+        unsigned mDrawnChangeCount = 0;
 };
@@ -24,6 +24,7 @@
 #include "graphics.h"
 
 #include "gui/gui.h"
+#include "gui/widgets/window.h"
 
 #include "resources/theme.h"
 
@@ -48,6 +49,10 @@ ProgressBar::ProgressBar(float progress,
 
 void ProgressBar::logic()
 {
+    if ((mSmoothColorChange && mColorToGo != mColor) ||
+        (mSmoothProgress && mProgressToGo != mProgress))
+        Window::invalidateWindowOf(this);
+
     if (mSmoothColorChange && mColorToGo != mColor)
     {
         // Smoothly changing the color for a nicer effect.
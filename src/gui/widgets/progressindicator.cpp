@@ -22,6 +22,7 @@
 
 #include "graphics.h"
 #include "gui/gui.h"
+#include "gui/widgets/window.h"
 #include "simpleanimation.h"
 
 #include "resources/animation.h"
@@ -49,6 +50,7 @@ ProgressIndicator::~ProgressIndicator() = default;
 void ProgressIndicator::logic()
 {
     mIndicator->update(Time::deltaTimeMs());
+    Window::invalidateWindowOf(this);
 }
 
 void ProgressIndicator::draw(gcn::Graphics *graphics)
@@ -24,6 +24,7 @@
 #include "graphics.h"
 
 #include "gui/gui.h"
+#include "gui/widgets/window.h"
 
 #include <guichan/exception.hpp>
 
@@ -120,6 +121,13 @@ void ScrollArea::logic()
         setHorizontalScrollAmount(getHorizontalScrollAmount() +
                                   mRightButtonScrollAmount);
     }
+    else
+    {
+        return;
+    }
+
+    // Scrolling while holding a button does not generate input
+    Window::invalidateWindowOf(this);
 }
 
 void ScrollArea::draw(gcn::Graphics *graphics)
@@ -40,6 +40,8 @@ class WhisperTab : public ChatTab
 
         void saveToLogFile(std::string &msg) override;
 
+        std::string getHistoryName() const override { return mNick; }
+
     protected:
         friend class ChatWindow;
 
@@ -40,6 +40,12 @@
 int Window::instances = 0;
 int Window::mouseResize = 0;
 
+/**
+ * Cached window contents are refreshed at least this often (in ms), to pick
+ * up changes that did not invalidate the window.
+ */
+static constexpr uint32_t CACHE_REFRESH_INTERVAL = 100;
+
 Window::Window(const std::string &caption, bool modal, Window *parent)
     : Window(SkinType::Window, caption, modal, parent)
 {}
@@ -101,27 +107,90 @@ void Window::setWindowContainer(WindowContainer *wc)
 }
 
 void Window::draw(gcn::Graphics *graphics)
+{
+    auto g = static_cast<Graphics*>(graphics);
+
+    if (config.cacheWindows && mCacheable)
+    {
+        drawCached(g);
+    }
+    else
+    {
+        mCache.reset();
+        drawContents(g);
+    }
+}
+
+void Window::drawCached(Graphics *graphics)
+{
+    if (!mCache || mCacheScale != graphics->getScale())
+    {
+        mCache = graphics->createRenderTarget(getWidth(), getHeight());
+        mCacheScale = graphics->getScale();
+        mCacheDirty = true;
+
+        if (!mCache)
+        {
+            drawContents(graphics);
+            return;
+        }
+    }
+
+    if (mCacheDirty || mCacheRefreshTimer.passed())
+    {
+        // Cleared before drawing, so widgets can request another redraw
+        mCacheDirty = false;
+        mCacheRefreshTimer.set(CACHE_REFRESH_INTERVAL);
+
+        graphics->beginRenderToTarget(mCache.get(), getWidth(), getHeight());
+        drawContents(graphics);
+        graphics->endRenderToTarget();
+    }
+
+    graphics->drawRenderTarget(mCache.get(), 0, 0, getWidth(), getHeight());
+}
+
+void Window::drawContents(Graphics *graphics)
 {
     if (getFrameSize() == 0)
         drawFrame(graphics);
 
-    auto g = static_cast<Graphics*>(graphics);
-
     if (mCloseButton)
     {
         WidgetState state(getCloseButtonRect(), mCloseButtonHovered ? STATE_HOVERED : 0);
-        gui->getTheme()->drawSkin(g, SkinType::ButtonClose, state);
+        gui->getTheme()->drawSkin(graphics, SkinType::ButtonClose, state);
     }
 
     if (mStickyButton)
     {
         WidgetState state(getStickyButtonRect(), mSticky ? STATE_SELECTED : 0);
-        gui->getTheme()->drawSkin(g, SkinType::ButtonSticky, state);
+        gui->getTheme()->drawSkin(graphics, SkinType::ButtonSticky, state);
     }
 
     drawChildren(graphics);
 }
 
+void Window::invalidateWindowOf(gcn::Widget *widget)
+{
+    while (widget)
+    {
+        if (auto window = dynamic_cast<Window*>(widget))
+        {
+            window->invalidate();
+            return;
+        }
+
+        widget = widget->getParent();
+    }
+}
+
+void Window::setCacheable(bool cacheable)
+{
+    mCacheable = cacheable;
+    mCache.reset();
+    mCacheDirty = true;
+}
+
 void Window::drawFrame(gcn::Graphics *graphics)
 {
     auto g = static_cast<Graphics*>(graphics);
@@ -231,6 +300,8 @@ void Window::setResizable(bool r)
 
 void Window::widgetResized(const gcn::Event &event)
 {
+    mCache.reset();
+
     const gcn::Rectangle area = getChildrenArea();
 
     if (mGrip)
@@ -25,9 +25,13 @@
 
 #include "resources/theme.h"
 
+#include "utils/time.h"
+
 #include <guichan/widgetlistener.hpp>
 #include <guichan/widgets/window.hpp>
 
+#include <memory>
+
 class ContainerPlacer;
 class Layout;
 class LayoutCell;
@@ -90,10 +94,29 @@ class Window : public gcn::Window, gcn::WidgetListener
         static void setWindowContainer(WindowContainer *windowContainer);
 
         /**
-         * Draws the window contents.
+         * Draws the window contents. When window caching is enabled, the
+         * contents are drawn from a cached image, which is only redrawn when
+         * the window has been invalidated.
          */
         void draw(gcn::Graphics *graphics) override;
 
+        /**
+         * Marks the cached contents of this window as outdated, so they get
+         * redrawn on the next frame.
+         */
+        void invalidate() { mCacheDirty = true; }
+
+        /**
+         * Invalidates the window containing the given widget, if any.
+         */
+        static void invalidateWindowOf(gcn::Widget *widget);
+
+        /**
+         * Sets whether the contents of this window may be cached. Should be
+         * disabled for windows with contents that change every frame.
+         */
+        void setCacheable(bool cacheable);
+
         /**
          * Draws the window frame.
          */
@@ -406,6 +429,9 @@ class Window : public gcn::Window, gcn::WidgetListener
          */
         int getResizeHandles(gcn::MouseEvent &event);
 
+        void drawCached(Graphics *graphics);
+        void drawContents(Graphics *graphics);
+
         gcn::Rectangle getCloseButtonRect() const;
         gcn::Rectangle getStickyButtonRect() const;
 
@@ -430,6 +456,11 @@ class Window : public gcn::Window, gcn::WidgetListener
         int mDefaultY;                /**< Default window Y position */
         int mDefaultWidth;            /**< Default window width */
         int mDefaultHeight;           /**< Default window height */
+        std::unique_ptr<Image> mCache;  /**< Cached window contents */
+        float mCacheScale = 0.0f;     /**< Graphics scale of the cache */
+        bool mCacheable = true;       /**< Window contents may be cached */
+        bool mCacheDirty = true;      /**< Cache needs to be redrawn */
+        Timer mCacheRefreshTimer;     /**< Forces a periodic cache refresh */
 
         static int instances;         /**< Number of Window instances */
 };
@@ -58,6 +58,13 @@ void WindowContainer::adjustAfterResize(int oldScreenWidth,
             window->adjustPositionAfterResize(oldScreenWidth, oldScreenHeight);
 }
 
+void WindowContainer::invalidateWindows()
+{
+    for (auto &widget : mWidgets)
+        if (auto *window = dynamic_cast<Window*>(widget))
+            window->invalidate();
+}
+
 void WindowContainer::debugDraw(gcn::Graphics *graphics)
 {
     auto focusHandler = _getFocusHandler();
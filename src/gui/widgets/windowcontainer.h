@@ -57,6 +57,11 @@ class WindowContainer : public Container
          */
         void adjustAfterResize(int oldScreenWidth, int oldScreenHeight);
 
+        /**
+         * Invalidates the cached contents of all windows.
+         */
+        void invalidateWindows();
+
     private:
         /**
          * Draws the outlines of the container and all its children.
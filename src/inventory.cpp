@@ -52,7 +52,13 @@ void Inventory::setSize(int size)
     distributeSlotsChangedEvent();
 }
 
-Inventory::~Inventory() = default;
+Inventory::~Inventory()
+{
+    // Copied, since listeners may remove themselves
+    const auto listeners = mInventoryListeners;
+    for (auto inventoryListener : listeners)
+        inventoryListener->inventoryDestroyed(this);
+}
 
 Item *Inventory::getItem(int index) const
 {
@@ -92,13 +98,13 @@ void Inventory::setItem(int index, int id, int quantity)
             item->setInvIndex(index);
             mItems[index] = std::move(item);
             mUsed++;
-            distributeSlotsChangedEvent();
         }
         else
         {
             mItems[index]->setId(id);
             mItems[index]->setQuantity(quantity);
         }
+        distributeSlotChangedEvent(index);
     }
     else if (mItems[index])
     {
@@ -122,7 +128,7 @@ void Inventory::removeItemAt(int index)
     mItems[index] = nullptr;
     if (mUsed > 0) {
         mUsed--;
-        distributeSlotsChangedEvent();
+        distributeSlotChangedEvent(index);
     }
 }
 
@@ -168,3 +174,9 @@ void Inventory::distributeSlotsChangedEvent()
     for (auto inventoryListener : mInventoryListeners)
         inventoryListener->slotsChanged(this);
 }
+
+void Inventory::distributeSlotChangedEvent(int index)
+{
+    for (auto inventoryListener : mInventoryListeners)
+        inventoryListener->slotChanged(this, index);
+}
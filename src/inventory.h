@@ -35,6 +35,18 @@ public:
 
     virtual void slotsChanged(Inventory* inventory) = 0;
 
+    /**
+     * Called when the item in a single slot was added, removed or changed.
+     * By default this is handled like a change of all slots.
+     */
+    virtual void slotChanged(Inventory *inventory, int index)
+    { slotsChanged(inventory); }
+
+    /**
+     * Called when the inventory is about to be deleted.
+     */
+    virtual void inventoryDestroyed(Inventory *inventory) {}
+
 protected:
     InventoryListener() {}
 };
@@ -142,6 +154,7 @@ class Inventory
         std::list<InventoryListener *> mInventoryListeners;
 
         void distributeSlotsChangedEvent();
+        void distributeSlotChangedEvent(int index);
 
         Type mType;
         std::vector<std::unique_ptr<Item>> mItems;  /**< The holder of items */
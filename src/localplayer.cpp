@@ -53,6 +53,9 @@ constexpr unsigned AWAY_MESSAGE_TIMEOUT = 60 * 1000;
 // Actions are allowed at 5.5 per second
 constexpr unsigned ACTION_TIMEOUT = 182;
 
+// Walk requests remembered to match them with the answers of the server
+constexpr size_t MAX_PENDING_WALKS = 16;
+
 LocalPlayer *local_player = nullptr;
 
 LocalPlayer::LocalPlayer(int id, int subtype)
@@ -684,8 +687,51 @@ void LocalPlayer::setDestination(int x, int y)
         // If the destination given to being class is accepted,
         // we inform the Server.
         if (srcX == dstX && srcY == dstY)
-            Net::getPlayerHandler()->setDestination(x, y, mDirection);
+            sendDestination(x, y, mDirection);
+    }
+}
+
+void LocalPlayer::sendDestination(int x, int y, int direction)
+{
+    Net::getPlayerHandler()->setDestination(x, y, direction);
+
+    // Not all servers answer walk requests, so only keep the recent ones
+    mPendingWalks.push_back({ Vector(x, y), Time::absoluteTimeMs() });
+    if (mPendingWalks.size() > MAX_PENDING_WALKS)
+        mPendingWalks.pop_front();
+}
+
+void LocalPlayer::confirmWalk(const Vector &src, const Vector &dst)
+{
+    if (!mMap)
+        return;
+
+    const int tileWidth = mMap->getTileWidth();
+    const int tileHeight = mMap->getTileHeight();
+    const int dstTileX = (int) dst.x / tileWidth;
+    const int dstTileY = (int) dst.y / tileHeight;
+
+    // Requests are answered in order, so any earlier ones were superseded
+    while (!mPendingWalks.empty())
+    {
+        const PendingWalk walk = mPendingWalks.front();
+        mPendingWalks.pop_front();
+
+        if ((int) walk.destination.x / tileWidth == dstTileX &&
+                (int) walk.destination.y / tileHeight == dstTileY)
+        {
+            const int sample = Time::absoluteTimeMs() - walk.sentAt;
+            mRoundTripTime = mRoundTripTime ? (mRoundTripTime * 7 + sample) / 8
+                                            : sample;
+
+            // The prediction was right
+            return;
+        }
     }
+
+    // The server chose another destination, for example because the way
+    // was blocked. It started walking about half a round trip ago.
+    reconcileMovement(src, dst, mRoundTripTime / 2);
 }
 
 void LocalPlayer::setWalkingDir(int dir)
@@ -761,8 +807,7 @@ void LocalPlayer::stopWalking(bool sendToServer)
 
         setDestination((int) getPosition().x, (int) getPosition().y);
         if (sendToServer)
-             Net::getPlayerHandler()->setDestination((int) getPosition().x,
-                                                     (int) getPosition().y);
+            sendDestination((int) getPosition().x, (int) getPosition().y);
         setAction(STAND);
     }
 
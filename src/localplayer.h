@@ -30,6 +30,7 @@
 #include <guichan/actionlistener.hpp>
 #include <guichan/deathlistener.hpp>
 
+#include <deque>
 #include <memory>
 
 class ChatTab;
@@ -130,6 +131,20 @@ class LocalPlayer final : public Being
         virtual void setDestination(const Position &dest)
         { setDestination(dest.x, dest.y); }
 
+        /**
+         * Called when the server accepted a walk from \a src to \a dst. The
+         * player already walks before the server answers, so this only
+         * corrects the player when the server chose a different destination.
+         */
+        void confirmWalk(const Vector &src, const Vector &dst);
+
+        /**
+         * Returns the estimated time in milliseconds between sending a walk
+         * request and receiving the answer, or 0 when unknown.
+         */
+        int getRoundTripTime() const
+        { return mRoundTripTime; }
+
         /**
          * Sets a new direction to keep walking in, when using the keyboard
          * or the joystick.
@@ -217,6 +232,18 @@ class LocalPlayer final : public Being
 
         void pathFinished() override { nextTile(mWalkingDir); }
 
+        /**
+         * Sends a walk request to the server, remembering it until it is
+         * answered.
+         */
+        void sendDestination(int x, int y, int direction = -1);
+
+        struct PendingWalk
+        {
+            Vector destination;
+            uint32_t sentAt;
+        };
+
         int mAttackRange = -1;
 
         Timer mLastTargetTimer; /**< Timer for last targeting action. */
@@ -233,6 +260,9 @@ class LocalPlayer final : public Being
         int mWalkingDir = 0;            /**< The direction the player is walking in. */
         bool mPathSetByMouse = false;   /**< Tells if the path was set using mouse */
 
+        std::deque<PendingWalk> mPendingWalks;  /**< Unanswered walk requests */
+        int mRoundTripTime = 0;
+
         /** Queued messages */
         std::list<std::pair<std::string, int>> mMessages;
         Timer mMessageTimer;
@@ -21,17 +21,318 @@
 
 #include "log.h"
 
+#include "utils/mutex.h"
+
 #include <SDL.h>
 
+#include <atomic>
+#include <csignal>
 #include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <map>
+#include <vector>
 #include <sys/time.h>
 
-static std::ofstream logFile;
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Writes log output on a background thread, so that slow disks do not stall
+ * the main loop. Text is queued and written in batches, with files being kept
+ * open between batches. An empty path refers to the standard output.
+ */
+class LogWriter
+{
+public:
+    LogWriter();
+
+    /**
+     * Truncates the given file, before writing any further text to it.
+     */
+    void truncate(const std::string &path);
+    void write(const std::string &path, std::string text);
+    void close(const std::string &path);
+
+    /**
+     * Waits until all queued text has been written, or the timeout passed.
+     */
+    void flush(uint32_t timeoutMs);
+
+    /**
+     * Returns whether all queued text has been written. Safe to call from
+     * a signal handler.
+     */
+    bool isDrained() const { return mDrained; }
+
+    /**
+     * Writes all queued text and stops the writer thread. Any text written
+     * afterwards is written immediately.
+     */
+    void stop();
+
+private:
+    enum class Action
+    {
+        Truncate,
+        Write,
+        Close
+    };
+
+    struct Entry
+    {
+        Action action;
+        std::string path;
+        std::string text;
+    };
+
+    struct File
+    {
+        std::ofstream stream;
+        unsigned lastUse = 0;
+        bool dirty = false;
+    };
+
+    static int writerThread(void *data);
+
+    void push(Entry entry);
+    void process(std::vector<Entry> &entries);
+    File *getFile(const std::string &path, bool truncate);
+
+    // Accessed only by the writing thread
+    std::map<std::string, File> mFiles;
+    unsigned mUseCounter = 0;
+
+    Mutex mMutex;
+    Condition mWakeUp;
+    Condition mIdle;
+    std::vector<Entry> mQueue;
+    SDL_Thread *mThread = nullptr;
+    bool mBusy = false;
+    bool mQuit = false;
+
+    // Read by the crash handler, which can't lock the mutex
+    std::atomic<bool> mDrained { true };
+    static_assert(std::atomic<bool>::is_always_lock_free);
+};
+
+/**
+ * The maximum number of files kept open by the log writer. When more files
+ * are written to, the least recently used one is closed.
+ */
+static constexpr size_t MAX_OPEN_FILES = 32;
+
+// Never deleted, so that logging keeps working during shutdown
+static LogWriter *logWriter;
+static std::string logFileName;
 static bool logToStandardOut = true;
 
+static Mutex rateMutex;
+static unsigned rateLimit = 0;
+static uint32_t rateWindowStart = 0;
+static unsigned rateWindowLines = 0;
+static unsigned suppressedLines = 0;
+
+LogWriter::LogWriter()
+{
+    mThread = SDL_CreateThread(writerThread, "LogWriter", this);
+}
+
+void LogWriter::truncate(const std::string &path)
+{
+    push({ Action::Truncate, path, std::string() });
+}
+
+void LogWriter::write(const std::string &path, std::string text)
+{
+    push({ Action::Write, path, std::move(text) });
+}
+
+void LogWriter::close(const std::string &path)
+{
+    push({ Action::Close, path, std::string() });
+}
+
+void LogWriter::flush(uint32_t timeoutMs)
+{
+    MutexLocker lock(&mMutex);
+
+    const uint32_t start = SDL_GetTicks();
+    while (mThread && (!mQueue.empty() || mBusy))
+    {
+        const uint32_t elapsed = SDL_GetTicks() - start;
+        if (elapsed >= timeoutMs || !mIdle.wait(mMutex, timeoutMs - elapsed))
+            break;
+    }
+}
+
+void LogWriter::stop()
+{
+    SDL_Thread *thread;
+    {
+        MutexLocker lock(&mMutex);
+        thread = mThread;
+        mQuit = true;
+        mWakeUp.signal();
+    }
+
+    if (thread)
+        SDL_WaitThread(thread, nullptr);
+
+    MutexLocker lock(&mMutex);
+    mThread = nullptr;
+    process(mQueue);
+    mQueue.clear();
+}
+
+int LogWriter::writerThread(void *data)
+{
+    auto writer = static_cast<LogWriter*>(data);
+    std::vector<Entry> batch;
+
+    while (true)
+    {
+        {
+            MutexLocker lock(&writer->mMutex);
+            writer->mBusy = false;
+
+            if (writer->mQueue.empty())
+            {
+                writer->mDrained = true;
+                writer->mIdle.broadcast();
+            }
+
+            while (writer->mQueue.empty() && !writer->mQuit)
+                writer->mWakeUp.wait(writer->mMutex);
+
+            if (writer->mQueue.empty())
+                break;
+
+            batch.swap(writer->mQueue);
+            writer->mBusy = true;
+        }
+
+        writer->process(batch);
+        batch.clear();
+    }
+
+    return 0;
+}
+
+void LogWriter::push(Entry entry)
+{
+    MutexLocker lock(&mMutex);
+
+    // Without writer thread, write the text immediately
+    if (!mThread)
+    {
+        std::vector<Entry> entries;
+        entries.push_back(std::move(entry));
+        process(entries);
+        return;
+    }
+
+    // The writer only needs waking up when it has run out of work
+    if (mQueue.empty())
+        mWakeUp.signal();
+
+    mQueue.push_back(std::move(entry));
+    mDrained = false;
+}
+
+void LogWriter::process(std::vector<Entry> &entries)
+{
+    bool standardOutDirty = false;
+
+    for (auto &entry : entries)
+    {
+        if (entry.path.empty())
+        {
+            std::cout << entry.text;
+            standardOutDirty = true;
+            continue;
+        }
+
+        switch (entry.action)
+        {
+        case Action::Truncate:
+            getFile(entry.path, true);
+            break;
+        case Action::Write:
+            if (File *file = getFile(entry.path, false))
+            {
+                file->stream << entry.text;
+                file->dirty = true;
+            }
+            break;
+        case Action::Close:
+            mFiles.erase(entry.path);
+            break;
+        }
+    }
+
+    // Flush once per batch rather than once per line
+    for (auto &[_, file] : mFiles)
+    {
+        if (file.dirty)
+        {
+            file.stream.flush();
+            file.dirty = false;
+        }
+    }
+
+    if (standardOutDirty)
+        std::cout.flush();
+}
+
+LogWriter::File *LogWriter::getFile(const std::string &path, bool truncate)
+{
+    auto it = mFiles.find(path);
+
+    if (it != mFiles.end() && truncate)
+    {
+        mFiles.erase(it);
+        it = mFiles.end();
+    }
+
+    if (it == mFiles.end())
+    {
+        if (mFiles.size() >= MAX_OPEN_FILES)
+        {
+            auto leastRecent = mFiles.begin();
+            for (auto i = mFiles.begin(); i != mFiles.end(); ++i)
+                if (i->second.lastUse < leastRecent->second.lastUse)
+                    leastRecent = i;
+            mFiles.erase(leastRecent);
+        }
+
+        File &file = mFiles[path];
+        file.stream.open(path, truncate ? std::ios_base::trunc
+                                        : std::ios_base::app);
+
+        if (!file.stream.is_open())
+        {
+            std::cout << "Warning: error while opening " << path
+                      << " for writing.\n";
+            mFiles.erase(path);
+            return nullptr;
+        }
+
+        it = mFiles.find(path);
+    }
+
+    it->second.lastUse = ++mUseCounter;
+    return &it->second;
+}
+
+
 static const char *getLogPriorityPrefix(SDL_LogPriority priority)
 {
     switch (priority) {
@@ -46,55 +347,139 @@ static const char *getLogPriorityPrefix(SDL_LogPriority priority)
     }
 }
 
+/**
+ * Returns whether a message of the given priority should be logged, given
+ * the rate limit. Sets \a suppressed to the number of dropped lines, when a
+ * new second has started after lines were dropped.
+ */
+static bool checkRateLimit(SDL_LogPriority priority, unsigned &suppressed)
+{
+    MutexLocker lock(&rateMutex);
+
+    suppressed = 0;
+    if (rateLimit == 0)
+        return true;
+
+    const uint32_t now = SDL_GetTicks();
+    if (now - rateWindowStart >= 1000)
+    {
+        rateWindowStart = now;
+        rateWindowLines = 0;
+        suppressed = suppressedLines;
+        suppressedLines = 0;
+    }
+
+    if (++rateWindowLines <= rateLimit || priority >= SDL_LOG_PRIORITY_WARN)
+        return true;
+
+    ++suppressedLines;
+    return false;
+}
+
+static void writeLine(const std::string &line)
+{
+    if (logToStandardOut)
+        logWriter->write(std::string(), line);
+
+    if (!logFileName.empty())
+        logWriter->write(logFileName, line);
+}
+
 static void logOutputFunction(void *userdata, int category, SDL_LogPriority priority, const char *message)
 {
+    unsigned suppressed;
+    const bool allowed = checkRateLimit(priority, suppressed);
+
     // Get the current system time
     timeval tv;
     gettimeofday(&tv, nullptr);
 
     // Create timestamp string
-    std::stringstream timeStr;
-    timeStr << "["
-        << ((((tv.tv_sec / 60) / 60) % 24 < 10) ? "0" : "")
-        << (int)(((tv.tv_sec / 60) / 60) % 24)
-        << ":"
-        << (((tv.tv_sec / 60) % 60 < 10) ? "0" : "")
-        << (int)((tv.tv_sec / 60) % 60)
-        << ":"
-        << ((tv.tv_sec % 60 < 10) ? "0" : "")
-        << (int)(tv.tv_sec % 60)
-        << "."
-        << (((tv.tv_usec / 10000) % 100) < 10 ? "0" : "")
-        << (int)((tv.tv_usec / 10000) % 100)
-        << "] ";
-
-    const char *prefix = getLogPriorityPrefix(priority);
+    char timeStr[16];
+    snprintf(timeStr, sizeof(timeStr), "[%02d:%02d:%02d.%02d] ",
+             (int)(((tv.tv_sec / 60) / 60) % 24),
+             (int)((tv.tv_sec / 60) % 60),
+             (int)(tv.tv_sec % 60),
+             (int)((tv.tv_usec / 10000) % 100));
 
-    if (logToStandardOut)
+    if (suppressed > 0)
     {
-        std::cout << timeStr.str() << prefix << message << std::endl;
+        char notice[64];
+        snprintf(notice, sizeof(notice),
+                 "Warning: %u log messages were dropped\n", suppressed);
+        writeLine(timeStr + std::string(notice));
     }
 
-    if (logFile.is_open())
+    if (!allowed)
+        return;
+
+    std::string line = timeStr;
+    line += getLogPriorityPrefix(priority);
+    line += message;
+    line += '\n';
+    writeLine(line);
+}
+
+static volatile sig_atomic_t crashing = 0;
+
+/**
+ * Gives the writer thread up to a second to write out pending log output
+ * when crashing, before handing the signal to the default handler.
+ *
+ * Only async-signal-safe functions may be used here, so the handler can't
+ * lock the writer or wait on its condition.
+ */
+static void crashHandler(int signal)
+{
+    if (!crashing)
     {
-        logFile << timeStr.str() << prefix << message << std::endl;
+        crashing = 1;
+
+        for (int i = 0; i < 100 && !logWriter->isDrained(); ++i)
+        {
+#ifdef _WIN32
+            Sleep(10);
+#else
+            const timespec delay = { 0, 10 * 1000 * 1000 };
+            nanosleep(&delay, nullptr);
+#endif
+        }
+
+        if (!logWriter->isDrained())
+        {
+            static const char message[] = "Crashed before all log output "
+                                          "could be written.\n";
+            [[maybe_unused]] const auto written =
+                    write(2, message, sizeof(message) - 1);
+        }
     }
+
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+static void stopLogWriter()
+{
+    logWriter->stop();
 }
 
 void Log::init()
 {
+    logWriter = new LogWriter;
+
+    std::atexit(stopLogWriter);
+    std::signal(SIGSEGV, crashHandler);
+    std::signal(SIGABRT, crashHandler);
+    std::signal(SIGFPE, crashHandler);
+    std::signal(SIGILL, crashHandler);
+
     SDL_LogSetOutputFunction(logOutputFunction, nullptr);
 }
 
 void Log::setLogFile(const std::string &logFilename)
 {
-    logFile.open(logFilename, std::ios_base::trunc);
-
-    if (!logFile.is_open())
-    {
-        std::cout << "Warning: error while opening " << logFilename
-                  << " for writing.\n";
-    }
+    logFileName = logFilename;
+    logWriter->truncate(logFilename);
 }
 
 void Log::setLogToStandardOut(bool value)
@@ -102,6 +487,27 @@ void Log::setLogToStandardOut(bool value)
     logToStandardOut = value;
 }
 
+void Log::setRateLimit(unsigned linesPerSecond)
+{
+    MutexLocker lock(&rateMutex);
+    rateLimit = linesPerSecond;
+}
+
+void Log::writeToFile(const std::string &path, std::string text)
+{
+    logWriter->write(path, std::move(text));
+}
+
+void Log::closeFile(const std::string &path)
+{
+    logWriter->close(path);
+}
+
+void Log::flush()
+{
+    logWriter->flush(SDL_MAX_UINT32);
+}
+
 #define DEFINE_LOG_FUNCTION(name, priority) \
     void Log::name(const char *fmt, ...) \
     { \
@@ -133,6 +539,8 @@ void Log::critical(const std::string &message)
         std::cerr << getLogPriorityPrefix(SDL_LOG_PRIORITY_CRITICAL) << message << std::endl;
     }
 
+    Log::flush();
+
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", message.c_str(), nullptr);
     exit(1);
 }
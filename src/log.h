@@ -51,6 +51,28 @@ namespace Log
      */
     void setLogToStandardOut(bool value);
 
+    /**
+     * Sets the maximum amount of lines per second to write to the log, or 0
+     * for no limit. Warnings and errors are never dropped.
+     */
+    void setRateLimit(unsigned linesPerSecond);
+
+    /**
+     * Appends text to the given file. Writing happens on a background
+     * thread, which keeps the file open until closeFile is called.
+     */
+    void writeToFile(const std::string &path, std::string text);
+
+    /**
+     * Closes the given file, after any pending text has been written.
+     */
+    void closeFile(const std::string &path);
+
+    /**
+     * Blocks until all pending log output has been written.
+     */
+    void flush();
+
     void verbose(const char *log_text, ...) LOG_PRINTF_ATTR;
     void debug(const char *log_text, ...) LOG_PRINTF_ATTR;
     void info(const char *log_text, ...) LOG_PRINTF_ATTR;
@@ -72,6 +72,13 @@ static void printHelp()
         << _("     --chat-log-dir   : Chat log dir to use") << endl
         << _("     --screenshot-dir : Directory to store screenshots") << endl
         << _("  -l --log-file       : Log file path, or '-' for stdout") << endl
+        << _("     --capture-packets : Record received network traffic to "
+                                     "this file") << endl
+        << _("     --replay-packets : Replay network traffic from this file "
+                                     "instead of connecting") << endl
+        << _("     --replay-real-time : Replay with the recorded timing") << endl
+        << _("     --startup-trace  : Print how long the startup stages take")
+        << endl
 #ifdef USE_OPENGL
         << _("     --no-opengl      : Disable OpenGL for this session") << endl
 #endif
@@ -106,6 +113,10 @@ static void parseOptions(int argc, char *argv[], Client::Options &options)
         { "screenshot-dir", required_argument, nullptr, 'i' },
         { "server-type",    required_argument, nullptr, 'y' },
         { "log-file",       required_argument, nullptr, 'l' },
+        { "capture-packets", required_argument, nullptr, 'K' },
+        { "replay-packets", required_argument, nullptr, 'R' },
+        { "replay-real-time", no_argument,     nullptr, 'Q' },
+        { "startup-trace",  no_argument,       nullptr, 'S' },
         { nullptr }
     };
 
@@ -173,6 +184,18 @@ static void parseOptions(int argc, char *argv[], Client::Options &options)
             case 'l':
                 options.logFile = optarg;
                 break;
+            case 'K':
+                options.capturePackets = optarg;
+                break;
+            case 'R':
+                options.replayPackets = optarg;
+                break;
+            case 'Q':
+                options.replayRealTime = true;
+                break;
+            case 'S':
+                options.startupTrace = true;
+                break;
             case 'y':
                 options.serverType = ServerInfo::parseType(optarg);
                 if (options.serverType == ServerType::Unknown)
@@ -44,16 +44,29 @@
 #include <cassert>
 #include <climits>
 #include <cstdlib>
-#include <cstring>
-#include <queue>
+
+/**
+ * Distance in pixels beyond the screen edges within which actors are still
+ * considered for drawing.
+ */
+static constexpr int ACTOR_CULL_MARGIN = 512;
+
+/**
+ * The blockmask bit matching each block type.
+ */
+static constexpr unsigned char BLOCKTYPE_MASKS[Map::NB_BLOCKTYPES] = {
+    Map::BLOCKMASK_WALL,
+    Map::BLOCKMASK_CHARACTER,
+    Map::BLOCKMASK_MONSTER,
+};
 
 /**
  * A location on a tile map. Used for pathfinding, open list.
  */
 struct Location
 {
-    Location(int px, int py, MetaTile *ptile):
-        x(px), y(py), tile(ptile)
+    Location(int px, int py, int fCost):
+        x(px), y(py), Fcost(fCost)
     {}
 
     /**
@@ -61,32 +74,45 @@ struct Location
      */
     bool operator< (const Location &loc) const
     {
-        return tile->Fcost > loc.tile->Fcost;
+        return Fcost > loc.Fcost;
     }
 
     int x, y;
-    MetaTile *tile;
+    int Fcost;  /**< Estimation of total path cost */
 };
 
-TileAnimation::TileAnimation(Animation animation)
-    : mAnimation(std::move(animation))
-{
-}
-
-void TileAnimation::update(int dt)
+/**
+ * Pathfinding state for each tile, kept in parallel arrays that are shared by
+ * all maps and reused between searches. A tile is only on the open or closed
+ * list when its list value matches that of the current search, so the arrays
+ * don't need to be cleared between searches.
+ */
+struct PathfindingScratch
 {
-    mAnimation.update(dt);
-
-    // exchange images
-    Image *img = mAnimation.getCurrentImage();
-    if (img != mLastImage)
+    void reserve(size_t size)
     {
-        for (auto &[layer, index] : mAffected)
-        {
-            layer->setTile(index, img);
-        }
-        mLastImage = img;
+        if (list.size() >= size)
+            return;
+
+        Gcost.resize(size);
+        parent.resize(size);
+        list.resize(size, 0);
     }
+
+    std::vector<int> Gcost;         /**< Cost from start to this location */
+    std::vector<int> parent;        /**< Tile index of the parent tile */
+    std::vector<unsigned> list;     /**< No list, open list or closed list */
+    std::vector<Location> openList; /**< Heap of open tiles sorted on F cost */
+
+    unsigned onClosedList = 1;
+    unsigned onOpenList = 2;
+};
+
+static PathfindingScratch pathScratch;
+
+TileAnimation::TileAnimation(Animation animation)
+    : mAnimation(std::move(animation))
+{
 }
 
 MapLayer::MapLayer(int x, int y, int width, int height, bool isFringeLayer,
@@ -104,6 +130,7 @@ MapLayer::MapLayer(int x, int y, int width, int height, bool isFringeLayer,
 MapLayer::~MapLayer()
 {
     delete[] mTiles;
+    delete[] mAnimations;
 }
 
 void MapLayer::setTile(int x, int y, Image *img)
@@ -111,6 +138,18 @@ void MapLayer::setTile(int x, int y, Image *img)
     setTile(x + y * mWidth, img);
 }
 
+void MapLayer::setAnimation(int x, int y, const TileAnimation *animation)
+{
+    if (!mAnimations)
+    {
+        const int size = mWidth * mHeight;
+        mAnimations = new const TileAnimation*[size];
+        std::fill_n(mAnimations, size, nullptr);
+    }
+
+    mAnimations[x + y * mWidth] = animation;
+}
+
 void MapLayer::draw(Graphics *graphics,
                     int startX, int startY,
                     int endX, int endY,
@@ -215,28 +254,15 @@ Map::Map(int width, int height, int tileWidth, int tileHeight):
     mTileWidth(tileWidth), mTileHeight(tileHeight),
     mMaxTileHeight(tileHeight),
     mMaxTileWidth(tileWidth),
+    mBlockWordsPerRow((width + 63) / 64),
     mDebugFlags(DEBUG_NONE),
-    mOnClosedList(1), mOnOpenList(2),
     mLastScrollX(0.0f), mLastScrollY(0.0f)
 {
-    const int size = mWidth * mHeight;
-
-    mMetaTiles = new MetaTile[size];
-    for (auto &occupation : mOccupation)
-    {
-        occupation = new unsigned[size];
-        memset(occupation, 0, size * sizeof(unsigned));
-    }
 }
 
 Map::~Map()
 {
-    // delete metadata, layers, tilesets and overlays
-    delete[] mMetaTiles;
-    for (auto &occupation : mOccupation)
-    {
-        delete[] occupation;
-    }
+    // delete layers, tilesets and overlays
     delete_all(mLayers);
     delete_all(mTilesets);
 }
@@ -301,10 +327,24 @@ void Map::addTileset(Tileset *tileset)
 
 void Map::update(int dt)
 {
-    // Update animated tiles
-    for (auto &[_, tileAnimation] : mTileAnimations)
+    mAnimationTime += dt;
+
+    // Advance only the tile animations that are due for a frame change
+    while (!mAnimationQueue.empty() &&
+           mAnimationQueue.top().first < mAnimationTime)
     {
-        tileAnimation.update(dt);
+        TileAnimationTimer *timer = mAnimationQueue.top().second;
+        mAnimationQueue.pop();
+
+        timer->phase = (timer->phase + 1) % timer->delays.size();
+
+        // A frame without delay ends the animation
+        const int delay = timer->delays[timer->phase];
+        if (delay > 0)
+        {
+            timer->nextChange += delay;
+            mAnimationQueue.emplace(timer->nextChange, timer);
+        }
     }
 }
 
@@ -320,9 +360,9 @@ void Map::draw(Graphics *graphics, int scrollX, int scrollY)
 
     // Make sure actors are sorted ascending by Y-coordinate
     // so that they overlap correctly
-    mActors.sort([] (const Actor *a, const Actor *b) {
-        return a->getDrawOrder() < b->getDrawOrder();
-    });
+    updateVisibleActors(scrollX, scrollY,
+                        scrollX + graphics->getWidth(),
+                        scrollY + graphics->getHeight());
 
     // update scrolling of all ambient layers
     updateAmbientLayers(scrollX, scrollY);
@@ -343,7 +383,7 @@ void Map::draw(Graphics *graphics, int scrollX, int scrollY)
         layer->draw(graphics,
                     startX, startY, endX, endY,
                     scrollX, scrollY,
-                    mActors, mDebugFlags);
+                    mVisibleActors, mDebugFlags);
 
         if (layer->isFringeLayer() && (mDebugFlags & (DEBUG_SPECIAL2 |
                                                       DEBUG_SPECIAL3)))
@@ -355,7 +395,7 @@ void Map::draw(Graphics *graphics, int scrollX, int scrollY)
     {
         // We draw beings with a lower opacity to make them visible
         // even when covered by a wall or some other elements...
-        for (auto actor : mActors)
+        for (auto actor : mVisibleActors)
         {
             // For now, just draw actors with only one layer.
             if (actor->drawnWhenBehind())
@@ -518,28 +558,11 @@ void Map::blockTile(int x, int y, BlockType type)
     if (type == BLOCKTYPE_NONE || !contains(x, y))
         return;
 
-    const int tileNum = x + y * mWidth;
+    auto &layer = mBlockLayers[type];
+    if (layer.empty())
+        layer.resize(mBlockWordsPerRow * mHeight, 0);
 
-    if (mOccupation[type][tileNum] == UINT_MAX)
-        return;
-
-    ++mOccupation[type][tileNum];
-
-    switch (type)
-    {
-        case BLOCKTYPE_WALL:
-            mMetaTiles[tileNum].blockmask |= BLOCKMASK_WALL;
-            break;
-        case BLOCKTYPE_CHARACTER:
-            mMetaTiles[tileNum].blockmask |= BLOCKMASK_CHARACTER;
-            break;
-        case BLOCKTYPE_MONSTER:
-            mMetaTiles[tileNum].blockmask |= BLOCKMASK_MONSTER;
-            break;
-        default:
-            // Do nothing.
-            break;
-    }
+    layer[y * mBlockWordsPerRow + x / 64] |= uint64_t(1) << (x % 64);
 }
 
 bool Map::getWalk(int x, int y, unsigned char walkmask) const
@@ -549,7 +572,61 @@ bool Map::getWalk(int x, int y, unsigned char walkmask) const
         return false;
 
     // Check if the tile is walkable
-    return !(mMetaTiles[x + y * mWidth].blockmask & walkmask);
+    const int word = y * mBlockWordsPerRow + x / 64;
+    const uint64_t bit = uint64_t(1) << (x % 64);
+
+    for (int type = 0; type < NB_BLOCKTYPES; ++type)
+    {
+        const auto &layer = mBlockLayers[type];
+        if ((walkmask & BLOCKTYPE_MASKS[type]) && !layer.empty() &&
+            (layer[word] & bit))
+            return false;
+    }
+
+    return true;
+}
+
+uint64_t Map::getBlockedTiles(int x, int y, int count,
+                              unsigned char walkmask) const
+{
+    assert(count > 0 && count < 64);
+
+    const uint64_t all = (uint64_t(1) << count) - 1;
+    const int start = std::max(x, 0);
+    const int end = std::min(x + count, mWidth);
+
+    if (y < 0 || y >= mHeight || start >= end)
+        return all;
+
+    // Tiles outside of the map are blocked
+    const int length = end - start;
+    const uint64_t inside = ((uint64_t(1) << length) - 1) << (start - x);
+    uint64_t blocked = all & ~inside;
+
+    const int word = y * mBlockWordsPerRow + start / 64;
+    const int shift = start % 64;
+
+    for (int type = 0; type < NB_BLOCKTYPES; ++type)
+    {
+        const auto &layer = mBlockLayers[type];
+        if (!(walkmask & BLOCKTYPE_MASKS[type]) || layer.empty())
+            continue;
+
+        uint64_t bits = layer[word] >> shift;
+        if (shift + length > 64)
+            bits |= layer[word + 1] << (64 - shift);
+
+        blocked |= (bits << (start - x)) & inside;
+    }
+
+    return blocked;
+}
+
+unsigned Map::getBlockedNeighbours(int x, int y, unsigned char walkmask) const
+{
+    return getBlockedTiles(x - 1, y - 1, 3, walkmask) |
+           getBlockedTiles(x - 1, y, 3, walkmask) << 3 |
+           getBlockedTiles(x - 1, y + 1, 3, walkmask) << 6;
 }
 
 bool Map::occupied(int x, int y) const
@@ -577,20 +654,89 @@ bool Map::contains(int x, int y) const
     return x >= 0 && y >= 0 && x < mWidth && y < mHeight;
 }
 
-MetaTile *Map::getMetaTile(int x, int y) const
+int Map::getPathCost(int x, int y) const
+{
+    const size_t index = x + y * mWidth;
+    if (!contains(x, y) || index >= pathScratch.list.size())
+        return 0;
+
+    return pathScratch.Gcost[index];
+}
+
+void Map::addActor(Actor *actor)
 {
-    return &mMetaTiles[x + y * mWidth];
+    actor->mMapIndex = mActors.size();
+    mActors.push_back({ actor->getDrawOrder(), actor });
 }
 
-Actors::iterator Map::addActor(Actor *actor)
+void Map::removeActor(Actor *actor)
 {
-    mActors.push_front(actor);
-    return mActors.begin();
+    mActors[actor->mMapIndex].actor = nullptr;
+    actor->mMapIndex = -1;
+    mActorsRemoved = true;
 }
 
-void Map::removeActor(Actors::iterator iterator)
+void Map::updateVisibleActors(int left, int top, int right, int bottom)
 {
-    mActors.erase(iterator);
+    if (mActorsRemoved)
+    {
+        mActors.erase(std::remove_if(mActors.begin(), mActors.end(),
+                                     [] (const ActorEntry &entry) {
+                                         return !entry.actor;
+                                     }),
+                      mActors.end());
+        mActorsRemoved = false;
+    }
+
+    for (auto &entry : mActors)
+        entry.drawOrder = entry.actor->getDrawOrder();
+
+    // Actors rarely pass each other between two frames, which makes an
+    // insertion sort close to linear. When it turns out to be doing a lot
+    // of work, like after entering a map, fall back to a regular sort.
+    const size_t maxMoves = mActors.size() * 4;
+    size_t moves = 0;
+
+    for (size_t i = 1; i < mActors.size() && moves <= maxMoves; ++i)
+    {
+        const ActorEntry entry = mActors[i];
+        size_t j = i;
+        for (; j > 0 && mActors[j - 1].drawOrder > entry.drawOrder; --j)
+            mActors[j] = mActors[j - 1];
+        mActors[j] = entry;
+        moves += i - j;
+    }
+
+    if (moves > maxMoves)
+    {
+        std::stable_sort(mActors.begin(), mActors.end(),
+                         [] (const ActorEntry &a, const ActorEntry &b) {
+                             return a.drawOrder < b.drawOrder;
+                         });
+    }
+
+    // Actors are drawn around their position, so allow some margin for
+    // large sprites and effects. Particles are drawn raised by their height.
+    left -= ACTOR_CULL_MARGIN;
+    top -= ACTOR_CULL_MARGIN;
+    right += ACTOR_CULL_MARGIN;
+    bottom += ACTOR_CULL_MARGIN;
+
+    mVisibleActors.clear();
+
+    for (size_t i = 0; i < mActors.size(); ++i)
+    {
+        Actor *actor = mActors[i].actor;
+        actor->mMapIndex = i;
+
+        const Vector &pos = actor->getPosition();
+        const float screenY = pos.y - pos.z;
+        if (pos.x >= left && pos.x <= right &&
+            screenY >= top && screenY <= bottom)
+        {
+            mVisibleActors.push_back(actor);
+        }
+    }
 }
 
 std::string Map::getMusicFile() const
@@ -634,29 +780,35 @@ Position Map::checkNodeOffsets(int radius, unsigned char walkMask,
     // set a default value if no value returned.
     if (radius < 1) radius = mTileWidth / 3;
 
+    // Bit for each neighbouring tile, from the top-left to the bottom-right
+    const unsigned blocked = getBlockedNeighbours(tx, ty, walkMask);
+    auto isBlocked = [blocked] (int dx, int dy) {
+        return blocked & (1 << ((dy + 1) * 3 + dx + 1));
+    };
+
     // We check diagonal first as they are more restrictive.
     // Top-left border check
-    if (!getWalk(tx - 1, ty - 1, walkMask)
+    if (isBlocked(-1, -1)
         && fy < radius && fx < radius)
     {
         fx = fy = radius;
     }
     // Top-right border check
-    if (!getWalk(tx + 1, ty - 1, walkMask)
+    if (isBlocked(1, -1)
         && (fy < radius) && fx > (mTileWidth - radius))
     {
         fx = mTileWidth - radius;
         fy = radius;
     }
     // Bottom-left border check
-    if (!getWalk(tx - 1, ty + 1, walkMask)
+    if (isBlocked(-1, 1)
         && fy > (mTileHeight - radius) && fx < radius)
     {
         fx = radius;
         fy = mTileHeight - radius;
     }
     // Bottom-right border check
-    if (!getWalk(tx + 1, ty + 1, walkMask)
+    if (isBlocked(1, 1)
         && fy > (mTileHeight - radius) && fx > (mTileWidth - radius))
     {
         fx = mTileWidth - radius;
@@ -664,13 +816,13 @@ Position Map::checkNodeOffsets(int radius, unsigned char walkMask,
     }
 
     // Fix coordinates so that the player does not seem to dig into walls.
-    if (fx > (mTileWidth - radius) && !getWalk(tx + 1, ty, walkMask))
+    if (fx > (mTileWidth - radius) && isBlocked(1, 0))
         fx = mTileWidth - radius;
-    else if (fx < radius && !getWalk(tx - 1, ty, walkMask))
+    else if (fx < radius && isBlocked(-1, 0))
         fx = radius;
-    else if (fy > (mTileHeight - radius) && !getWalk(tx, ty + 1, walkMask))
+    else if (fy > (mTileHeight - radius) && isBlocked(0, 1))
         fy = mTileHeight - radius;
-    else if (fy < radius && !getWalk(tx, ty - 1, walkMask))
+    else if (fy < radius && isBlocked(0, -1))
         fy = radius;
 
     return Position(tx * mTileWidth + fx, ty * mTileHeight + fy);
@@ -763,19 +915,26 @@ Path Map::findPath(int startX, int startY, int destX, int destY,
     if (startX == destX && startY == destY)
         return path;
 
-    // Declare open list, a list with open tiles sorted on F cost
-    std::priority_queue<Location> openList;
-
     // Return when destination not walkable
     if (!getWalk(destX, destY, walkmask))
         return path;
 
+    PathfindingScratch &scratch = pathScratch;
+    scratch.reserve(mWidth * mHeight);
+
+    const unsigned onClosedList = scratch.onClosedList;
+    const unsigned onOpenList = scratch.onOpenList;
+
+    // Declare open list, a heap with open tiles sorted on F cost
+    std::vector<Location> &openList = scratch.openList;
+    openList.clear();
+
     // Reset starting tile's G cost to 0
-    MetaTile *startTile = getMetaTile(startX, startY);
-    startTile->Gcost = 0;
+    const int startIndex = startX + startY * mWidth;
+    scratch.Gcost[startIndex] = 0;
 
     // Add the start point to the open list
-    openList.emplace(startX, startY, startTile);
+    openList.emplace_back(startX, startY, 0);
 
     bool foundPath = false;
 
@@ -783,16 +942,25 @@ Path Map::findPath(int startX, int startY, int destX, int destY,
     while (!openList.empty() && !foundPath)
     {
         // Take the location with the lowest F cost from the open list.
-        Location curr = openList.top();
-        openList.pop();
+        std::pop_heap(openList.begin(), openList.end());
+        const Location curr = openList.back();
+        openList.pop_back();
+
+        const int currIndex = curr.x + curr.y * mWidth;
 
         // If the tile is already on the closed list, this means it has already
         // been processed with a shorter path to the start point (lower G cost)
-        if (curr.tile->whichList == mOnClosedList)
+        if (scratch.list[currIndex] == onClosedList)
             continue;
 
         // Put the current tile on the closed list
-        curr.tile->whichList = mOnClosedList;
+        scratch.list[currIndex] = onClosedList;
+
+        // Look up whether the adjacent tiles are walkable all at once
+        const unsigned blocked = getBlockedNeighbours(curr.x, curr.y, walkmask);
+        auto isBlocked = [blocked] (int dx, int dy) {
+            return blocked & (1 << ((dy + 1) * 3 + dx + 1));
+        };
 
         // Check the adjacent tiles
         for (int dy = -1; dy <= 1; dy++)
@@ -808,13 +976,12 @@ Path Map::findPath(int startX, int startY, int destX, int destY,
                 if ((dx == 0 && dy == 0) || !contains(x, y))
                     continue;
 
-                MetaTile *newTile = getMetaTile(x, y);
+                const int newIndex = x + y * mWidth;
 
                 // Skip if the tile is on the closed list or is not walkable
                 // unless its the destination tile
-                if (newTile->whichList == mOnClosedList ||
-                    ((newTile->blockmask & walkmask)
-                     && !(x == destX && y == destY)))
+                if (scratch.list[newIndex] == onClosedList ||
+                    (isBlocked(dx, dy) && !(x == destX && y == destY)))
                 {
                     continue;
                 }
@@ -823,15 +990,12 @@ Path Map::findPath(int startX, int startY, int destX, int destY,
                 // corner.
                 if (dx != 0 && dy != 0)
                 {
-                    MetaTile *t1 = getMetaTile(curr.x, curr.y + dy);
-                    MetaTile *t2 = getMetaTile(curr.x + dx, curr.y);
-
-                    if ((t1->blockmask | t2->blockmask) & walkmask)
+                    if (isBlocked(0, dy) || isBlocked(dx, 0))
                         continue;
                 }
 
                 // Calculate G cost for this route, ~sqrt(2) for moving diagonal
-                int Gcost = curr.tile->Gcost +
+                int Gcost = scratch.Gcost[currIndex] +
                     (dx == 0 || dy == 0 ? basicCost : diagonalCost);
 
                 /* Demote an arbitrary direction to speed pathfinding by
@@ -864,93 +1028,69 @@ Path Map::findPath(int startX, int startY, int destX, int destY,
                     continue;
                 }
 
-                if (newTile->whichList != mOnOpenList)
-                {
-                    // Found a new tile (not on open nor on closed list)
-
-                    /* Update Hcost of the new tile. The pathfinder does not
-                       work reliably if the heuristic cost is higher than the
-                       real cost. In particular, using Manhattan distance is
-                       forbidden here. */
-                    int dx = std::abs(x - destX);
-                    int dy = std::abs(y - destY);
-                    newTile->Hcost = std::abs(dx - dy) * basicCost +
-                        std::min(dx, dy) * diagonalCost;
-
-                    // Set the current tile as the parent of the new tile
-                    newTile->parentX = curr.x;
-                    newTile->parentY = curr.y;
-
-                    // Update Gcost and Fcost of new tile
-                    newTile->Gcost = Gcost;
-                    newTile->Fcost = Gcost + newTile->Hcost;
-
-                    if (x != destX || y != destY)
-                    {
-                        // Add this tile to the open list
-                        newTile->whichList = mOnOpenList;
-                        openList.emplace(x, y, newTile);
-                    }
-                    else
-                    {
-                        // Target location was found
-                        foundPath = true;
-                    }
-                }
-                else if (Gcost < newTile->Gcost)
+                const bool isNew = scratch.list[newIndex] != onOpenList;
+                if (!isNew && Gcost >= scratch.Gcost[newIndex])
+                    continue;
+
+                /* Calculate the heuristic cost of the new tile. The
+                   pathfinder does not work reliably if the heuristic cost is
+                   higher than the real cost. In particular, using Manhattan
+                   distance is forbidden here. */
+                const int hx = std::abs(x - destX);
+                const int hy = std::abs(y - destY);
+                const int Hcost = std::abs(hx - hy) * basicCost +
+                    std::min(hx, hy) * diagonalCost;
+
+                // Set the current tile as the parent of the new tile and
+                // update its Gcost
+                scratch.parent[newIndex] = currIndex;
+                scratch.Gcost[newIndex] = Gcost;
+
+                if (isNew && x == destX && y == destY)
                 {
-                    // Found a shorter route.
-                    // Update Gcost and Fcost of the new tile
-                    newTile->Gcost = Gcost;
-                    newTile->Fcost = Gcost + newTile->Hcost;
-
-                    // Set the current tile as the parent of the new tile
-                    newTile->parentX = curr.x;
-                    newTile->parentY = curr.y;
-
-                    // Add this tile to the open list (it's already
-                    // there, but this instance has a lower F score)
-                    openList.emplace(x, y, newTile);
+                    // Target location was found
+                    foundPath = true;
+                    continue;
                 }
+
+                // Add this tile to the open list (when it's already there,
+                // this instance has a lower F score)
+                scratch.list[newIndex] = onOpenList;
+                openList.emplace_back(x, y, Gcost + Hcost);
+                std::push_heap(openList.begin(), openList.end());
             }
         }
     }
 
     // Two new values to indicate whether a tile is on the open or closed list,
     // this way we don't have to clear all the values between each pathfinding.
-    if (mOnOpenList > UINT_MAX - 2)
+    if (scratch.onOpenList > UINT_MAX - 2)
     {
         // We reset the list memebers value.
-        mOnClosedList = 1;
-        mOnOpenList = 2;
+        scratch.onClosedList = 1;
+        scratch.onOpenList = 2;
 
-        // Clean up the metaTiles
-        const int size = mWidth * mHeight;
-        for (int i = 0; i < size; ++i)
-            mMetaTiles[i].whichList = 0;
+        std::fill(scratch.list.begin(), scratch.list.end(), 0);
     }
     else
     {
-        mOnClosedList += 2;
-        mOnOpenList += 2;
+        scratch.onClosedList += 2;
+        scratch.onOpenList += 2;
     }
 
     // If a path has been found, iterate backwards using the parent locations
     // to extract it.
     if (foundPath)
     {
-        int pathX = destX;
-        int pathY = destY;
+        int index = destX + destY * mWidth;
 
-        while (pathX != startX || pathY != startY)
+        while (index != startIndex)
         {
             // Add the new path node to the start of the path list
-            path.emplace_front(pathX, pathY);
+            path.emplace_front(index % mWidth, index / mWidth);
 
             // Find out the next parent
-            MetaTile *tile = getMetaTile(pathX, pathY);
-            pathX = tile->parentX;
-            pathY = tile->parentY;
+            index = scratch.parent[index];
         }
     }
 
@@ -988,11 +1128,41 @@ void Map::initializeParticleEffects(Particle *particleEngine)
 
 void Map::addAnimation(int gid, TileAnimation animation)
 {
-    auto const [_, inserted] = mTileAnimations.try_emplace(gid, std::move(animation));
+    auto const [it, inserted] = mTileAnimations.try_emplace(gid, std::move(animation));
     if (!inserted)
     {
         Log::warn("Duplicate tile animation for gid %d", gid);
+        return;
+    }
+
+    TileAnimation &tileAnimation = it->second;
+    const Animation &ani = tileAnimation.getAnimation();
+
+    std::vector<int> delays;
+    for (int i = 0; i < ani.getLength(); i++)
+        delays.push_back(ani.getFrame(i)->delay);
+
+    // Share the timer with animations using the same frame delays
+    auto timerIt = std::find_if(mAnimationTimers.begin(),
+                                mAnimationTimers.end(),
+                                [&delays](const auto &timer) {
+                                    return timer->delays == delays;
+                                });
+
+    if (timerIt == mAnimationTimers.end())
+    {
+        auto timer = std::make_unique<TileAnimationTimer>();
+        timer->delays = std::move(delays);
+        timer->nextChange = mAnimationTime + timer->delays.front();
+
+        if (timer->delays.front() > 0 && timer->delays.size() > 1)
+            mAnimationQueue.emplace(timer->nextChange, timer.get());
+
+        mAnimationTimers.push_back(std::move(timer));
+        timerIt = mAnimationTimers.end() - 1;
     }
+
+    tileAnimation.setTimer(timerIt->get());
 }
 
 TileAnimation *Map::getAnimationForGid(int gid)
@@ -26,7 +26,10 @@
 #include "properties.h"
 #include "simpleanimation.h"
 
+#include <cstdint>
 #include <list>
+#include <memory>
+#include <queue>
 #include <vector>
 
 class AmbientLayer;
@@ -38,39 +41,35 @@ class Tileset;
 const int DEFAULT_TILE_LENGTH = 32;
 
 /**
- * A meta tile stores additional information about a location on a tile map.
- * This is information that doesn't need to be repeated for each tile in each
- * layer of the map.
+ * Tracks the current frame of all tile animations that have the same frame
+ * delays, so that they are advanced together.
  */
-struct MetaTile
+struct TileAnimationTimer
 {
-    // Pathfinding members
-    int Fcost;               /**< Estimation of total path cost */
-    int Gcost;               /**< Cost from start to this location */
-    int Hcost;               /**< Estimated cost to goal */
-    unsigned whichList = 0;  /**< No list, open list or closed list */
-    int parentX;             /**< X coordinate of parent tile */
-    int parentY;             /**< Y coordinate of parent tile */
-    unsigned char blockmask = 0; /**< Blocking properties of this tile */
+    std::vector<int> delays;    /**< Frame delays in milliseconds */
+    int phase = 0;              /**< Index of the current frame */
+    int nextChange = 0;         /**< Map time at which the frame changes */
 };
 
 /**
- * Animation cycle of a tile image which changes the map accordingly.
+ * Animation cycle of a tile image. Layers refer to the animation instead of
+ * a fixed image, and the current frame is looked up when drawing.
  */
 class TileAnimation
 {
     public:
         TileAnimation(Animation animation);
 
-        void update(int dt);
+        const Animation &getAnimation() const { return mAnimation; }
+
+        void setTimer(const TileAnimationTimer *timer) { mTimer = timer; }
 
-        void addAffectedTile(MapLayer *layer, int index)
-        { mAffected.emplace_back(layer, index); }
+        Image *getCurrentImage() const
+        { return mAnimation.getFrame(mTimer ? mTimer->phase : 0)->image; }
 
     private:
-        std::vector<std::pair<MapLayer*, int> > mAffected;
-        SimpleAnimation mAnimation;
-        Image *mLastImage = nullptr;
+        Animation mAnimation;
+        const TileAnimationTimer *mTimer = nullptr;
 };
 
 /**
@@ -90,7 +89,10 @@ class MapLayer
 
         ~MapLayer();
 
+        int getX() const { return mX; }
+        int getY() const { return mY; }
         int getWidth() const { return mWidth; }
+        int getHeight() const { return mHeight; }
 
         /**
          * Set tile image, with x and y in layer coordinates.
@@ -103,10 +105,22 @@ class MapLayer
         void setTile(int index, Image *img) { mTiles[index] = img; }
 
         /**
-         * Get tile image, with x and y in layer coordinates.
+         * Set an animation for the tile, with x and y in layer coordinates.
+         * It takes precedence over the tile image.
+         */
+        void setAnimation(int x, int y, const TileAnimation *animation);
+
+        /**
+         * Get tile image, with x and y in layer coordinates. For animated
+         * tiles this is the current frame.
          */
         Image *getTile(int x, int y) const
-        { return mTiles[x + y * mWidth]; }
+        {
+            const int index = x + y * mWidth;
+            if (mAnimations && mAnimations[index])
+                return mAnimations[index]->getCurrentImage();
+            return mTiles[index];
+        }
 
         /**
          * Draws this layer to the given graphics context. The coordinates are
@@ -137,6 +151,7 @@ class MapLayer
         int mMask = 1;
         bool mIsFringeLayer;    /**< Whether the actors are drawn. */
         Image **mTiles;
+        const TileAnimation **mAnimations = nullptr; /**< Allocated on demand */
         Map *mMap;              /** The mother map pointer */
 };
 
@@ -227,10 +242,17 @@ class Map : public Properties
          */
         Tileset *getTilesetWithGid(unsigned gid) const;
 
+        const std::vector<Tileset *> &getTilesets() const
+        { return mTilesets; }
+
+        const std::vector<MapLayer *> &getLayers() const
+        { return mLayers; }
+
         /**
-         * Get tile reference.
+         * Returns the cost from the start to the given tile, as calculated by
+         * the last path search that reached it. Used for debugging.
          */
-        MetaTile *getMetaTile(int x, int y) const;
+        int getPathCost(int x, int y) const;
 
         /**
          * Marks a tile as occupied.
@@ -344,12 +366,12 @@ class Map : public Properties
         /**
          * Adds an actor to the map.
          */
-        Actors::iterator addActor(Actor *actor);
+        void addActor(Actor *actor);
 
         /**
          * Removes an actor from the map.
          */
-        void removeActor(Actors::iterator iterator);
+        void removeActor(Actor *actor);
 
     private:
         /**
@@ -369,6 +391,12 @@ class Map : public Properties
          */
         void updateAmbientLayers(float scrollX, float scrollY);
 
+        /**
+         * Brings the actors back in draw order and collects the ones that
+         * may be visible in the given area, in pixels.
+         */
+        void updateVisibleActors(int left, int top, int right, int bottom);
+
         /**
          * Draws the foreground or background layers to the given graphics output.
          */
@@ -381,24 +409,54 @@ class Map : public Properties
         bool contains(int x, int y) const;
 
         /**
-         * Blockmasks for different entities
+         * Returns a bit for each of \a count tiles starting at the given
+         * location on a row, which is set when the tile is blocked for the
+         * walkmask or outside of the map. \a count must be less than 64.
+         */
+        uint64_t getBlockedTiles(int x, int y, int count,
+                                 unsigned char walkmask) const;
+
+        /**
+         * Returns the blocked tiles around the given location, with the three
+         * tiles of each row in bits 0-2, 3-5 and 6-8 from the top row down.
          */
-        unsigned *mOccupation[NB_BLOCKTYPES];
+        unsigned getBlockedNeighbours(int x, int y,
+                                      unsigned char walkmask) const;
 
         int mWidth, mHeight;
         int mTileWidth, mTileHeight;
         int mMaxTileHeight, mMaxTileWidth;
-        MetaTile *mMetaTiles;
+
+        /**
+         * One bit per tile for each block type, with each row starting at a
+         * new word. Layers are only allocated once a tile is blocked.
+         */
+        std::vector<uint64_t> mBlockLayers[NB_BLOCKTYPES];
+        int mBlockWordsPerRow;
+
         std::vector<MapLayer *> mLayers;
         std::vector<Tileset *> mTilesets;
-        Actors mActors;
+
+        struct ActorEntry
+        {
+            int drawOrder;
+            Actor *actor;
+        };
+
+        /**
+         * All actors on the map with their draw order as of the last frame.
+         * Kept sorted from frame to frame, so that usually only a few actors
+         * need to be moved. Removed actors leave a null entry until the next
+         * frame.
+         */
+        std::vector<ActorEntry> mActors;
+        bool mActorsRemoved = false;
+
+        Actors mVisibleActors;  /**< Actors near the screen, sorted by draw order */
 
         // debug flags
         int mDebugFlags;
 
-        // Pathfinding members
-        unsigned mOnClosedList, mOnOpenList;
-
         // Overlay data
         std::vector<AmbientLayer> mBackgrounds;
         std::vector<AmbientLayer> mForegrounds;
@@ -418,5 +476,17 @@ class Map : public Properties
 
         std::map<int, TileAnimation> mTileAnimations;
 
+        /**
+         * Tile animations are grouped by their frame delays. The timers are
+         * kept in a queue ordered by their next frame change, so that only
+         * the ones that are due need to be looked at.
+         */
+        using TimerEntry = std::pair<int, TileAnimationTimer*>;
+        std::vector<std::unique_ptr<TileAnimationTimer>> mAnimationTimers;
+        std::priority_queue<TimerEntry,
+                            std::vector<TimerEntry>,
+                            std::greater<TimerEntry>> mAnimationQueue;
+        int mAnimationTime = 0;
+
         int mMask = 1;
 };
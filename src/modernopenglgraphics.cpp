@@ -0,0 +1,947 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef USE_OPENGL
+
+#include "modernopenglgraphics.h"
+
+#include "configuration.h"
+#include "log.h"
+#include "openglgraphics.h"
+#include "video.h"
+
+#include "resources/image.h"
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_STATIC_DRAW 0x88E4
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+
+#ifndef GL_VERTEX_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_INFO_LOG_LENGTH 0x8B84
+#endif
+
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
+#ifndef GL_VERSION_1_5
+using GLsizeiptr = std::ptrdiff_t;
+using GLintptr = std::ptrdiff_t;
+#endif
+
+#ifndef GL_VERSION_2_0
+using GLchar = char;
+#endif
+
+/*
+ * Functions beyond OpenGL 1.1 are not exported by all platforms, so they are
+ * resolved at runtime. They are all core in OpenGL 3.3.
+ */
+using CreateShaderFn = GLuint (APIENTRY *)(GLenum);
+using ShaderSourceFn = void (APIENTRY *)(GLuint, GLsizei, const GLchar *const *,
+                                         const GLint *);
+using CompileShaderFn = void (APIENTRY *)(GLuint);
+using GetShaderivFn = void (APIENTRY *)(GLuint, GLenum, GLint *);
+using GetShaderInfoLogFn = void (APIENTRY *)(GLuint, GLsizei, GLsizei *, GLchar *);
+using DeleteShaderFn = void (APIENTRY *)(GLuint);
+using CreateProgramFn = GLuint (APIENTRY *)();
+using AttachShaderFn = void (APIENTRY *)(GLuint, GLuint);
+using LinkProgramFn = void (APIENTRY *)(GLuint);
+using GetProgramivFn = void (APIENTRY *)(GLuint, GLenum, GLint *);
+using GetProgramInfoLogFn = void (APIENTRY *)(GLuint, GLsizei, GLsizei *, GLchar *);
+using DeleteProgramFn = void (APIENTRY *)(GLuint);
+using UseProgramFn = void (APIENTRY *)(GLuint);
+using GetUniformLocationFn = GLint (APIENTRY *)(GLuint, const GLchar *);
+using Uniform1iFn = void (APIENTRY *)(GLint, GLint);
+using Uniform2fFn = void (APIENTRY *)(GLint, GLfloat, GLfloat);
+using GenVertexArraysFn = void (APIENTRY *)(GLsizei, GLuint *);
+using BindVertexArrayFn = void (APIENTRY *)(GLuint);
+using DeleteVertexArraysFn = void (APIENTRY *)(GLsizei, const GLuint *);
+using GenBuffersFn = void (APIENTRY *)(GLsizei, GLuint *);
+using BindBufferFn = void (APIENTRY *)(GLenum, GLuint);
+using BufferDataFn = void (APIENTRY *)(GLenum, GLsizeiptr, const void *, GLenum);
+using DeleteBuffersFn = void (APIENTRY *)(GLsizei, const GLuint *);
+using MapBufferRangeFn = void *(APIENTRY *)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+using UnmapBufferFn = GLboolean (APIENTRY *)(GLenum);
+using EnableVertexAttribArrayFn = void (APIENTRY *)(GLuint);
+using VertexAttribPointerFn = void (APIENTRY *)(GLuint, GLint, GLenum, GLboolean,
+                                                GLsizei, const void *);
+using VertexAttribDivisorFn = void (APIENTRY *)(GLuint, GLuint);
+using DrawArraysInstancedFn = void (APIENTRY *)(GLenum, GLint, GLsizei, GLsizei);
+using BlendFuncSeparateFn = void (APIENTRY *)(GLenum, GLenum, GLenum, GLenum);
+using GenFramebuffersFn = void (APIENTRY *)(GLsizei, GLuint *);
+using DeleteFramebuffersFn = void (APIENTRY *)(GLsizei, const GLuint *);
+using BindFramebufferFn = void (APIENTRY *)(GLenum, GLuint);
+using FramebufferTexture2DFn = void (APIENTRY *)(GLenum, GLenum, GLenum,
+                                                 GLuint, GLint);
+using CheckFramebufferStatusFn = GLenum (APIENTRY *)(GLenum);
+
+static CreateShaderFn createShader;
+static ShaderSourceFn shaderSource;
+static CompileShaderFn compileShader;
+static GetShaderivFn getShaderiv;
+static GetShaderInfoLogFn getShaderInfoLog;
+static DeleteShaderFn deleteShader;
+static CreateProgramFn createProgram;
+static AttachShaderFn attachShader;
+static LinkProgramFn linkProgram;
+static GetProgramivFn getProgramiv;
+static GetProgramInfoLogFn getProgramInfoLog;
+static DeleteProgramFn deleteProgram;
+static UseProgramFn useProgram;
+static GetUniformLocationFn getUniformLocation;
+static Uniform1iFn uniform1i;
+static Uniform2fFn uniform2f;
+static GenVertexArraysFn genVertexArrays;
+static BindVertexArrayFn bindVertexArray;
+static DeleteVertexArraysFn deleteVertexArrays;
+static GenBuffersFn genBuffers;
+static BindBufferFn bindBuffer;
+static BufferDataFn bufferData;
+static DeleteBuffersFn deleteBuffers;
+static MapBufferRangeFn mapBufferRange;
+static UnmapBufferFn unmapBuffer;
+static EnableVertexAttribArrayFn enableVertexAttribArray;
+static VertexAttribPointerFn vertexAttribPointer;
+static VertexAttribDivisorFn vertexAttribDivisor;
+static DrawArraysInstancedFn drawArraysInstanced;
+static BlendFuncSeparateFn blendFuncSeparate;
+static GenFramebuffersFn genFramebuffers;
+static DeleteFramebuffersFn deleteFramebuffers;
+static BindFramebufferFn bindFramebuffer;
+static FramebufferTexture2DFn framebufferTexture2D;
+static CheckFramebufferStatusFn checkFramebufferStatus;
+
+template<typename Function>
+static bool loadFunction(Function &function, const char *name)
+{
+    function = reinterpret_cast<Function>(SDL_GL_GetProcAddress(name));
+    if (!function)
+        Log::info("OpenGL function %s not available", name);
+    return function != nullptr;
+}
+
+static bool loadFunctions()
+{
+    return loadFunction(createShader, "glCreateShader") &&
+           loadFunction(shaderSource, "glShaderSource") &&
+           loadFunction(compileShader, "glCompileShader") &&
+           loadFunction(getShaderiv, "glGetShaderiv") &&
+           loadFunction(getShaderInfoLog, "glGetShaderInfoLog") &&
+           loadFunction(deleteShader, "glDeleteShader") &&
+           loadFunction(createProgram, "glCreateProgram") &&
+           loadFunction(attachShader, "glAttachShader") &&
+           loadFunction(linkProgram, "glLinkProgram") &&
+           loadFunction(getProgramiv, "glGetProgramiv") &&
+           loadFunction(getProgramInfoLog, "glGetProgramInfoLog") &&
+           loadFunction(deleteProgram, "glDeleteProgram") &&
+           loadFunction(useProgram, "glUseProgram") &&
+           loadFunction(getUniformLocation, "glGetUniformLocation") &&
+           loadFunction(uniform1i, "glUniform1i") &&
+           loadFunction(uniform2f, "glUniform2f") &&
+           loadFunction(genVertexArrays, "glGenVertexArrays") &&
+           loadFunction(bindVertexArray, "glBindVertexArray") &&
+           loadFunction(deleteVertexArrays, "glDeleteVertexArrays") &&
+           loadFunction(genBuffers, "glGenBuffers") &&
+           loadFunction(bindBuffer, "glBindBuffer") &&
+           loadFunction(bufferData, "glBufferData") &&
+           loadFunction(deleteBuffers, "glDeleteBuffers") &&
+           loadFunction(mapBufferRange, "glMapBufferRange") &&
+           loadFunction(unmapBuffer, "glUnmapBuffer") &&
+           loadFunction(enableVertexAttribArray, "glEnableVertexAttribArray") &&
+           loadFunction(vertexAttribPointer, "glVertexAttribPointer") &&
+           loadFunction(vertexAttribDivisor, "glVertexAttribDivisor") &&
+           loadFunction(drawArraysInstanced, "glDrawArraysInstanced") &&
+           loadFunction(blendFuncSeparate, "glBlendFuncSeparate") &&
+           loadFunction(genFramebuffers, "glGenFramebuffers") &&
+           loadFunction(deleteFramebuffers, "glDeleteFramebuffers") &&
+           loadFunction(bindFramebuffer, "glBindFramebuffer") &&
+           loadFunction(framebufferTexture2D, "glFramebufferTexture2D") &&
+           loadFunction(checkFramebufferStatus, "glCheckFramebufferStatus");
+}
+
+/*
+ * Each quad is an instance of a unit square, which is stretched over the
+ * rectangle of the quad. The texture coordinates are interpolated the same
+ * way. Lines use the two extra corners, stretched along the line.
+ */
+static const char *vertexShaderSource = R"(
+#version 330 core
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 rect;
+layout(location = 2) in vec4 texRect;
+layout(location = 3) in vec4 color;
+uniform vec2 screenSize;
+out vec2 fragTexCoord;
+out vec4 fragColor;
+void main()
+{
+    vec2 pos = rect.xy + corner * rect.zw;
+    gl_Position = vec4(pos.x * 2.0 / screenSize.x - 1.0,
+                       1.0 - pos.y * 2.0 / screenSize.y,
+                       0.0, 1.0);
+    fragTexCoord = mix(texRect.xy, texRect.zw, corner);
+    fragColor = color;
+}
+)";
+
+static const char *texturedFragmentShaderSource = R"(
+#version 330 core
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D image;
+out vec4 outColor;
+void main()
+{
+    outColor = texture(image, fragTexCoord) * fragColor;
+}
+)";
+
+static const char *coloredFragmentShaderSource = R"(
+#version 330 core
+in vec2 fragTexCoord;
+in vec4 fragColor;
+out vec4 outColor;
+void main()
+{
+    outColor = fragColor;
+}
+)";
+
+static const GLfloat corners[] =
+{
+    // Quad, as triangle strip
+    0.0f, 0.0f,
+    1.0f, 0.0f,
+    0.0f, 1.0f,
+    1.0f, 1.0f,
+    // Line
+    0.0f, 0.0f,
+    1.0f, 1.0f,
+};
+
+/** Number of quads that fit in the streaming buffer. */
+static constexpr size_t QUAD_BUFFER_SIZE = 16384;
+
+static ModernOpenGLGraphics *currentGraphics;
+
+static GLuint compileShaderSource(GLenum type, const char *source)
+{
+    GLuint shader = createShader(type);
+    shaderSource(shader, 1, &source, nullptr);
+    compileShader(shader);
+
+    GLint status;
+    getShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status)
+    {
+        GLchar log[1024];
+        getShaderInfoLog(shader, sizeof(log), nullptr, log);
+        Log::info("Failed to compile shader: %s", log);
+        deleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+static GLuint linkProgramSources(const char *vertexSource,
+                                 const char *fragmentSource)
+{
+    GLuint vertexShader = compileShaderSource(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileShaderSource(GL_FRAGMENT_SHADER, fragmentSource);
+    GLuint program = 0;
+
+    if (vertexShader && fragmentShader)
+    {
+        program = createProgram();
+        attachShader(program, vertexShader);
+        attachShader(program, fragmentShader);
+        linkProgram(program);
+
+        GLint status;
+        getProgramiv(program, GL_LINK_STATUS, &status);
+        if (!status)
+        {
+            GLchar log[1024];
+            getProgramInfoLog(program, sizeof(log), nullptr, log);
+            Log::info("Failed to link shader program: %s", log);
+            deleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (vertexShader)
+        deleteShader(vertexShader);
+    if (fragmentShader)
+        deleteShader(fragmentShader);
+
+    return program;
+}
+
+std::unique_ptr<ModernOpenGLGraphics> ModernOpenGLGraphics::create(
+        SDL_Window *window, const VideoSettings &settings)
+{
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+#ifdef __APPLE__
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+#endif
+
+    SDL_GLContext glContext = SDL_GL_CreateContext(window);
+
+    // Make sure a fallback to the legacy renderer gets a default context
+    SDL_GL_ResetAttributes();
+
+    if (!glContext)
+        return {};
+
+    if (!loadFunctions())
+    {
+        SDL_GL_DeleteContext(glContext);
+        return {};
+    }
+
+    auto graphics = std::make_unique<ModernOpenGLGraphics>(window, glContext);
+    if (!graphics->initialize())
+        return {};
+
+    if (settings.vsync)
+        SDL_GL_SetSwapInterval(1);
+
+    return graphics;
+}
+
+ModernOpenGLGraphics::ModernOpenGLGraphics(SDL_Window *window,
+                                           SDL_GLContext glContext)
+    : mWindow(window)
+    , mContext(glContext)
+{
+    currentGraphics = this;
+}
+
+ModernOpenGLGraphics::~ModernOpenGLGraphics()
+{
+    currentGraphics = nullptr;
+
+    if (mFramebuffer)
+        deleteFramebuffers(1, &mFramebuffer);
+    if (mQuadBuffer)
+        deleteBuffers(1, &mQuadBuffer);
+    if (mCornerBuffer)
+        deleteBuffers(1, &mCornerBuffer);
+    if (mVertexArray)
+        deleteVertexArrays(1, &mVertexArray);
+    if (mTexturedProgram)
+        deleteProgram(mTexturedProgram);
+    if (mColoredProgram)
+        deleteProgram(mColoredProgram);
+
+    SDL_GL_DeleteContext(mContext);
+}
+
+bool ModernOpenGLGraphics::initialize()
+{
+    mTexturedProgram = linkProgramSources(vertexShaderSource,
+                                          texturedFragmentShaderSource);
+    mColoredProgram = linkProgramSources(vertexShaderSource,
+                                         coloredFragmentShaderSource);
+    if (!mTexturedProgram || !mColoredProgram)
+        return false;
+
+    mTexturedScreenSize = getUniformLocation(mTexturedProgram, "screenSize");
+    mColoredScreenSize = getUniformLocation(mColoredProgram, "screenSize");
+
+    useProgram(mTexturedProgram);
+    uniform1i(getUniformLocation(mTexturedProgram, "image"), 0);
+
+    genVertexArrays(1, &mVertexArray);
+    bindVertexArray(mVertexArray);
+
+    genBuffers(1, &mCornerBuffer);
+    bindBuffer(GL_ARRAY_BUFFER, mCornerBuffer);
+    bufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    enableVertexAttribArray(0);
+    vertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    genBuffers(1, &mQuadBuffer);
+    bindBuffer(GL_ARRAY_BUFFER, mQuadBuffer);
+    bufferData(GL_ARRAY_BUFFER, QUAD_BUFFER_SIZE * sizeof(Quad), nullptr,
+               GL_STREAM_DRAW);
+
+    for (GLuint attribute = 1; attribute <= 3; ++attribute)
+    {
+        enableVertexAttribArray(attribute);
+        vertexAttribDivisor(attribute, 1);
+    }
+
+    mQuads.reserve(QUAD_BUFFER_SIZE);
+
+    genFramebuffers(1, &mFramebuffer);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Non-power-of-two textures are core since OpenGL 2.0
+    GLint texSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &texSize);
+
+    Image::setLoadAsOpenGL(true);
+    Image::mTextureType = GL_TEXTURE_2D;
+    Image::mPowerOfTwoTextures = false;
+    Image::mTextureSize = texSize;
+
+    Log::info("Using OpenGL %s, texture size: %d pixels",
+              reinterpret_cast<const char *>(glGetString(GL_VERSION)),
+              Image::mTextureSize);
+
+    SDL_GL_GetDrawableSize(mWindow, &mWidth, &mHeight);
+    glViewport(0, 0, mWidth, mHeight);
+
+    return true;
+}
+
+void ModernOpenGLGraphics::textureDeleted(GLuint texture)
+{
+    if (currentGraphics && currentGraphics->mBatchTexture == texture)
+    {
+        currentGraphics->flush();
+        currentGraphics->mBatchTexture = 0;
+    }
+}
+
+void ModernOpenGLGraphics::setVSync(bool sync)
+{
+    SDL_GL_SetSwapInterval(sync ? 1 : 0);
+}
+
+void ModernOpenGLGraphics::updateSize(int windowWidth, int windowHeight, float scale)
+{
+    flush();
+
+    mUserScale = scale;
+
+    int drawableWidth;
+    int drawableHeight;
+    SDL_GL_GetDrawableSize(mWindow, &drawableWidth, &drawableHeight);
+
+    float displayScaleX = windowWidth > 0 ? static_cast<float>(drawableWidth) / windowWidth : 1.0f;
+    float displayScaleY = windowHeight > 0 ? static_cast<float>(drawableHeight) / windowHeight : 1.0f;
+
+    mScaleX = mUserScale * displayScaleX;
+    mScaleY = mUserScale * displayScaleY;
+
+    mWidth = std::ceil(drawableWidth / mScaleX);
+    mHeight = std::ceil(drawableHeight / mScaleY);
+    mScale = mScaleX;
+
+    updateViewport();
+}
+
+void ModernOpenGLGraphics::updateViewport()
+{
+    if (mTarget)
+    {
+        glViewport(0, 0, mTarget->getWidth(), mTarget->getHeight());
+    }
+    else
+    {
+        int drawableWidth;
+        int drawableHeight;
+        SDL_GL_GetDrawableSize(mWindow, &drawableWidth, &drawableHeight);
+        glViewport(0, 0, drawableWidth, drawableHeight);
+    }
+}
+
+void ModernOpenGLGraphics::setBatch(BatchMode mode, GLuint texture)
+{
+    if (mode != mBatchMode || texture != mBatchTexture)
+    {
+        flush();
+        mBatchMode = mode;
+        mBatchTexture = texture;
+    }
+}
+
+void ModernOpenGLGraphics::setImageBatch(const Image *image)
+{
+    setBatch(BatchMode::Textured, image->mGLImage);
+
+    GLubyte alpha = 255;
+    if (image->useColor())
+    {
+        mQuadColor[0] = mColor.r;
+        mQuadColor[1] = mColor.g;
+        mQuadColor[2] = mColor.b;
+        alpha = mColor.a;
+    }
+    else
+    {
+        mQuadColor[0] = mQuadColor[1] = mQuadColor[2] = 255;
+    }
+    mQuadColor[3] = static_cast<GLubyte>(alpha * image->getAlpha());
+}
+
+void ModernOpenGLGraphics::addQuad(float x, float y, float width, float height,
+                                   float texX1, float texY1,
+                                   float texX2, float texY2)
+{
+    // Keeps drawing the same batch after making room
+    if (mQuads.size() >= QUAD_BUFFER_SIZE)
+        flush();
+
+    const gcn::ClipRectangle &top = mClipStack.top();
+
+    Quad &quad = mQuads.emplace_back();
+    quad.x = x + top.xOffset;
+    quad.y = y + top.yOffset;
+    quad.width = width;
+    quad.height = height;
+    quad.texX1 = texX1;
+    quad.texY1 = texY1;
+    quad.texX2 = texX2;
+    quad.texY2 = texY2;
+    std::memcpy(quad.color, mQuadColor, sizeof(quad.color));
+}
+
+void ModernOpenGLGraphics::flush()
+{
+    if (mQuads.empty())
+        return;
+
+    const size_t size = mQuads.size() * sizeof(Quad);
+
+    // When the buffer is full, orphan it so the driver can hand out fresh
+    // storage instead of waiting for pending draws to finish.
+    bindBuffer(GL_ARRAY_BUFFER, mQuadBuffer);
+    if (mQuadBufferOffset + size > QUAD_BUFFER_SIZE * sizeof(Quad))
+    {
+        bufferData(GL_ARRAY_BUFFER, QUAD_BUFFER_SIZE * sizeof(Quad), nullptr,
+                   GL_STREAM_DRAW);
+        mQuadBufferOffset = 0;
+    }
+
+    void *data = mapBufferRange(GL_ARRAY_BUFFER, mQuadBufferOffset, size,
+                                GL_MAP_WRITE_BIT |
+                                GL_MAP_INVALIDATE_RANGE_BIT |
+                                GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!data)
+    {
+        mQuads.clear();
+        return;
+    }
+
+    std::memcpy(data, mQuads.data(), size);
+    unmapBuffer(GL_ARRAY_BUFFER);
+
+    const auto offset = [this] (size_t member) {
+        return reinterpret_cast<const void *>(mQuadBufferOffset + member);
+    };
+    vertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Quad),
+                        offset(offsetof(Quad, x)));
+    vertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Quad),
+                        offset(offsetof(Quad, texX1)));
+    vertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Quad),
+                        offset(offsetof(Quad, color)));
+
+    const bool textured = mBatchMode == BatchMode::Textured ||
+            mBatchMode == BatchMode::Premultiplied;
+
+    if (textured)
+    {
+        useProgram(mTexturedProgram);
+        uniform2f(mTexturedScreenSize, mWidth, mHeight);
+        OpenGLGraphics::bindTexture(GL_TEXTURE_2D, mBatchTexture);
+    }
+    else
+    {
+        useProgram(mColoredProgram);
+        uniform2f(mColoredScreenSize, mWidth, mHeight);
+    }
+
+    if (mBatchMode == BatchMode::Premultiplied)
+    {
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else if (mTarget)
+    {
+        // Accumulate the alpha channel like the color channels, which
+        // results in premultiplied alpha
+        blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                          GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else
+    {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    if (mBatchMode == BatchMode::Lines)
+        drawArraysInstanced(GL_LINES, 4, 2, mQuads.size());
+    else
+        drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, mQuads.size());
+
+    mQuadBufferOffset += size;
+    mQuads.clear();
+}
+
+bool ModernOpenGLGraphics::drawRescaledImage(const Image *image,
+                                             int srcX, int srcY,
+                                             int dstX, int dstY,
+                                             int width, int height,
+                                             int desiredWidth, int desiredHeight)
+{
+    return drawRescaledImageF(image, srcX, srcY, dstX, dstY,
+                              width, height, desiredWidth, desiredHeight);
+}
+
+bool ModernOpenGLGraphics::drawRescaledImageF(const Image *image,
+                                              int srcX, int srcY,
+                                              float dstX, float dstY,
+                                              int width, int height,
+                                              float desiredWidth, float desiredHeight)
+{
+    if (!image)
+        return false;
+
+    srcX += image->mBounds.x;
+    srcY += image->mBounds.y;
+
+    const auto tw = static_cast<float>(image->getTextureWidth());
+    const auto th = static_cast<float>(image->getTextureHeight());
+
+    setImageBatch(image);
+    addQuad(dstX, dstY, desiredWidth, desiredHeight,
+            srcX / tw, srcY / th,
+            (srcX + width) / tw, (srcY + height) / th);
+
+    return true;
+}
+
+void ModernOpenGLGraphics::drawRescaledImagePattern(const Image *image,
+                                                    int srcX, int srcY,
+                                                    int srcW, int srcH,
+                                                    int dstX, int dstY,
+                                                    int dstW, int dstH,
+                                                    int scaledWidth,
+                                                    int scaledHeight)
+{
+    if (!image)
+        return;
+
+    if (scaledWidth == 0 || scaledHeight == 0)
+        return;
+
+    if (srcW == 0 || srcH == 0)
+        return;
+
+    srcX += image->mBounds.x;
+    srcY += image->mBounds.y;
+
+    const auto tw = static_cast<float>(image->getTextureWidth());
+    const auto th = static_cast<float>(image->getTextureHeight());
+
+    const float texX1 = srcX / tw;
+    const float texY1 = srcY / th;
+
+    const float tFractionW = srcW / tw;
+    const float tFractionH = srcH / th;
+
+    setImageBatch(image);
+
+    for (int py = 0; py < dstH; py += scaledHeight)
+    {
+        const int height = (py + scaledHeight >= dstH) ? dstH - py : scaledHeight;
+        const float texY2 = texY1 + tFractionH * height / scaledHeight;
+
+        for (int px = 0; px < dstW; px += scaledWidth)
+        {
+            const int width = (px + scaledWidth >= dstW) ? dstW - px : scaledWidth;
+            const float texX2 = texX1 + tFractionW * width / scaledWidth;
+
+            addQuad(dstX + px, dstY + py, width, height,
+                    texX1, texY1, texX2, texY2);
+        }
+    }
+}
+
+void ModernOpenGLGraphics::drawImageQuads(const Image *image,
+                                          const ImageQuad *quads, size_t count,
+                                          int x, int y)
+{
+    if (!image || count == 0)
+        return;
+
+    const auto tw = static_cast<float>(image->getTextureWidth());
+    const auto th = static_cast<float>(image->getTextureHeight());
+
+    setImageBatch(image);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ImageQuad &quad = quads[i];
+        const int srcX = image->mBounds.x + quad.srcX;
+        const int srcY = image->mBounds.y + quad.srcY;
+
+        addQuad(x + quad.dstX, y + quad.dstY, quad.dstW, quad.dstH,
+                srcX / tw, srcY / th,
+                (srcX + quad.srcW) / tw, (srcY + quad.srcH) / th);
+    }
+}
+
+void ModernOpenGLGraphics::updateScreen()
+{
+    flush();
+
+    SDL_GL_SwapWindow(mWindow);
+
+    // See OpenGLGraphics::updateScreen
+    if (config.reduceInputLag)
+        glFinish();
+}
+
+void ModernOpenGLGraphics::windowToLogical(int windowX, int windowY,
+                                           float &logicalX, float &logicalY) const
+{
+    logicalX = windowX / mUserScale;
+    logicalY = windowY / mUserScale;
+}
+
+SDL_Surface *ModernOpenGLGraphics::getScreenshot()
+{
+    flush();
+
+    int w, h;
+    SDL_GL_GetDrawableSize(mWindow, &w, &h);
+    GLint pack = 1;
+
+    SDL_Surface *screenshot = SDL_CreateRGBSurface(
+            SDL_SWSURFACE,
+            w, h, 24,
+            0xff0000, 0x00ff00, 0x0000ff, 0x000000);
+
+    if (SDL_MUSTLOCK(screenshot))
+        SDL_LockSurface(screenshot);
+
+    glGetIntegerv(GL_PACK_ALIGNMENT, &pack);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, screenshot->pixels);
+
+    // Flip the screenshot, as OpenGL has 0,0 in bottom left
+    const unsigned int lineSize = 3 * w;
+    std::vector<GLubyte> buf(lineSize);
+
+    for (int i = 0; i < (h / 2); i++)
+    {
+        GLubyte *top = (GLubyte*)screenshot->pixels + lineSize * i;
+        GLubyte *bot = (GLubyte*)screenshot->pixels + lineSize * (h - 1 - i);
+
+        memcpy(buf.data(), top, lineSize);
+        memcpy(top, bot, lineSize);
+        memcpy(bot, buf.data(), lineSize);
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, pack);
+
+    if (SDL_MUSTLOCK(screenshot))
+        SDL_UnlockSurface(screenshot);
+
+    return screenshot;
+}
+
+std::unique_ptr<Image> ModernOpenGLGraphics::createRenderTarget(int width, int height)
+{
+    const int pixelWidth = std::ceil(width * mScaleX);
+    const int pixelHeight = std::ceil(height * mScaleY);
+
+    if (pixelWidth > Image::mTextureSize || pixelHeight > Image::mTextureSize)
+        return {};
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    OpenGLGraphics::bindTexture(GL_TEXTURE_2D, texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+                 pixelWidth, pixelHeight,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 nullptr);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    auto target = std::unique_ptr<Image>(new Image(texture,
+                                                   pixelWidth, pixelHeight,
+                                                   pixelWidth, pixelHeight));
+
+    // Make sure the driver accepts this texture as color attachment
+    bindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, texture, 0);
+    const GLenum status = checkFramebufferStatus(GL_FRAMEBUFFER);
+    framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, 0, 0);
+    bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        return {};
+
+    return target;
+}
+
+void ModernOpenGLGraphics::drawRenderTarget(const Image *target,
+                                            int x, int y,
+                                            int width, int height)
+{
+    setBatch(BatchMode::Premultiplied, target->mGLImage);
+
+    // With premultiplied alpha, the color needs to be faded as well
+    const auto alpha = static_cast<GLubyte>(target->getAlpha() * 255);
+    mQuadColor[0] = mQuadColor[1] = mQuadColor[2] = mQuadColor[3] = alpha;
+
+    // The contents of render targets are upside down
+    const float texX = static_cast<float>(target->getWidth()) /
+                       static_cast<float>(target->getTextureWidth());
+    const float texY = static_cast<float>(target->getHeight()) /
+                       static_cast<float>(target->getTextureHeight());
+
+    addQuad(x, y, width, height, 0.0f, texY, texX, 0.0f);
+}
+
+void ModernOpenGLGraphics::setRenderTarget(Image *target)
+{
+    flush();
+
+    mTarget = target;
+
+    if (target)
+    {
+        bindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+        framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             GL_TEXTURE_2D, target->mGLImage, 0);
+
+        glDisable(GL_SCISSOR_TEST);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    else
+    {
+        framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             GL_TEXTURE_2D, 0, 0);
+        bindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    updateViewport();
+}
+
+void ModernOpenGLGraphics::updateClipRect()
+{
+    flush();
+
+    if (mClipRects.empty())
+    {
+        glDisable(GL_SCISSOR_TEST);
+        return;
+    }
+
+    const gcn::Rectangle &clipRect = mClipRects.top();
+
+    const int x = (int) (clipRect.x * mScaleX);
+    const int y = (int) ((mHeight - clipRect.y - clipRect.height) * mScaleY);
+    const int width = (int) (clipRect.width * mScaleX);
+    const int height = (int) (clipRect.height * mScaleY);
+
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, width, height);
+}
+
+void ModernOpenGLGraphics::drawPoint(int x, int y)
+{
+    fillRectangle(gcn::Rectangle(x, y, 1, 1));
+}
+
+void ModernOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
+{
+    // Horizontal and vertical lines are drawn as quads, to match pixels
+    if (x1 == x2 || y1 == y2)
+    {
+        fillRectangle(gcn::Rectangle(std::min(x1, x2), std::min(y1, y2),
+                                     std::abs(x2 - x1) + 1,
+                                     std::abs(y2 - y1) + 1));
+        return;
+    }
+
+    setBatch(BatchMode::Lines, 0);
+    mQuadColor[0] = mColor.r;
+    mQuadColor[1] = mColor.g;
+    mQuadColor[2] = mColor.b;
+    mQuadColor[3] = mColor.a;
+    addQuad(x1 + 0.5f, y1 + 0.5f, x2 - x1, y2 - y1);
+}
+
+void ModernOpenGLGraphics::drawRectangle(const gcn::Rectangle &rect)
+{
+    const int x = rect.x;
+    const int y = rect.y;
+    const int w = rect.width;
+    const int h = rect.height;
+
+    fillRectangle(gcn::Rectangle(x, y, w, 1));
+    if (h > 1)
+        fillRectangle(gcn::Rectangle(x, y + h - 1, w, 1));
+    if (h > 2)
+    {
+        fillRectangle(gcn::Rectangle(x, y + 1, 1, h - 2));
+        if (w > 1)
+            fillRectangle(gcn::Rectangle(x + w - 1, y + 1, 1, h - 2));
+    }
+}
+
+void ModernOpenGLGraphics::fillRectangle(const gcn::Rectangle &rect)
+{
+    setBatch(BatchMode::Colored, 0);
+    mQuadColor[0] = mColor.r;
+    mQuadColor[1] = mColor.g;
+    mQuadColor[2] = mColor.b;
+    mQuadColor[3] = mColor.a;
+    addQuad(rect.x, rect.y, rect.width, rect.height);
+}
+
+#endif // USE_OPENGL
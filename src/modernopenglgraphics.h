@@ -0,0 +1,171 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef USE_OPENGL
+#include "graphics.h"
+
+#define NO_SDL_GLEXT
+
+#include <SDL_opengl.h>
+
+#include <memory>
+#include <vector>
+
+struct VideoSettings;
+
+/**
+ * A renderer using an OpenGL 3.3 core profile context.
+ *
+ * Everything is drawn as instanced quads. Consecutive quads using the same
+ * texture and blend mode are collected into a batch, which is uploaded
+ * through a streaming vertex buffer and drawn with a single call.
+ */
+class ModernOpenGLGraphics final : public Graphics
+{
+    public:
+        /**
+         * Creates a core profile context and the renderer. Returns
+         * <code>nullptr</code> when OpenGL 3.3 is not available.
+         */
+        static std::unique_ptr<ModernOpenGLGraphics> create(SDL_Window *window,
+                                                            const VideoSettings &settings);
+
+        ModernOpenGLGraphics(SDL_Window *window, SDL_GLContext glContext);
+
+        ~ModernOpenGLGraphics() override;
+
+        /**
+         * Called before a texture is deleted, so that any pending quads
+         * using it are drawn first.
+         */
+        static void textureDeleted(GLuint texture);
+
+        void setVSync(bool sync) override;
+
+        void updateSize(int windowWidth, int windowHeight, float scale) override;
+
+        bool drawRescaledImage(const Image *image, int srcX, int srcY,
+                               int dstX, int dstY,
+                               int width, int height,
+                               int desiredWidth, int desiredHeight) override;
+
+        bool drawRescaledImageF(const Image *image,
+                                int srcX, int srcY,
+                                float dstX, float dstY,
+                                int width, int height,
+                                float desiredWidth, float desiredHeight) override;
+
+        void drawRescaledImagePattern(const Image *image,
+                                      int srcX, int srcY,
+                                      int srcW, int srcH,
+                                      int dstX, int dstY,
+                                      int dstW, int dstH,
+                                      int scaledWidth, int scaledHeight) override;
+
+        void drawImageQuads(const Image *image,
+                            const ImageQuad *quads, size_t count,
+                            int x, int y) override;
+
+        void updateScreen() override;
+
+        void windowToLogical(int windowX, int windowY,
+                             float &logicalX, float &logicalY) const override;
+
+        void drawPoint(int x, int y) override;
+
+        void drawLine(int x1, int y1, int x2, int y2) override;
+
+        void drawRectangle(const gcn::Rectangle &rect) override;
+
+        void fillRectangle(const gcn::Rectangle &rect) override;
+
+        SDL_Surface *getScreenshot() override;
+
+        std::unique_ptr<Image> createRenderTarget(int width, int height) override;
+
+        void drawRenderTarget(const Image *target,
+                              int x, int y,
+                              int width, int height) override;
+
+    protected:
+        void updateClipRect() override;
+        void setRenderTarget(Image *target) override;
+
+    private:
+        enum class BatchMode
+        {
+            Textured,
+            Premultiplied,  /**< Textured with premultiplied alpha */
+            Colored,
+            Lines
+        };
+
+        /**
+         * The per-instance vertex data of a quad. For lines, the rectangle
+         * holds the start point and the offset to the end point.
+         */
+        struct Quad
+        {
+            GLfloat x, y, width, height;
+            GLfloat texX1, texY1, texX2, texY2;
+            GLubyte color[4];
+        };
+
+        bool initialize();
+
+        void setBatch(BatchMode mode, GLuint texture);
+        void setImageBatch(const Image *image);
+
+        void addQuad(float x, float y, float width, float height,
+                     float texX1 = 0.0f, float texY1 = 0.0f,
+                     float texX2 = 0.0f, float texY2 = 0.0f);
+
+        void flush() override;
+
+        void updateViewport();
+
+        SDL_Window *mWindow = nullptr;
+        SDL_GLContext mContext = nullptr;
+
+        GLuint mTexturedProgram = 0;
+        GLuint mColoredProgram = 0;
+        GLint mTexturedScreenSize = -1;
+        GLint mColoredScreenSize = -1;
+
+        GLuint mVertexArray = 0;
+        GLuint mCornerBuffer = 0;
+        GLuint mQuadBuffer = 0;
+        size_t mQuadBufferOffset = 0;
+        GLuint mFramebuffer = 0;
+
+        std::vector<Quad> mQuads;
+        BatchMode mBatchMode = BatchMode::Textured;
+        GLuint mBatchTexture = 0;
+        GLubyte mQuadColor[4] = { 255, 255, 255, 255 };   /**< Color of added quads */
+
+        Image *mTarget = nullptr;
+
+        float mUserScale = 1.0f;
+        float mScaleX = 1.0f;
+        float mScaleY = 1.0f;
+};
+#endif //USE_OPENGL
@@ -42,8 +42,6 @@
 
 #include "utils/gettext.h"
 
-#define POSITION_DIFF_TOLERANCE 48
-
 namespace ManaServ {
 
 BeingHandler::BeingHandler()
@@ -265,17 +263,16 @@ void BeingHandler::handleBeingsMoveMessage(MessageIn &msg)
         if (being == local_player)
             continue;
 
-        // If the position differs too much from the actual one, we resync
-        // the being position
-        if (flags & MOVING_POSITION)
-        {
-            Vector serverPos(sx, sy);
-            if (serverPos.length()
-                - being->getPosition().length() > POSITION_DIFF_TOLERANCE)
-                being->setPosition(serverPos);
-        }
+        const bool hasPosition = flags & MOVING_POSITION;
+        const bool hasDestination = flags & MOVING_DESTINATION;
 
-        if (flags & MOVING_DESTINATION)
+        // There is no latency estimate for this server, so the position is
+        // smoothed but not extrapolated
+        if (hasPosition && hasDestination)
+            being->reconcileMovement(Vector(sx, sy), Vector(dx, dy), 0);
+        else if (hasPosition)
+            being->reconcilePosition(Vector(sx, sy));
+        else
             being->setDestination(dx, dy);
     }
 }
@@ -23,9 +23,13 @@
 
 #include "log.h"
 
+#include "net/packetcapture.h"
+
 #include "net/manaserv/internal.h"
 #include "net/manaserv/messageout.h"
 
+#include "utils/mutex.h"
+
 #include <string>
 
 namespace ManaServ
@@ -55,11 +59,21 @@ bool Connection::connect(const std::string &address, enet_uint16 port)
         return false;
     }
 
+    if (auto replay = Net::getPacketReplay())
+    {
+        replay->beginConnection();
+        mReplayConnected = true;
+        mPort = port;
+        return true;
+    }
+
     ENetAddress enetAddress;
 
     enet_address_set_host(&enetAddress, address.c_str());
     enetAddress.port = port;
 
+    MutexLocker lock(&hostMutex);
+
     // Initiate the connection, allocating channel 0.
     mConnection = enet_host_connect(mClient, &enetAddress, 1, 0);
 
@@ -72,14 +86,21 @@ bool Connection::connect(const std::string &address, enet_uint16 port)
 
     mPort = port;
 
+    if (auto capture = Net::getPacketCapture())
+        capture->writeConnect(ServerType::ManaServ);
+
     return true;
 }
 
 void Connection::disconnect()
 {
+    mReplayConnected = false;
+
     if (!mConnection)
         return;
 
+    MutexLocker lock(&hostMutex);
+
     enet_peer_disconnect(mConnection, 0);
     enet_host_flush(mClient);
     enet_peer_reset(mConnection);
@@ -89,6 +110,10 @@ void Connection::disconnect()
 
 bool Connection::isConnected()
 {
+    if (mReplayConnected)
+        return true;
+
+    MutexLocker lock(&hostMutex);
     return mConnection && mConnection->state == ENET_PEER_STATE_CONNECTED;
 }
 
@@ -100,9 +125,15 @@ void Connection::send(const ManaServ::MessageOut &msg)
         return;
     }
 
+    // Nobody is listening when replaying a capture
+    if (mReplayConnected)
+        return;
+
     ENetPacket *packet = enet_packet_create(msg.getData(),
                                             msg.getDataSize(),
                                             ENET_PACKET_FLAG_RELIABLE);
+
+    MutexLocker lock(&hostMutex);
     enet_peer_send(mConnection, 0, packet);
 }
 
@@ -73,5 +73,6 @@ namespace ManaServ
             ENetPeer *mConnection = nullptr;
             ENetHost *mClient;
             State mState = OK;
+            bool mReplayConnected = false;
     };
 }
@@ -21,7 +21,15 @@
 
 #pragma once
 
+class Mutex;
+
 namespace ManaServ
 {
     extern int connections;
+
+    /**
+     * Guards access to the ENet host, which is serviced by the network
+     * thread.
+     */
+    extern Mutex hostMutex;
 }
@@ -27,12 +27,31 @@
 
 namespace ManaServ {
 
-MessageOut::MessageOut(uint16_t id):
-    mData(nullptr),
-    mPos(0),
-    mDataSize(0),
-    mDebugMode(false)
+/**
+ * Buffers of destroyed messages, ready to be reused by new messages.
+ */
+static std::vector<std::vector<char>> bufferPool;
+
+// Enough for nearly all messages, including the debug information
+static constexpr size_t INITIAL_CAPACITY = 64;
+
+// Larger buffers are not kept, to avoid holding on to a lot of memory after
+// an occasional large message
+static constexpr size_t MAX_POOLED_CAPACITY = 4096;
+static constexpr size_t MAX_POOLED_BUFFERS = 16;
+
+MessageOut::MessageOut(uint16_t id)
 {
+    if (!bufferPool.empty())
+    {
+        mData = std::move(bufferPool.back());
+        bufferPool.pop_back();
+    }
+    else
+    {
+        mData.reserve(INITIAL_CAPACITY);
+    }
+
     bool debug = true;
     if (debug)
         id |= ManaServ::XXMSG_DEBUG_FLAG;
@@ -43,13 +62,19 @@ MessageOut::MessageOut(uint16_t id):
 
 MessageOut::~MessageOut()
 {
-    free(mData);
+    if (mData.capacity() <= MAX_POOLED_CAPACITY &&
+        bufferPool.size() < MAX_POOLED_BUFFERS)
+    {
+        mData.clear();
+        bufferPool.push_back(std::move(mData));
+    }
 }
 
-void MessageOut::expand(size_t bytes)
+char *MessageOut::expand(size_t bytes)
 {
-    mData = (char*)realloc(mData, mPos + bytes);
-    mDataSize = mPos + bytes;
+    const size_t pos = mData.size();
+    mData.resize(pos + bytes);
+    return mData.data() + pos;
 }
 
 void MessageOut::writeInt8(uint8_t value)
@@ -57,9 +82,7 @@ void MessageOut::writeInt8(uint8_t value)
     if (mDebugMode)
         writeValueType(ManaServ::Int8);
 
-    expand(1);
-    mData[mPos] = value;
-    mPos += 1;
+    *expand(1) = value;
 }
 
 void MessageOut::writeInt16(uint16_t value)
@@ -67,10 +90,8 @@ void MessageOut::writeInt16(uint16_t value)
     if (mDebugMode)
         writeValueType(ManaServ::Int16);
 
-    expand(2);
     uint16_t t = ENET_HOST_TO_NET_16(value);
-    memcpy(mData + mPos, &t, 2);
-    mPos += 2;
+    memcpy(expand(2), &t, 2);
 }
 
 void MessageOut::writeInt32(uint32_t value)
@@ -78,10 +99,8 @@ void MessageOut::writeInt32(uint32_t value)
     if (mDebugMode)
         writeValueType(ManaServ::Int32);
 
-    expand(4);
     uint32_t t = ENET_HOST_TO_NET_32(value);
-    memcpy(mData + mPos, &t, 4);
-    mPos += 4;
+    memcpy(expand(4), &t, 4);
 }
 
 void MessageOut::writeString(const std::string &string, int length)
@@ -104,24 +123,21 @@ void MessageOut::writeString(const std::string &string, int length)
         // Make sure the length of the string is no longer than specified
         stringLength = length;
     }
-    expand(length);
+    char *data = expand(length);
 
     // Write the actual string
-    memcpy(mData + mPos, string.data(), stringLength);
+    memcpy(data, string.data(), stringLength);
 
     if (length > stringLength)
     {
         // Pad remaining space with zeros
-        memset(mData + mPos + stringLength, '\0', length - stringLength);
+        memset(data + stringLength, '\0', length - stringLength);
     }
-    mPos += length;
 }
 
 void MessageOut::writeValueType(ManaServ::ValueType type)
 {
-    expand(1);
-    mData[mPos] = type;
-    mPos += 1;
+    *expand(1) = type;
 }
 
 } // namespace ManaServ
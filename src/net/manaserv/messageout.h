@@ -25,12 +25,17 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace ManaServ {
 
 /**
  * Used for building an outgoing message to manaserv.
  *
+ * The message data is written to a buffer taken from a pool, which is
+ * returned to the pool when the message is destroyed. Since the buffers keep
+ * their capacity, building a message usually doesn't allocate.
+ *
  * \ingroup Network
  */
 class MessageOut
@@ -40,6 +45,9 @@ class MessageOut
 
         ~MessageOut();
 
+        MessageOut(const MessageOut &) = delete;
+        MessageOut &operator=(const MessageOut &) = delete;
+
         /**
          * Writes an unsigned 8-bit integer to the message.
          */
@@ -64,29 +72,24 @@ class MessageOut
         /**
          * Returns the content of the message.
          */
-        char *getData() const { return mData; }
+        const char *getData() const { return mData.data(); }
 
         /**
          * Returns the length of the data.
          */
-        unsigned int getDataSize() const { return mDataSize; }
+        unsigned int getDataSize() const { return mData.size(); }
 
     private:
         /**
-         * Expand the packet data to be able to hold more data.
-         *
-         * NOTE: For performance enhancements this method could allocate extra
-         * memory in advance instead of expanding size every time more data is
-         * added.
+         * Expand the packet data to be able to hold more data. Returns a
+         * pointer to the start of the new data.
          */
-        void expand(size_t size);
+        char *expand(size_t size);
 
         void writeValueType(ManaServ::ValueType type);
 
-        char *mData;                /**< Data building up. */
-        unsigned int mPos;          /**< Position in the data. */
-        unsigned int mDataSize;     /**< Size of data. */
-        bool mDebugMode;            /**< Include debugging information. */
+        std::vector<char> mData;    /**< Data building up. */
+        bool mDebugMode = false;    /**< Include debugging information. */
 };
 
 } // namespace ManaServ
@@ -23,27 +23,107 @@
 
 #include "log.h"
 
+#include "net/packetcapture.h"
+
 #include "net/manaserv/connection.h"
 #include "net/manaserv/internal.h"
 #include "net/manaserv/messagehandler.h"
 #include "net/manaserv/messagein.h"
 
+#include "utils/mutex.h"
+#include "utils/stringutils.h"
+
 #include <enet/enet.h>
 
+#include <SDL_thread.h>
+#include <SDL_timer.h>
+
+#include <atomic>
 #include <map>
+#include <vector>
 
 /**
  * The local host which is shared for all outgoing connections.
  */
 namespace {
     ENetHost *client;
+
+    SDL_Thread *serviceThread;
+    std::atomic<bool> serviceRunning;
+
+    /**
+     * Packets received by the network thread, waiting to be dispatched on
+     * the main thread. Guarded by the host mutex.
+     */
+    std::vector<ENetPacket *> receivedPackets;
+
+    /**
+     * The longest time the network thread waits for incoming data. ENet
+     * also needs to be serviced regularly to resend packets and keep the
+     * connections alive.
+     */
+    constexpr enet_uint32 SERVICE_INTERVAL = 50;
+
+    /**
+     * Whether the end of the packet replay has been reported.
+     */
+    bool replayFinished;
 }
 
 namespace ManaServ
 {
 
+Mutex hostMutex;
+
 static std::map<unsigned short, MessageHandler *> mMessageHandlers;
 
+/**
+ * Services the ENet host as soon as data arrives, independently of the
+ * frame rate, so that incoming packets are acknowledged without delay.
+ */
+static int serviceHost(void *)
+{
+    while (serviceRunning)
+    {
+        // Wait without holding the lock, so that the main thread can keep
+        // sending messages in the meantime.
+        enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+        if (enet_socket_wait(client->socket, &condition, SERVICE_INTERVAL) < 0)
+            SDL_Delay(SERVICE_INTERVAL);
+
+        MutexLocker lock(&hostMutex);
+        ENetEvent event;
+
+        while (enet_host_service(client, &event, 0) > 0)
+        {
+            switch (event.type)
+            {
+                case ENET_EVENT_TYPE_CONNECT:
+                    Log::info("Connected to port %d.", event.peer->address.port);
+                    // Store any relevant server information here.
+                    event.peer->data = nullptr;
+                    break;
+
+                case ENET_EVENT_TYPE_RECEIVE:
+                    receivedPackets.push_back(event.packet);
+                    break;
+
+                case ENET_EVENT_TYPE_DISCONNECT:
+                    Log::info("Disconnected.");
+                    // Reset the server information.
+                    event.peer->data = nullptr;
+                    break;
+
+                case ENET_EVENT_TYPE_NONE:
+                default:
+                    break;
+            }
+        }
+    }
+
+    return 0;
+}
+
 void initialize()
 {
     if (enet_initialize())
@@ -57,6 +137,16 @@ void initialize()
     {
         Log::critical("Failed to create the local host.");
     }
+
+    replayFinished = false;
+
+    serviceRunning = true;
+    serviceThread = SDL_CreateThread(serviceHost, "ENet", nullptr);
+
+    if (!serviceThread)
+    {
+        Log::critical("Failed to create the network thread.");
+    }
 }
 
 void finalize()
@@ -70,6 +160,14 @@ void finalize()
                       "are network connections left!");
     }
 
+    serviceRunning = false;
+    SDL_WaitThread(serviceThread, nullptr);
+    serviceThread = nullptr;
+
+    for (ENetPacket *packet : receivedPackets)
+        enet_packet_destroy(packet);
+    receivedPackets.clear();
+
     clearNetworkHandlers();
     enet_deinitialize();
 }
@@ -104,14 +202,13 @@ void clearNetworkHandlers()
 
 
 /**
- * Dispatches a message to the appropriate message handler and
- * destroys it afterwards.
+ * Dispatches a message to the appropriate message handler.
  */
 namespace
 {
-    void dispatchMessage(ENetPacket *packet)
+    void dispatchMessage(const char *data, size_t length)
     {
-        MessageIn msg((const char *)packet->data, packet->dataLength);
+        MessageIn msg(data, length);
 
         auto iter = mMessageHandlers.find(msg.getId());
 
@@ -119,49 +216,90 @@ namespace
         {
             //Log::info("Received packet %x (%i B)",
             //          msg.getId(), msg.getLength());
+            Net::PacketStats *stats = Net::getPacketStats();
+            const uint64_t start = stats ? Net::PacketStats::now() : 0;
+
             iter->second->handleMessage(msg);
+
+            if (stats)
+                stats->record(msg.getId(), Net::PacketStats::now() - start,
+                              msg.getLength());
         }
         else
         {
             Log::info("Unhandled packet %x (%i B)",
                       msg.getId(), msg.getLength());
         }
+    }
+
+    void dispatchPacket(ENetPacket *packet)
+    {
+        if (auto capture = Net::getPacketCapture())
+            capture->writeData(packet->data, packet->dataLength);
+
+        dispatchMessage((const char *)packet->data, packet->dataLength);
 
         // Clean up the packet now that we're done using it.
         enet_packet_destroy(packet);
     }
-}
-
-void flush()
-{
-    ENetEvent event;
 
-    // Check if there are any new events
-    while (enet_host_service(client, &event, 0) > 0)
+    /**
+     * Dispatches the packets that are due from the packet replay.
+     */
+    void dispatchReplay(Net::PacketReplay *replay)
     {
-        switch (event.type)
+        Net::PacketStats *stats = Net::getPacketStats();
+        stats->beginDispatch();
+
+        const uint64_t start = Net::PacketStats::now();
+        const uint64_t budget = SDL_GetPerformanceFrequency() / 10;
+
+        while (const std::vector<char> *data = replay->nextData())
         {
-            case ENET_EVENT_TYPE_CONNECT:
-                Log::info("Connected to port %d.", event.peer->address.port);
-                // Store any relevant server information here.
-                event.peer->data = nullptr;
-                break;
+            dispatchMessage(data->data(), data->size());
 
-            case ENET_EVENT_TYPE_RECEIVE:
-                dispatchMessage(event.packet);
+            // Leave some packets for the next frame when replaying as fast as
+            // possible, so that state changes can be processed in between.
+            if (!replay->isRealTime() && Net::PacketStats::now() - start > budget)
                 break;
+        }
 
-            case ENET_EVENT_TYPE_DISCONNECT:
-                Log::info("Disconnected.");
-                // Reset the server information.
-                event.peer->data = nullptr;
-                break;
+        stats->endDispatch();
 
-            case ENET_EVENT_TYPE_NONE:
-            default:
-                break;
+        if (replay->atEnd() && !replayFinished)
+        {
+            replayFinished = true;
+            Log::info("Replay finished.");
+            stats->report([](uint16_t id) { return strprintf("0x%x", id); });
         }
     }
 }
 
+void flush()
+{
+    if (auto replay = Net::getPacketReplay())
+    {
+        dispatchReplay(replay);
+        return;
+    }
+
+    static std::vector<ENetPacket *> packets;
+
+    {
+        MutexLocker lock(&hostMutex);
+
+        // Send the messages queued during this frame
+        enet_host_flush(client);
+
+        packets.swap(receivedPackets);
+    }
+
+    // The lock is not held while dispatching, since the handlers may send
+    // messages in response
+    for (ENetPacket *packet : packets)
+        dispatchPacket(packet);
+
+    packets.clear();
+}
+
 }
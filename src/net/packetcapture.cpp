@@ -0,0 +1,318 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/packetcapture.h"
+
+#include "log.h"
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace Net {
+
+static const char CAPTURE_MAGIC[8] = { 'M', 'A', 'N', 'A', 'C', 'A', 'P', '1' };
+
+static std::unique_ptr<PacketCapture> packetCapture;
+static std::unique_ptr<PacketReplay> packetReplay;
+static std::unique_ptr<PacketStats> packetStats;
+
+static void writeUint32(std::ostream &out, uint32_t value)
+{
+    value = SDL_SwapLE32(value);
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static bool readUint32(std::istream &in, uint32_t &value)
+{
+    if (!in.read(reinterpret_cast<char *>(&value), sizeof(value)))
+        return false;
+    value = SDL_SwapLE32(value);
+    return true;
+}
+
+
+PacketCapture::~PacketCapture()
+{
+    close();
+}
+
+bool PacketCapture::open(const std::string &path)
+{
+    MutexLocker lock(&mMutex);
+
+    mFile.open(path, std::ios_base::binary | std::ios_base::trunc);
+    if (!mFile.is_open())
+    {
+        Log::warn("Could not open packet capture file %s", path.c_str());
+        return false;
+    }
+
+    mFile.write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    mBaseTicks = SDL_GetTicks();
+
+    Log::info("Capturing inbound network traffic to %s", path.c_str());
+    return true;
+}
+
+void PacketCapture::close()
+{
+    MutexLocker lock(&mMutex);
+
+    if (mFile.is_open())
+        mFile.close();
+}
+
+void PacketCapture::writeConnect(ServerType type)
+{
+    MutexLocker lock(&mMutex);
+
+    const auto payload = static_cast<uint8_t>(type);
+    mBaseTicks = SDL_GetTicks();
+    writeRecord(Connect, &payload, sizeof(payload));
+}
+
+void PacketCapture::writeData(const void *data, uint32_t length)
+{
+    MutexLocker lock(&mMutex);
+    writeRecord(Data, data, length);
+}
+
+void PacketCapture::writeRecord(RecordType type, const void *data,
+                                uint32_t length)
+{
+    if (!mFile.is_open())
+        return;
+
+    mFile.put(static_cast<char>(type));
+    writeUint32(mFile, SDL_GetTicks() - mBaseTicks);
+    writeUint32(mFile, length);
+    mFile.write(static_cast<const char *>(data), length);
+}
+
+
+bool PacketReplay::open(const std::string &path, bool realTime)
+{
+    mFile.open(path, std::ios_base::binary);
+    if (!mFile.is_open())
+    {
+        Log::warn("Could not open packet replay file %s", path.c_str());
+        return false;
+    }
+
+    char magic[sizeof(CAPTURE_MAGIC)];
+    if (!mFile.read(magic, sizeof(magic)) ||
+        memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0)
+    {
+        Log::warn("%s is not a packet capture file", path.c_str());
+        return false;
+    }
+
+    mRealTime = realTime;
+    mAtEnd = !readRecord();
+
+    if (!mAtEnd && mType == PacketCapture::Connect && !mData.empty())
+        mServerType = static_cast<ServerType>(mData[0]);
+
+    Log::info("Replaying network traffic from %s (%s)", path.c_str(),
+              realTime ? "real time" : "as fast as possible");
+    return true;
+}
+
+void PacketReplay::beginConnection()
+{
+    // When the client connects before all data of the previous connection
+    // was handed out, the connect record is skipped once it is reached.
+    if (!mAtEnd && mType == PacketCapture::Connect)
+        mAtEnd = !readRecord();
+    else
+        ++mEarlyConnects;
+
+    mConnected = true;
+    mBaseTicks = SDL_GetTicks();
+}
+
+const std::vector<char> *PacketReplay::nextData()
+{
+    while (!mAtEnd && mType == PacketCapture::Connect && mEarlyConnects > 0)
+    {
+        --mEarlyConnects;
+        mAtEnd = !readRecord();
+    }
+
+    if (mAtEnd || !mConnected || mType != PacketCapture::Data)
+        return nullptr;
+
+    if (mRealTime && SDL_GetTicks() - mBaseTicks < mTime)
+        return nullptr;
+
+    mCurrent.swap(mData);
+    mAtEnd = !readRecord();
+    return &mCurrent;
+}
+
+bool PacketReplay::readRecord()
+{
+    const int type = mFile.get();
+    uint32_t length;
+
+    if (type == std::char_traits<char>::eof() ||
+        !readUint32(mFile, mTime) ||
+        !readUint32(mFile, length))
+        return false;
+
+    mType = static_cast<PacketCapture::RecordType>(type);
+    mData.resize(length);
+    return static_cast<bool>(mFile.read(mData.data(), length));
+}
+
+
+uint64_t PacketStats::now()
+{
+    return SDL_GetPerformanceCounter();
+}
+
+void PacketStats::beginDispatch()
+{
+    mDispatchStart = now();
+    if (!mFirstDispatch)
+        mFirstDispatch = mDispatchStart;
+}
+
+void PacketStats::endDispatch()
+{
+    mLastDispatch = now();
+
+    const uint64_t duration = mLastDispatch - mDispatchStart;
+    ++mDispatches;
+    mDispatchTotal += duration;
+    mDispatchMax = std::max(mDispatchMax, duration);
+}
+
+void PacketStats::record(uint16_t id, uint64_t duration, unsigned length)
+{
+    Entry &entry = mEntries[id];
+    ++entry.count;
+    entry.bytes += length;
+    entry.total += duration;
+    entry.max = std::max(entry.max, duration);
+}
+
+void PacketStats::report(const std::function<std::string(uint16_t)> &messageName) const
+{
+    const double frequency = SDL_GetPerformanceFrequency();
+    const auto toMs = [frequency](uint64_t ticks) {
+        return ticks * 1000.0 / frequency;
+    };
+
+    unsigned messages = 0;
+    uint64_t handlerTotal = 0;
+    for (auto &[_, entry] : mEntries)
+    {
+        messages += entry.count;
+        handlerTotal += entry.total;
+    }
+
+    const double wallMs = toMs(mLastDispatch - mFirstDispatch);
+    const double handlerMs = toMs(handlerTotal);
+
+    Log::info("Replay: %u messages in %.1f ms wall time, %.1f ms in handlers "
+              "(%.0f messages/s handler throughput)",
+              messages, wallMs, handlerMs,
+              handlerMs > 0 ? messages * 1000.0 / handlerMs : 0.0);
+
+    if (mDispatches)
+    {
+        Log::info("Replay: %u dispatch calls, average %.3f ms, worst %.3f ms "
+                  "per frame",
+                  mDispatches, toMs(mDispatchTotal) / mDispatches,
+                  toMs(mDispatchMax));
+    }
+
+    // Most expensive messages first
+    std::vector<std::pair<uint16_t, const Entry *>> sorted;
+    for (auto &[id, entry] : mEntries)
+        sorted.emplace_back(id, &entry);
+
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.second->total > b.second->total;
+    });
+
+    for (auto &[id, entry] : sorted)
+    {
+        Log::info("Replay: %-32s (0x%04x) %7u x, %8llu bytes, "
+                  "total %9.3f ms, average %7.1f us, worst %7.1f us",
+                  messageName(id).c_str(), id, entry->count,
+                  static_cast<unsigned long long>(entry->bytes),
+                  toMs(entry->total),
+                  toMs(entry->total) * 1000.0 / entry->count,
+                  toMs(entry->max) * 1000.0);
+    }
+}
+
+
+bool startPacketCapture(const std::string &path)
+{
+    packetCapture = std::make_unique<PacketCapture>();
+    if (!packetCapture->open(path))
+    {
+        packetCapture.reset();
+        return false;
+    }
+    return true;
+}
+
+bool startPacketReplay(const std::string &path, bool realTime)
+{
+    packetReplay = std::make_unique<PacketReplay>();
+    if (!packetReplay->open(path, realTime))
+    {
+        packetReplay.reset();
+        return false;
+    }
+    packetStats = std::make_unique<PacketStats>();
+    return true;
+}
+
+void stopPacketCapture()
+{
+    packetCapture.reset();
+    packetReplay.reset();
+    packetStats.reset();
+}
+
+PacketCapture *getPacketCapture()
+{
+    return packetCapture.get();
+}
+
+PacketReplay *getPacketReplay()
+{
+    return packetReplay.get();
+}
+
+PacketStats *getPacketStats()
+{
+    return packetStats.get();
+}
+
+} // namespace Net
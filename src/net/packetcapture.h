@@ -0,0 +1,208 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/serverinfo.h"
+
+#include "utils/mutex.h"
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Net {
+
+/**
+ * Records raw inbound network data to a file, so that a session can be
+ * replayed offline through the message handlers using PacketReplay.
+ *
+ * The file starts with a magic header, followed by records consisting of a
+ * type byte, a timestamp in milliseconds relative to the last connect, the
+ * payload length and the payload. All integers are stored little-endian.
+ */
+class PacketCapture
+{
+    public:
+        enum RecordType : uint8_t
+        {
+            Connect = 0,    /**< Payload is the ServerType as one byte */
+            Data = 1        /**< Payload is raw inbound data */
+        };
+
+        ~PacketCapture();
+
+        bool open(const std::string &path);
+        void close();
+
+        bool isOpen() const { return mFile.is_open(); }
+
+        /**
+         * Marks the start of a new connection. Timestamps of following data
+         * records are relative to this point.
+         */
+        void writeConnect(ServerType type);
+
+        /**
+         * Records a block of inbound data. For TmwAthena this is whatever
+         * chunk the socket returned, for ManaServ it is one whole packet.
+         * May be called from the network thread.
+         */
+        void writeData(const void *data, uint32_t length);
+
+    private:
+        void writeRecord(RecordType type, const void *data, uint32_t length);
+
+        std::ofstream mFile;
+        uint32_t mBaseTicks = 0;
+        Mutex mMutex;
+};
+
+/**
+ * Reads back a file written by PacketCapture. Data records are handed out
+ * either as soon as they are asked for, or when they are due according to
+ * their timestamp when replaying in real time.
+ *
+ * Connect records act as barriers: data following them is only handed out
+ * after the client has called beginConnection(), which keeps the replay in
+ * step with the login flow of the client.
+ */
+class PacketReplay
+{
+    public:
+        bool open(const std::string &path, bool realTime);
+
+        /**
+         * Returns the server type recorded with the first connection.
+         */
+        ServerType getServerType() const { return mServerType; }
+
+        bool isRealTime() const { return mRealTime; }
+
+        /**
+         * Called when the client connects. Consumes a pending connect record.
+         */
+        void beginConnection();
+
+        /**
+         * Returns the next due data record, or nullptr when none is due yet.
+         * The returned pointer stays valid until the next call.
+         */
+        const std::vector<char> *nextData();
+
+        /**
+         * Whether all records have been handed out.
+         */
+        bool atEnd() const { return mAtEnd; }
+
+    private:
+        bool readRecord();
+
+        std::ifstream mFile;
+        bool mRealTime = false;
+        bool mAtEnd = true;
+        bool mConnected = false;
+        unsigned mEarlyConnects = 0;
+        ServerType mServerType = ServerType::Unknown;
+        uint32_t mBaseTicks = 0;
+
+        PacketCapture::RecordType mType = PacketCapture::Data;
+        uint32_t mTime = 0;
+        std::vector<char> mData;
+        std::vector<char> mCurrent;
+};
+
+/**
+ * Collects the time spent in the message handlers, per message id and per
+ * dispatch call, to judge handler throughput and its impact on frame time.
+ */
+class PacketStats
+{
+    public:
+        /**
+         * Returns the current high-resolution time, in counter units.
+         */
+        static uint64_t now();
+
+        void beginDispatch();
+        void endDispatch();
+
+        void record(uint16_t id, uint64_t duration, unsigned length);
+
+        /**
+         * Writes a summary to the log. The \a messageName function is used to
+         * turn message ids into readable names.
+         */
+        void report(const std::function<std::string(uint16_t)> &messageName) const;
+
+    private:
+        struct Entry
+        {
+            unsigned count = 0;
+            uint64_t bytes = 0;
+            uint64_t total = 0;
+            uint64_t max = 0;
+        };
+
+        std::map<uint16_t, Entry> mEntries;
+
+        uint64_t mDispatchStart = 0;
+        uint64_t mFirstDispatch = 0;
+        uint64_t mLastDispatch = 0;
+        unsigned mDispatches = 0;
+        uint64_t mDispatchTotal = 0;
+        uint64_t mDispatchMax = 0;
+};
+
+/**
+ * Starts capturing inbound traffic to the given file.
+ */
+bool startPacketCapture(const std::string &path);
+
+/**
+ * Replays inbound traffic from the given file instead of connecting to a
+ * server. Outbound messages are dropped.
+ */
+bool startPacketReplay(const std::string &path, bool realTime);
+
+/**
+ * Closes any capture or replay file.
+ */
+void stopPacketCapture();
+
+/**
+ * Returns the active capture, or nullptr when not capturing.
+ */
+PacketCapture *getPacketCapture();
+
+/**
+ * Returns the active replay, or nullptr when not replaying.
+ */
+PacketReplay *getPacketReplay();
+
+/**
+ * Returns the handler statistics, which are only collected while replaying.
+ */
+PacketStats *getPacketStats();
+
+} // namespace Net
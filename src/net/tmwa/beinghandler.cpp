@@ -43,13 +43,8 @@
 #include "resources/hairdb.h"
 #include "resources/statuseffectdb.h"
 
-#include <cmath>
-
 namespace TmwAthena {
 
-// Number of pixels where we decide that the position doesn't need to be reset.
-static const float POS_DEST_DIFF_TOLERANCE = 48.0f;
-
 BeingHandler::BeingHandler()
 {
     static const Uint16 _messages[] =
@@ -139,16 +134,11 @@ static void handleMoveMessage(Map *map, Being *dstBeing,
     {
         Vector pos = map->getTileCenter(srcX, srcY);
         Vector dest = map->getTileCenter(dstX, dstY);
-        Vector beingPos = dstBeing->getPosition();
-
-        // Don't set the position as the movement algorithm
-        // can guess it and it would break the animation played,
-        // when we're close enough.
-        if (std::abs(beingPos.x - pos.x) > POS_DEST_DIFF_TOLERANCE
-            || std::abs(beingPos.y - pos.y) > POS_DEST_DIFF_TOLERANCE)
-            dstBeing->setPosition(pos);
 
-        dstBeing->setDestination(dest.x, dest.y);
+        // The message took about half a round trip to arrive
+        const int latency = local_player ? local_player->getRoundTripTime() / 2
+                                         : 0;
+        dstBeing->reconcileMovement(pos, dest, latency);
     }
 }
 
@@ -159,13 +149,7 @@ static void handlePosMessage(Map *map, Being *dstBeing, Uint16 x, Uint16 y,
     if (map && dstBeing && x && y)
     {
         Vector pos =  map->getTileCenter(x, y);
-        Vector beingPos = dstBeing->getPosition();
-        // Don't set the position as the movement algorithm
-        // can guess it and it would break the animation played,
-        // when we're close enough.
-        if (std::abs(beingPos.x - pos.x) > POS_DEST_DIFF_TOLERANCE
-            || std::abs(beingPos.y - pos.y) > POS_DEST_DIFF_TOLERANCE)
-            dstBeing->setPosition(pos);
+        dstBeing->reconcilePosition(pos);
 
         // Set also the destination to the desired position.
         dstBeing->setDestination(pos.x, pos.y);
@@ -39,6 +39,8 @@ class GuildTab : public ChatTab
 
         void saveToLogFile(std::string &msg) override;
 
+        std::string getHistoryName() const override { return "#Guild"; }
+
     protected:
         void handleInput(const std::string &msg) override;
 
@@ -39,6 +39,8 @@ class PartyTab : public ChatTab
 
         void saveToLogFile(std::string &msg) override;
 
+        std::string getHistoryName() const override { return "#Party"; }
+
     protected:
         void handleInput(const std::string &msg) override;
 
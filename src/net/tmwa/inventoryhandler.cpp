@@ -309,10 +309,7 @@ void InventoryHandler::handleMessage(MessageIn &msg)
                 card = msg.readInt16();
 
             if (Item *item = mStorage->getItem(index))
-            {
-                item->setId(itemId);
-                item->increaseQuantity(amount);
-            }
+                mStorage->setItem(index, itemId, item->getQuantity() + amount);
             else
                 mStorage->setItem(index, itemId, amount);
             break;
@@ -33,15 +33,24 @@ namespace TmwAthena {
 
 MessageOut::MessageOut(uint16_t id)
 {
+    Network &net = *Network::mInstance;
+
 #ifdef DEBUG
-    Log::info("Sending %s (0x%x)", Network::mInstance->messageName(id), id);
+    Log::info("Sending %s (0x%x)", net.messageName(id), id);
 #endif
+
+    // Reserve room for the whole message up front when its length is known
+    // from the protocol, so that it is sent in one piece.
+    net.reserveOut(net.messageLength(id));
+
     writeInt16(id);
 }
 
 char *MessageOut::expand(size_t bytes)
 {
     Network &net = *Network::mInstance;
+    net.reserveOut(bytes);
+
     char *data = net.mOutBuffer + net.mOutSize;
     net.mOutSize += bytes;
     return data;
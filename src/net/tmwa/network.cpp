@@ -23,12 +23,15 @@
 
 #include "log.h"
 
+#include "net/packetcapture.h"
+
 #include "net/tmwa/messagein.h"
 #include "net/tmwa/protocol.h"
 
 #include "utils/gettext.h"
 #include "utils/stringutils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
@@ -231,6 +234,44 @@ static constexpr PacketInfo packet_infos[] = {
 
 const unsigned int BUFFER_SIZE = 65536;
 
+// Used while waiting for data when no wakeup socket is available
+const Uint32 RECEIVE_POLL_INTERVAL = 500;
+
+// Channel of the wakeup socket bound to its own loopback address
+const int WAKEUP_CHANNEL = 0;
+
+/**
+ * Opens the socket used to wake up the network thread. SDL_net always binds
+ * UDP sockets to all interfaces, so the socket's own loopback address is
+ * bound to a channel instead, to tell its own datagrams from any others.
+ */
+static UDPsocket openWakeupSocket()
+{
+    UDPsocket socket = SDLNet_UDP_Open(0);
+    if (!socket)
+    {
+        Log::info("Error in SDLNet_UDP_Open(): %s", SDLNet_GetError());
+        return nullptr;
+    }
+
+    const IPaddress *localAddress = SDLNet_UDP_GetPeerAddress(socket, -1);
+    IPaddress self;
+    if (localAddress)
+    {
+        SDLNet_Write32(INADDR_LOOPBACK, &self.host);
+        self.port = localAddress->port;
+    }
+
+    if (!localAddress || SDLNet_UDP_Bind(socket, WAKEUP_CHANNEL, &self) == -1)
+    {
+        Log::info("Error in SDLNet_UDP_Bind(): %s", SDLNet_GetError());
+        SDLNet_UDP_Close(socket);
+        return nullptr;
+    }
+
+    return socket;
+}
+
 int networkThread(void *data)
 {
     auto *network = static_cast<Network*>(data);
@@ -267,6 +308,9 @@ Network::~Network()
     if (mState != IDLE && mState != NET_ERROR)
         disconnect();
 
+    if (mWakeupSocket)
+        SDLNet_UDP_Close(mWakeupSocket);
+
     mInstance = nullptr;
 
     delete[] mInBuffer;
@@ -301,6 +345,20 @@ bool Network::connect(const ServerInfo &server)
     mInSize = 0;
     mToSkip = 0;
 
+    if (auto replay = Net::getPacketReplay())
+    {
+        replay->beginConnection();
+        mReplayData = nullptr;
+        mReplayOffset = 0;
+        mState = CONNECTED;
+        return true;
+    }
+
+    // A datagram sent to this socket wakes up the network thread, so that
+    // it can wait for data without a timeout
+    if (!mWakeupSocket)
+        mWakeupSocket = openWakeupSocket();
+
     mState = CONNECTING;
     mWorkerThread = SDL_CreateThread(networkThread, "Network", this);
     if (!mWorkerThread)
@@ -318,10 +376,17 @@ void Network::disconnect()
 
     if (mWorkerThread)
     {
+        wakeUp();
         SDL_WaitThread(mWorkerThread, nullptr);
         mWorkerThread = nullptr;
     }
 
+    if (mWakeupSocket)
+    {
+        SDLNet_UDP_Close(mWakeupSocket);
+        mWakeupSocket = nullptr;
+    }
+
     if (mSocket)
     {
         SDLNet_TCP_Close(mSocket);
@@ -362,10 +427,26 @@ const char *Network::messageName(uint16_t id) const
     return "Unknown";
 }
 
+uint16_t Network::messageLength(uint16_t id) const
+{
+    auto packetInfoIt = mPacketInfo.find(id);
+    if (packetInfoIt != mPacketInfo.end() && packetInfoIt->second->length != VAR)
+        return packetInfoIt->second->length;
+
+    return 0;
+}
+
 void Network::dispatchMessages()
 {
     MutexLocker lock(&mMutex);
 
+    if (auto replay = Net::getPacketReplay())
+        receiveReplay(replay);
+
+    Net::PacketStats *stats = Net::getPacketStats();
+    if (stats)
+        stats->beginDispatch();
+
     while (mInSize >= 2)    // We need at least a message ID
     {
         const uint16_t msgId = readWord(0);
@@ -411,7 +492,12 @@ void Network::dispatchMessages()
             Log::info("Handling %s (0x%x) of length %d", packetInfo->name, msgId, len);
 #endif
 
+            const uint64_t start = stats ? Net::PacketStats::now() : 0;
+
             iter->second->handleMessage(message);
+
+            if (stats)
+                stats->record(msgId, Net::PacketStats::now() - start, len);
         }
         else
         {
@@ -420,6 +506,9 @@ void Network::dispatchMessages()
 
         skip(len);
     }
+
+    if (stats)
+        stats->endDispatch();
 }
 
 void Network::flush()
@@ -427,6 +516,13 @@ void Network::flush()
     if (!mOutSize || mState != CONNECTED)
         return;
 
+    // Nobody is listening when replaying a capture
+    if (Net::getPacketReplay())
+    {
+        mOutSize = 0;
+        return;
+    }
+
     int ret;
 
     MutexLocker lock(&mMutex);
@@ -439,6 +535,21 @@ void Network::flush()
     mOutSize = 0;
 }
 
+void Network::reserveOut(unsigned int bytes)
+{
+    if (mOutSize + bytes <= BUFFER_SIZE)
+        return;
+
+    flush();
+
+    // The buffer can't be flushed while not connected
+    if (mOutSize + bytes > BUFFER_SIZE)
+    {
+        Log::warn("Network out buffer overflow, dropping %u bytes", mOutSize);
+        mOutSize = 0;
+    }
+}
+
 void Network::skip(int len)
 {
     MutexLocker lock(&mMutex);
@@ -486,6 +597,9 @@ bool Network::realConnect()
     Log::info("Network::Started session with %s:%i",
               ipToString(ipAddress.host), ipAddress.port);
 
+    if (auto capture = Net::getPacketCapture())
+        capture->writeConnect(ServerType::TmwAthena);
+
     mState = CONNECTED;
 
     return true;
@@ -495,7 +609,7 @@ void Network::receive()
 {
     SDLNet_SocketSet set;
 
-    if (!(set = SDLNet_AllocSocketSet(1)))
+    if (!(set = SDLNet_AllocSocketSet(2)))
     {
         setError("Error in SDLNet_AllocSocketSet(): " +
                  std::string(SDLNet_GetError()));
@@ -508,12 +622,32 @@ void Network::receive()
                  std::string(SDLNet_GetError()));
     }
 
+    UDPpacket *wakeupPacket = nullptr;
+    Uint32 timeout = RECEIVE_POLL_INTERVAL;
+
+    if (mWakeupSocket && SDLNet_UDP_AddSocket(set, mWakeupSocket) != -1)
+    {
+        wakeupPacket = SDLNet_AllocPacket(1);
+        timeout = SDL_MAX_UINT32;
+    }
+
     while (mState == CONNECTED)
     {
-        // TODO Try to get this to block all the time while still being able
-        // to escape the loop
-        int numReady = SDLNet_CheckSockets(set, ((Uint32)500));
+        int numReady = SDLNet_CheckSockets(set, timeout);
         int ret;
+
+        if (numReady > 0 && wakeupPacket && SDLNet_SocketReady(mWakeupSocket))
+        {
+            // Drain the datagrams. Only those sent by the socket to itself
+            // are wakeups, after which the loop condition is checked.
+            bool wokenUp = false;
+            while (SDLNet_UDP_Recv(mWakeupSocket, wakeupPacket) > 0)
+                wokenUp |= wakeupPacket->channel == WAKEUP_CHANNEL;
+
+            if (wokenUp || --numReady == 0)
+                continue;
+        }
+
         switch (numReady)
         {
             case -1:
@@ -541,21 +675,11 @@ void Network::receive()
                 }
                 else
                 {
+                    if (auto capture = Net::getPacketCapture())
+                        capture->writeData(mInBuffer + mInSize, ret);
+
                     mInSize += ret;
-                    if (mToSkip)
-                    {
-                        if (mInSize >= mToSkip)
-                        {
-                            mInSize -= mToSkip;
-                            memmove(mInBuffer, mInBuffer + mToSkip, mInSize);
-                            mToSkip = 0;
-                        }
-                        else
-                        {
-                            mToSkip -= mInSize;
-                            mInSize = 0;
-                        }
-                    }
+                    applySkip();
                 }
                 break;
             }
@@ -576,9 +700,87 @@ void Network::receive()
         Log::info("Error in SDLNet_DelSocket(): %s", SDLNet_GetError());
     }
 
+    if (wakeupPacket)
+    {
+        SDLNet_UDP_DelSocket(set, mWakeupSocket);
+        SDLNet_FreePacket(wakeupPacket);
+    }
+
     SDLNet_FreeSocketSet(set);
 }
 
+void Network::wakeUp()
+{
+    if (!mWakeupSocket)
+        return;
+
+    Uint8 data = 0;
+    UDPpacket packet;
+    packet.channel = WAKEUP_CHANNEL;
+    packet.data = &data;
+    packet.len = 1;
+    packet.maxlen = 1;
+
+    // Sent to the socket's own loopback address, bound to the channel
+    SDLNet_UDP_Send(mWakeupSocket, WAKEUP_CHANNEL, &packet);
+}
+
+/**
+ * Feeds data from the packet replay into the input buffer, as if it was
+ * received from the socket. Called with the mutex locked.
+ */
+void Network::receiveReplay(Net::PacketReplay *replay)
+{
+    while (mState == CONNECTED && mInSize < BUFFER_SIZE)
+    {
+        if (!mReplayData || mReplayOffset == mReplayData->size())
+        {
+            mReplayData = replay->nextData();
+            mReplayOffset = 0;
+
+            if (!mReplayData)
+                break;
+        }
+
+        const unsigned int size = std::min<size_t>(BUFFER_SIZE - mInSize,
+                                                   mReplayData->size() - mReplayOffset);
+        memcpy(mInBuffer + mInSize, mReplayData->data() + mReplayOffset, size);
+        mReplayOffset += size;
+        mInSize += size;
+        applySkip();
+    }
+
+    if (mState == CONNECTED && replay->atEnd() && !mReplayData && !mInSize)
+    {
+        Log::info("Network::Replay finished.");
+        mState = IDLE;
+
+        if (auto stats = Net::getPacketStats())
+            stats->report([this](uint16_t id) { return std::string(messageName(id)); });
+    }
+}
+
+/**
+ * Drops received data that was already marked to be skipped.
+ */
+void Network::applySkip()
+{
+    if (!mToSkip)
+        return;
+
+    if (mInSize >= mToSkip)
+    {
+        mInSize -= mToSkip;
+        memmove(mInBuffer, mInBuffer + mToSkip, mInSize);
+        mToSkip = 0;
+    }
+    else
+    {
+        mToSkip -= mInSize;
+        mInSize = 0;
+    }
+}
+
 void Network::setError(const std::string &error)
 {
     Log::info("Network error: %s", error.c_str());
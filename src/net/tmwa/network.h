@@ -34,6 +34,7 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 /**
  * Protocol version, reported to the eAthena char and mapserver who can adjust
@@ -42,6 +43,10 @@
 #define CLIENT_PROTOCOL_VERSION      1
 // 10 -> 11: SMSG_MAP_MASK DONE
 
+namespace Net {
+class PacketReplay;
+}
+
 namespace TmwAthena {
 
 struct PacketInfo;
@@ -68,6 +73,12 @@ class Network
 
         const char *messageName(uint16_t id) const;
 
+        /**
+         * Returns the length of the message with the given id, or 0 when
+         * it is unknown or has a variable length.
+         */
+        uint16_t messageLength(uint16_t id) const;
+
         int getState() const { return mState; }
 
         const std::string &getError() const { return mError; }
@@ -97,13 +108,29 @@ class Network
 
         void setError(const std::string &error);
 
+        /**
+         * Makes room for the given amount of bytes in the out buffer,
+         * flushing it when needed.
+         */
+        void reserveOut(unsigned int bytes);
+
         uint16_t readWord(int pos);
 
         bool realConnect();
 
         void receive();
 
+        /**
+         * Wakes up the network thread while it is waiting for data.
+         */
+        void wakeUp();
+
+        void receiveReplay(Net::PacketReplay *replay);
+
+        void applySkip();
+
         TCPsocket mSocket = nullptr;
+        UDPsocket mWakeupSocket = nullptr;  /**< Used to interrupt waiting */
 
         ServerInfo mServer;
 
@@ -116,6 +143,9 @@ class Network
         int mState = IDLE;
         std::string mError;
 
+        const std::vector<char> *mReplayData = nullptr;
+        size_t mReplayOffset = 0;
+
         SDL_Thread *mWorkerThread = nullptr;
         Mutex mMutex;
 
@@ -173,11 +173,22 @@ void PlayerHandler::handleMessage(MessageIn &msg)
     switch (msg.getId())
     {
         case SMSG_WALK_RESPONSE:
-            /*
-             * This client assumes that all walk messages succeed,
-             * and that the server will send a correction notice
-             * otherwise.
-             */
+            {
+                /*
+                 * This client assumes that all walk messages succeed, and
+                 * only corrects the local player when the server chose a
+                 * different destination.
+                 */
+                msg.readInt32();    // server tick
+                uint16_t srcX, srcY, dstX, dstY;
+                msg.readCoordinatePair(srcX, srcY, dstX, dstY);
+
+                if (Map *map = Game::instance()->getCurrentMap())
+                {
+                    local_player->confirmWalk(map->getTileCenter(srcX, srcY),
+                                              map->getTileCenter(dstX, dstY));
+                }
+            }
             break;
 
         case SMSG_PLAYER_WARP:
@@ -36,14 +36,72 @@
 #include <SDL.h>
 
 #include <cmath>
+#include <string>
 
 #ifndef GL_TEXTURE_RECTANGLE_ARB
 #define GL_TEXTURE_RECTANGLE_ARB 0x84F5
 #define GL_MAX_RECTANGLE_TEXTURE_SIZE_ARB 0x84F8
 #endif
 
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
 const unsigned int vertexBufSize = 500;
 
+/*
+ * Framebuffer objects are used for rendering to textures. They are core since
+ * OpenGL 3.0 and otherwise available through extensions, so the functions are
+ * resolved at runtime.
+ */
+using GenFramebuffersFn = void (APIENTRY *)(GLsizei, GLuint *);
+using DeleteFramebuffersFn = void (APIENTRY *)(GLsizei, const GLuint *);
+using BindFramebufferFn = void (APIENTRY *)(GLenum, GLuint);
+using FramebufferTexture2DFn = void (APIENTRY *)(GLenum, GLenum, GLenum,
+                                                 GLuint, GLint);
+using CheckFramebufferStatusFn = GLenum (APIENTRY *)(GLenum);
+using BlendFuncSeparateFn = void (APIENTRY *)(GLenum, GLenum, GLenum, GLenum);
+
+static GenFramebuffersFn genFramebuffers;
+static DeleteFramebuffersFn deleteFramebuffers;
+static BindFramebufferFn bindFramebuffer;
+static FramebufferTexture2DFn framebufferTexture2D;
+static CheckFramebufferStatusFn checkFramebufferStatus;
+static BlendFuncSeparateFn blendFuncSeparate;
+
+template<typename Function>
+static bool loadFunction(Function &function, const char *name, const char *suffix)
+{
+    function = reinterpret_cast<Function>(SDL_GL_GetProcAddress(name));
+    if (!function)
+    {
+        const std::string extName = std::string(name) + suffix;
+        function = reinterpret_cast<Function>(
+                SDL_GL_GetProcAddress(extName.c_str()));
+    }
+    return function != nullptr;
+}
+
+static bool loadFramebufferFunctions()
+{
+    const char *suffix = nullptr;
+    if (SDL_GL_ExtensionSupported("GL_ARB_framebuffer_object"))
+        suffix = "";
+    else if (SDL_GL_ExtensionSupported("GL_EXT_framebuffer_object"))
+        suffix = "EXT";
+    else
+        return false;
+
+    return loadFunction(genFramebuffers, "glGenFramebuffers", suffix) &&
+           loadFunction(deleteFramebuffers, "glDeleteFramebuffers", suffix) &&
+           loadFunction(bindFramebuffer, "glBindFramebuffer", suffix) &&
+           loadFunction(framebufferTexture2D, "glFramebufferTexture2D", suffix) &&
+           loadFunction(checkFramebufferStatus, "glCheckFramebufferStatus", suffix) &&
+           loadFunction(blendFuncSeparate, "glBlendFuncSeparate", "EXT");
+}
+
 GLuint OpenGLGraphics::mLastImage = 0;
 
 std::unique_ptr<OpenGLGraphics> OpenGLGraphics::create(SDL_Window *window,
@@ -109,10 +167,18 @@ OpenGLGraphics::OpenGLGraphics(SDL_Window *window, SDL_GLContext glContext)
 
     glEnableClientState(GL_VERTEX_ARRAY);
     glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    if (loadFramebufferFunctions())
+        genFramebuffers(1, &mFramebuffer);
+
+    Log::info("OpenGL rendering to texture: %s", mFramebuffer ? "yes" : "no");
 }
 
 OpenGLGraphics::~OpenGLGraphics()
 {
+    if (mFramebuffer)
+        deleteFramebuffers(1, &mFramebuffer);
+
     SDL_GL_DeleteContext(mContext);
 
     delete[] mFloatTexArray;
@@ -253,126 +319,10 @@ void OpenGLGraphics::drawImagePattern(const Image *image, int x, int y, int w, i
     if (!image)
         return;
 
-    const int srcX = image->mBounds.x;
-    const int srcY = image->mBounds.y;
-
+    // A pattern of the image at its own size
     const int iw = image->getWidth();
     const int ih = image->getHeight();
-
-    if (iw == 0 || ih == 0)
-        return;
-
-    const auto tw = static_cast<float>(image->getTextureWidth());
-    const auto th = static_cast<float>(image->getTextureHeight());
-
-    prepareRenderImage(image);
-
-    unsigned int vp = 0;
-    const unsigned int vLimit = vertexBufSize * 4;
-    // Draw a set of textured rectangles
-    if (Image::getTextureType() == GL_TEXTURE_2D)
-    {
-        float texX1 = static_cast<float>(srcX) / tw;
-        float texY1 = static_cast<float>(srcY) / th;
-
-        for (int py = 0; py < h; py += ih)
-        {
-            const int height = (py + ih >= h) ? h - py : ih;
-            const int dstY = y + py;
-            for (int px = 0; px < w; px += iw)
-            {
-                int width = (px + iw >= w) ? w - px : iw;
-                int dstX = x + px;
-
-                float texX2 = static_cast<float>(srcX + width) / tw;
-                float texY2 = static_cast<float>(srcY + height) / th;
-
-                mFloatTexArray[vp + 0] = texX1;
-                mFloatTexArray[vp + 1] = texY1;
-
-                mFloatTexArray[vp + 2] = texX2;
-                mFloatTexArray[vp + 3] = texY1;
-
-                mFloatTexArray[vp + 4] = texX2;
-                mFloatTexArray[vp + 5] = texY2;
-
-                mFloatTexArray[vp + 6] = texX1;
-                mFloatTexArray[vp + 7] = texY2;
-
-                mIntVertArray[vp + 0] = dstX;
-                mIntVertArray[vp + 1] = dstY;
-
-                mIntVertArray[vp + 2] = dstX + width;
-                mIntVertArray[vp + 3] = dstY;
-
-                mIntVertArray[vp + 4] = dstX + width;
-                mIntVertArray[vp + 5] = dstY + height;
-
-                mIntVertArray[vp + 6] = dstX;
-                mIntVertArray[vp + 7] = dstY + height;
-
-                vp += 8;
-                if (vp >= vLimit)
-                {
-                    drawQuadArrayfi(vp);
-                    vp = 0;
-                }
-            }
-        }
-        if (vp > 0)
-            drawQuadArrayfi(vp);
-    }
-    else
-    {
-        for (int py = 0; py < h; py += ih)
-        {
-            const int height = (py + ih >= h) ? h - py : ih;
-            const int dstY = y + py;
-            for (int px = 0; px < w; px += iw)
-            {
-                int width = (px + iw >= w) ? w - px : iw;
-                int dstX = x + px;
-
-                mIntTexArray[vp + 0] = srcX;
-                mIntTexArray[vp + 1] = srcY;
-
-                mIntTexArray[vp + 2] = srcX + width;
-                mIntTexArray[vp + 3] = srcY;
-
-                mIntTexArray[vp + 4] = srcX + width;
-                mIntTexArray[vp + 5] = srcY + height;
-
-                mIntTexArray[vp + 6] = srcX;
-                mIntTexArray[vp + 7] = srcY + height;
-
-                mIntVertArray[vp + 0] = dstX;
-                mIntVertArray[vp + 1] = dstY;
-
-                mIntVertArray[vp + 2] = dstX + width;
-                mIntVertArray[vp + 3] = dstY;
-
-                mIntVertArray[vp + 4] = dstX + width;
-                mIntVertArray[vp + 5] = dstY + height;
-
-                mIntVertArray[vp + 6] = dstX;
-                mIntVertArray[vp + 7] = dstY + height;
-
-                vp += 8;
-                if (vp >= vLimit)
-                {
-                    drawQuadArrayii(vp);
-                    vp = 0;
-                }
-            }
-        }
-        if (vp > 0)
-            drawQuadArrayii(vp);
-    }
-
-    glColor4ub(static_cast<GLubyte>(mColor.r),
-               static_cast<GLubyte>(mColor.g),
-               static_cast<GLubyte>(mColor.b),
-               static_cast<GLubyte>(mColor.a));
+    drawRescaledImagePattern(image, 0, 0, iw, ih, x, y, w, h, iw, ih);
 }
 
 void OpenGLGraphics::drawRescaledImagePattern(const Image *image,
@@ -401,115 +351,70 @@ void OpenGLGraphics::drawRescaledImagePattern(const Image *image,
     const unsigned int vLimit = vertexBufSize * 4;
 
     // Draw a set of textured rectangles
-    if (Image::getTextureType() == GL_TEXTURE_2D)
+    for (int py = 0; py < dstH; py += scaledHeight)
     {
-        const auto tw = static_cast<float>(image->getTextureWidth());
-        const auto th = static_cast<float>(image->getTextureHeight());
-
-        const float texX1 = static_cast<float>(srcX) / tw;
-        const float texY1 = static_cast<float>(srcY) / th;
-
-        const float tFractionW = srcW / tw;
-        const float tFractionH = srcH / th;
-
-        for (int py = 0; py < dstH; py += scaledHeight)
+        const int height = (py + scaledHeight >= dstH) ? dstH - py : scaledHeight;
+        const int destY = dstY + py;
+        for (int px = 0; px < dstW; px += scaledWidth)
         {
-            const int height = (py + scaledHeight >= dstH) ? dstH - py : scaledHeight;
-            const int destY = dstY + py;
-            for (int px = 0; px < dstW; px += scaledWidth)
-            {
-                int width = (px + scaledWidth >= dstW) ? dstW - px : scaledWidth;
-                int destX = dstX + px;
-                const float visibleFractionW = (float) width / scaledWidth;
-                const float visibleFractionH = (float) height / scaledHeight;
-
-                const float texX2 = texX1 + tFractionW * visibleFractionW;
-                const float texY2 = texY1 + tFractionH * visibleFractionH;
+            int width = (px + scaledWidth >= dstW) ? dstW - px : scaledWidth;
+            int destX = dstX + px;
 
-                mFloatTexArray[vp + 0] = texX1;
-                mFloatTexArray[vp + 1] = texY1;
+            // The last repetitions only show part of the image
+            fillTexturedQuad(vp, image, srcX, srcY,
+                             (float) srcW * width / scaledWidth,
+                             (float) srcH * height / scaledHeight,
+                             destX, destY, width, height);
 
-                mFloatTexArray[vp + 2] = texX2;
-                mFloatTexArray[vp + 3] = texY1;
-
-                mFloatTexArray[vp + 4] = texX2;
-                mFloatTexArray[vp + 5] = texY2;
-
-                mFloatTexArray[vp + 6] = texX1;
-                mFloatTexArray[vp + 7] = texY2;
-
-                mIntVertArray[vp + 0] = destX;
-                mIntVertArray[vp + 1] = destY;
-
-                mIntVertArray[vp + 2] = destX + width;
-                mIntVertArray[vp + 3] = destY;
-
-                mIntVertArray[vp + 4] = destX + width;
-                mIntVertArray[vp + 5] = destY + height;
-
-                mIntVertArray[vp + 6] = destX;
-                mIntVertArray[vp + 7] = destY + height;
-
-                vp += 8;
-                if (vp >= vLimit)
-                {
-                    drawQuadArrayfi(vp);
-                    vp = 0;
-                }
+            vp += 8;
+            if (vp >= vLimit)
+            {
+                drawQuadArray(vp);
+                vp = 0;
             }
         }
-        if (vp > 0)
-            drawQuadArrayfi(vp);
     }
-    else
-    {
-        const float scaleFactorW = (float) scaledWidth / srcW;
-        const float scaleFactorH = (float) scaledHeight / srcH;
-
-        for (int py = 0; py < dstH; py += scaledHeight)
-        {
-            const int height = (py + scaledHeight >= dstH) ? dstH - py : scaledHeight;
-            const int destY = dstY + py;
-            for (int px = 0; px < dstW; px += scaledWidth)
-            {
-                int width = (px + scaledWidth >= dstW) ? dstW - px : scaledWidth;
-                int destX = dstX + px;
-
-                mIntTexArray[vp + 0] = srcX;
-                mIntTexArray[vp + 1] = srcY;
-
-                mIntTexArray[vp + 2] = srcX + width / scaleFactorW;
-                mIntTexArray[vp + 3] = srcY;
+    if (vp > 0)
+        drawQuadArray(vp);
 
-                mIntTexArray[vp + 4] = srcX + width / scaleFactorW;
-                mIntTexArray[vp + 5] = srcY + height / scaleFactorH;
+    glColor4ub(static_cast<GLubyte>(mColor.r),
+               static_cast<GLubyte>(mColor.g),
+               static_cast<GLubyte>(mColor.b),
+               static_cast<GLubyte>(mColor.a));
+}
 
-                mIntTexArray[vp + 6] = srcX;
-                mIntTexArray[vp + 7] = srcY + height / scaleFactorH;
+void OpenGLGraphics::drawImageQuads(const Image *image,
+                                    const ImageQuad *quads, size_t count,
+                                    int x, int y)
+{
+    if (!image || count == 0)
+        return;
 
-                mIntVertArray[vp + 0] = destX;
-                mIntVertArray[vp + 1] = destY;
+    prepareRenderImage(image);
 
-                mIntVertArray[vp + 2] = destX + width;
-                mIntVertArray[vp + 3] = destY;
+    unsigned int vp = 0;
+    const unsigned int vLimit = vertexBufSize * 4;
 
-                mIntVertArray[vp + 4] = destX + width;
-                mIntVertArray[vp + 5] = destY + height;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ImageQuad &quad = quads[i];
 
-                mIntVertArray[vp + 6] = destX;
-                mIntVertArray[vp + 7] = destY + height;
+        fillTexturedQuad(vp, image,
+                         image->mBounds.x + quad.srcX,
+                         image->mBounds.y + quad.srcY,
+                         quad.srcW, quad.srcH,
+                         x + quad.dstX, y + quad.dstY,
+                         quad.dstW, quad.dstH);
 
-                vp += 8;
-                if (vp >= vLimit)
-                {
-                    drawQuadArrayii(vp);
-                    vp = 0;
-                }
-            }
+        vp += 8;
+        if (vp >= vLimit)
+        {
+            drawQuadArray(vp);
+            vp = 0;
         }
-        if (vp > 0)
-            drawQuadArrayii(vp);
     }
+    if (vp > 0)
+        drawQuadArray(vp);
 
     glColor4ub(static_cast<GLubyte>(mColor.r),
                static_cast<GLubyte>(mColor.g),
@@ -585,6 +490,165 @@ SDL_Surface *OpenGLGraphics::getScreenshot()
     return screenshot;
 }
 
+std::unique_ptr<Image> OpenGLGraphics::createRenderTarget(int width, int height)
+{
+    if (!mFramebuffer)
+        return {};
+
+    const int pixelWidth = std::ceil(width * mScaleX);
+    const int pixelHeight = std::ceil(height * mScaleY);
+
+    int texWidth = pixelWidth;
+    int texHeight = pixelHeight;
+    if (Image::mPowerOfTwoTextures)
+    {
+        texWidth = Image::powerOfTwo(pixelWidth);
+        texHeight = Image::powerOfTwo(pixelHeight);
+    }
+
+    if (texWidth > Image::mTextureSize || texHeight > Image::mTextureSize)
+        return {};
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    bindTexture(Image::mTextureType, texture);
+
+    glTexImage2D(Image::mTextureType, 0, GL_RGBA8,
+                 texWidth, texHeight,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 nullptr);
+
+    glTexParameteri(Image::mTextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(Image::mTextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    auto target = std::unique_ptr<Image>(new Image(texture,
+                                                   pixelWidth, pixelHeight,
+                                                   texWidth, texHeight));
+
+    // Make sure the driver accepts this texture as color attachment
+    bindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         Image::mTextureType, texture, 0);
+    const GLenum status = checkFramebufferStatus(GL_FRAMEBUFFER);
+    framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         Image::mTextureType, 0, 0);
+    bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        return {};
+
+    return target;
+}
+
+void OpenGLGraphics::drawRenderTarget(const Image *target,
+                                      int x, int y,
+                                      int width, int height)
+{
+    prepareRenderImage(target);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // With premultiplied alpha, the color needs to be faded as well
+    const GLfloat alpha = target->getAlpha();
+    glColor4f(alpha, alpha, alpha, alpha);
+
+    const GLint vert[] =
+    {
+        x, y,
+        x + width, y,
+        x + width, y + height,
+        x, y + height
+    };
+
+    glVertexPointer(2, GL_INT, 0, &vert);
+
+    // The contents of render targets are upside down
+    if (Image::getTextureType() == GL_TEXTURE_2D)
+    {
+        const float texX = static_cast<float>(target->getWidth()) /
+                           static_cast<float>(target->getTextureWidth());
+        const float texY = static_cast<float>(target->getHeight()) /
+                           static_cast<float>(target->getTextureHeight());
+
+        const GLfloat tex[] =
+        {
+            0.0f, texY,
+            texX, texY,
+            texX, 0.0f,
+            0.0f, 0.0f
+        };
+
+        glTexCoordPointer(2, GL_FLOAT, 0, &tex);
+        glDrawArrays(GL_QUADS, 0, 4);
+    }
+    else
+    {
+        const GLint texX = target->getWidth();
+        const GLint texY = target->getHeight();
+
+        const GLint tex[] =
+        {
+            0, texY,
+            texX, texY,
+            texX, 0,
+            0, 0
+        };
+
+        glTexCoordPointer(2, GL_INT, 0, &tex);
+        glDrawArrays(GL_QUADS, 0, 4);
+    }
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void OpenGLGraphics::setRenderTarget(Image *target)
+{
+    if (target)
+    {
+        bindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+        framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             Image::mTextureType, target->mGLImage, 0);
+
+        glViewport(0, 0, target->getWidth(), target->getHeight());
+
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glOrtho(0.0, (double)mWidth, (double)mHeight, 0.0, -1.0, 1.0);
+
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        // Accumulate the alpha channel like the color channels, which
+        // results in premultiplied alpha
+        blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                          GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        glDisable(GL_SCISSOR_TEST);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    else
+    {
+        framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             Image::mTextureType, 0, 0);
+        bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        int drawableWidth;
+        int drawableHeight;
+        SDL_GL_GetDrawableSize(mWindow, &drawableWidth, &drawableHeight);
+        glViewport(0, 0, drawableWidth, drawableHeight);
+
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+
+        glMatrixMode(GL_MODELVIEW);
+        glPopMatrix();
+
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+}
+
 bool OpenGLGraphics::pushClipArea(gcn::Rectangle area)
 {
     int transX = 0;
@@ -760,6 +824,70 @@ void OpenGLGraphics::prepareRenderImage(const Image *image)
     setTexturingAndBlending(true);
 }
 
+void OpenGLGraphics::fillTexturedQuad(unsigned vp, const Image *image,
+                                      int srcX, int srcY,
+                                      float srcW, float srcH,
+                                      int dstX, int dstY,
+                                      int dstW, int dstH)
+{
+    if (Image::getTextureType() == GL_TEXTURE_2D)
+    {
+        const auto tw = static_cast<float>(image->getTextureWidth());
+        const auto th = static_cast<float>(image->getTextureHeight());
+
+        const float texX1 = srcX / tw;
+        const float texY1 = srcY / th;
+        const float texX2 = (srcX + srcW) / tw;
+        const float texY2 = (srcY + srcH) / th;
+
+        mFloatTexArray[vp + 0] = texX1;
+        mFloatTexArray[vp + 1] = texY1;
+
+        mFloatTexArray[vp + 2] = texX2;
+        mFloatTexArray[vp + 3] = texY1;
+
+        mFloatTexArray[vp + 4] = texX2;
+        mFloatTexArray[vp + 5] = texY2;
+
+        mFloatTexArray[vp + 6] = texX1;
+        mFloatTexArray[vp + 7] = texY2;
+    }
+    else
+    {
+        mIntTexArray[vp + 0] = srcX;
+        mIntTexArray[vp + 1] = srcY;
+
+        mIntTexArray[vp + 2] = srcX + srcW;
+        mIntTexArray[vp + 3] = srcY;
+
+        mIntTexArray[vp + 4] = srcX + srcW;
+        mIntTexArray[vp + 5] = srcY + srcH;
+
+        mIntTexArray[vp + 6] = srcX;
+        mIntTexArray[vp + 7] = srcY + srcH;
+    }
+
+    mIntVertArray[vp + 0] = dstX;
+    mIntVertArray[vp + 1] = dstY;
+
+    mIntVertArray[vp + 2] = dstX + dstW;
+    mIntVertArray[vp + 3] = dstY;
+
+    mIntVertArray[vp + 4] = dstX + dstW;
+    mIntVertArray[vp + 5] = dstY + dstH;
+
+    mIntVertArray[vp + 6] = dstX;
+    mIntVertArray[vp + 7] = dstY + dstH;
+}
+
+void OpenGLGraphics::drawQuadArray(int size)
+{
+    if (Image::getTextureType() == GL_TEXTURE_2D)
+        drawQuadArrayfi(size);
+    else
+        drawQuadArrayii(size);
+}
+
 inline void OpenGLGraphics::drawQuadArrayfi(int size)
 {
     glVertexPointer(2, GL_INT, 0, mIntVertArray);
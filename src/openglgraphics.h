@@ -74,6 +74,10 @@ class OpenGLGraphics final : public Graphics
                                       int dstW, int dstH,
                                       int scaledWidth, int scaledHeight) override;
 
+        void drawImageQuads(const Image *image,
+                            const ImageQuad *quads, size_t count,
+                            int x, int y) override;
+
         void updateScreen() override;
 
         void windowToLogical(int windowX, int windowY,
@@ -99,6 +103,12 @@ class OpenGLGraphics final : public Graphics
          */
         SDL_Surface *getScreenshot() override;
 
+        std::unique_ptr<Image> createRenderTarget(int width, int height) override;
+
+        void drawRenderTarget(const Image *target,
+                              int x, int y,
+                              int width, int height) override;
+
         static void bindTexture(GLenum target, GLuint texture);
 
         static GLuint mLastImage;
@@ -108,8 +118,25 @@ class OpenGLGraphics final : public Graphics
         void prepareRenderImage(const Image *image);
 
         void updateClipRect() override;
+        void setRenderTarget(Image *target) override;
 
     private:
+        /**
+         * Fills the vertex arrays at the given offset with a quad showing
+         * the given area of the image's texture, in texture pixels.
+         */
+        void fillTexturedQuad(unsigned vp, const Image *image,
+                              int srcX, int srcY,
+                              float srcW, float srcH,
+                              int dstX, int dstY,
+                              int dstW, int dstH);
+
+        /**
+         * Draws the quads in the vertex arrays, using the texture coordinates
+         * that were filled in for the current texture type.
+         */
+        void drawQuadArray(int size);
+
         void drawQuadArrayfi(int size);
 
         void drawQuadArrayii(int size);
@@ -119,6 +146,7 @@ class OpenGLGraphics final : public Graphics
         GLfloat *mFloatTexArray;
         GLint *mIntTexArray;
         GLint *mIntVertArray;
+        GLuint mFramebuffer = 0;
         float mUserScale = 1.0f;
         float mScaleX = 1.0f;
         float mScaleY = 1.0f;
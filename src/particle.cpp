@@ -30,13 +30,11 @@
 #include "rotationalparticle.h"
 #include "textparticle.h"
 
-#include "resources/dye.h"
 #include "resources/image.h"
 #include "resources/resourcemanager.h"
 
 #include "utils/dtor.h"
 #include "utils/mathutils.h"
-#include "utils/xml.h"
 
 #include <guichan/color.hpp>
 
@@ -173,7 +171,7 @@ bool Particle::update()
         }
 
         // Update child emitters
-        if ((mLifetimePast-1)%Particle::emitterSkip == 0)
+        if (!isEmissionPaused() && (mLifetimePast-1)%Particle::emitterSkip == 0)
         {
             for (auto &childEmitter : mChildEmitters)
             {
@@ -192,8 +190,8 @@ bool Particle::update()
     {
         if ((mAlive & mDeathEffectConditions) > 0x00 && !mDeathEffect.empty())
         {
-            Particle* deathEffect = particleEngine->addEffect(mDeathEffect, 0, 0);
-            deathEffect->moveBy(mPos);
+            if (Particle *deathEffect = particleEngine->addEffect(mDeathEffect, 0, 0))
+                deathEffect->moveBy(mPos);
         }
         mAlive = DEAD_LONG_AGO;
     }
@@ -249,110 +247,57 @@ Particle *Particle::createChild()
 Particle *Particle::addEffect(const std::string &particleEffectFile,
                               int pixelX, int pixelY, int rotation)
 {
-    Particle *newParticle = nullptr;
-
-    std::string::size_type pos = particleEffectFile.find('|');
-    std::string dyePalettes;
-    if (pos != std::string::npos)
-        dyePalettes = particleEffectFile.substr(pos + 1);
-
-    XML::Document doc(particleEffectFile.substr(0, pos));
-    XML::Node rootNode = doc.rootNode();
-
-    if (!rootNode || rootNode.name() != "effect")
+    auto effect = ResourceManager::getInstance()->getParticleEffect(particleEffectFile);
+    if (!effect)
     {
         Log::info("Error loading particle: %s", particleEffectFile.c_str());
         return nullptr;
     }
 
-    ResourceManager *resman = ResourceManager::getInstance();
-
-    // Parse particles
-    for (auto effectChildNode : rootNode.children())
-    {
-        // We're only interested in particles
-        if (effectChildNode.name() != "particle")
-            continue;
-
-        // Determine the exact particle type
-        XML::Node node;
+    Particle *newParticle = nullptr;
 
-        // Animation
-        if ((node = effectChildNode.findFirstChildByName("animation")))
-        {
-            newParticle = new AnimationParticle(node, dyePalettes);
-        }
-        // Rotational
-        else if ((node = effectChildNode.findFirstChildByName("rotation")))
-        {
-            newParticle = new RotationalParticle(node, dyePalettes);
-        }
-        // Image
-        else if ((node = effectChildNode.findFirstChildByName("image")))
-        {
-            std::string imageSrc { node.textContent() };
-            if (!imageSrc.empty() && !dyePalettes.empty())
-                Dye::instantiate(imageSrc, dyePalettes);
+    // Only the last particle is returned, so pausing it pauses them all
+    auto emissionPaused = std::make_shared<bool>(false);
 
-            auto img = resman->getImage(imageSrc);
-            newParticle = new ImageParticle(img);
-        }
-        // Other
-        else
+    for (const ParticleDef &def : effect->getParticles())
+    {
+        switch (def.type)
         {
+        case ParticleType::Animation:
+            newParticle = new AnimationParticle(def.animation);
+            break;
+        case ParticleType::Rotational:
+            newParticle = new RotationalParticle(def.animation);
+            break;
+        case ParticleType::Image:
+            newParticle = new ImageParticle(def.image);
+            break;
+        case ParticleType::Plain:
             newParticle = new Particle;
+            break;
         }
 
         newParticle->setMap(mMap);
+        newParticle->mEmissionPaused = emissionPaused;
 
-        // Read and set the basic properties of the particle
-        float offsetX = effectChildNode.getFloatProperty("position-x", 0);
-        float offsetY = effectChildNode.getFloatProperty("position-y", 0);
-        float offsetZ = effectChildNode.getFloatProperty("position-z", 0);
-        Vector position(mPos.x + (float)pixelX + offsetX,
-                        mPos.y + (float)pixelY + offsetY,
-                        mPos.z + offsetZ);
+        // Set the basic properties of the particle
+        Vector position(mPos.x + (float)pixelX + def.offsetX,
+                        mPos.y + (float)pixelY + def.offsetY,
+                        mPos.z + def.offsetZ);
         newParticle->moveTo(position);
+        newParticle->setLifetime(def.lifetime);
+        newParticle->setAllowSizeAdjust(def.sizeAdjustable);
 
-        int lifetime = effectChildNode.getProperty("lifetime", -1);
-        newParticle->setLifetime(lifetime);
-        bool resizeable = "false" != effectChildNode.getProperty("size-adjustable", "false");
-        newParticle->setAllowSizeAdjust(resizeable);
+        for (const ParticleEmitterDef &emitter : def.emitters)
+        {
+            newParticle->addEmitter(ParticleEmitter(emitter, effect, newParticle,
+                                                    mMap, rotation));
+        }
 
-        // Look for additional emitters for this particle
-        for (auto emitterNode : effectChildNode.children())
+        if (!def.deathEffect.effect.empty())
         {
-            if (emitterNode.name() == "emitter")
-            {
-                newParticle->addEmitter(ParticleEmitter(emitterNode, newParticle, mMap,
-                                                        rotation, dyePalettes));
-            }
-            else if (emitterNode.name() == "deatheffect")
-            {
-                std::string deathEffect { emitterNode.textContent() };
-                unsigned char deathEffectConditions = 0x00;
-                if (emitterNode.getBoolProperty("on-floor", true))
-                {
-                    deathEffectConditions |= Particle::DEAD_FLOOR;
-                }
-                if (emitterNode.getBoolProperty("on-sky", true))
-                {
-                    deathEffectConditions |= Particle::DEAD_SKY;
-                }
-                if (emitterNode.getBoolProperty("on-other", false))
-                {
-                    deathEffectConditions |= Particle::DEAD_OTHER;
-                }
-                if (emitterNode.getBoolProperty("on-impact", true))
-                {
-                    deathEffectConditions |= Particle::DEAD_IMPACT;
-                }
-                if (emitterNode.getBoolProperty("on-timeout", true))
-                {
-                    deathEffectConditions |= Particle::DEAD_TIMEOUT;
-                }
-                newParticle->setDeathEffect(deathEffect, deathEffectConditions);
-            }
+            newParticle->setDeathEffect(def.deathEffect.effect,
+                                        def.deathEffect.conditions);
         }
 
         mChildParticles.push_back(newParticle);
@@ -400,6 +345,14 @@ Particle *Particle::addTextRiseFadeOutEffect(const std::string &text,
     return newParticle;
 }
 
+void Particle::setEmissionPaused(bool paused)
+{
+    if (mEmissionPaused)
+        *mEmissionPaused = paused;
+    else if (paused)
+        mEmissionPaused = std::make_shared<bool>(true);
+}
+
 void Particle::adjustEmitterSize(int w, int h)
 {
     if (!mAllowSizeAdjust)
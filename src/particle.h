@@ -27,6 +27,7 @@
 #include "vector.h"
 
 #include <list>
+#include <memory>
 #include <string>
 
 class Map;
@@ -198,6 +199,16 @@ class Particle : public Actor
         bool doesFollow() const
         { return mFollow; }
 
+        /**
+         * Sets whether the child emitters of this particle are paused.
+         * Already emitted particles are still updated. The particles created
+         * by the same effect share this state.
+         */
+        void setEmissionPaused(bool paused);
+
+        bool isEmissionPaused() const
+        { return mEmissionPaused && *mEmissionPaused; }
+
         /**
          * Makes the particle move toward another particle with a
          * given acceleration and momentum
@@ -280,6 +291,7 @@ class Particle : public Actor
         int mRandomness = 0;            /**< Ammount of random vector change */
         float mBounce = 0.0f;           /**< How much the particle bounces off when hitting the ground */
         bool mFollow = false;           /**< is this particle moved when its parent particle moves? */
+        std::shared_ptr<bool> mEmissionPaused; /**< Are the child emitters paused? */
 
         // follow-point particles
         Particle *mTarget = nullptr;    /**< The particle that attracts this particle*/
@@ -21,254 +21,50 @@
 
 #include "animationparticle.h"
 #include "imageparticle.h"
-#include "log.h"
 #include "map.h"
 #include "particle.h"
 #include "particleemitter.h"
 #include "rotationalparticle.h"
 
-#include "resources/dye.h"
-#include "resources/image.h"
-#include "resources/resourcemanager.h"
-
 #include <cmath>
 
-#define SIN45 0.707106781f
 #define DEG_RAD_FACTOR 0.017453293f
 
-ParticleEmitter::ParticleEmitter(XML::Node emitterNode, Particle *target,
-                                 Map *map, int rotation,
-                                 const std::string &dyePalettes)
+ParticleEmitter::ParticleEmitter(const ParticleEmitterDef &def,
+                                 const ResourceRef<ParticleEffectDef> &effect,
+                                 Particle *target, Map *map, int rotation)
+    : mDef(&def)
+    , mEffect(effect)
+    , mRotation(rotation)
+    , mParticlePosX(def.posX)
+    , mParticlePosY(def.posY)
+    , mParticlePosZ(def.posZ)
+    , mParticleAngleHorizontal(def.angleHorizontal)
+    , mParticleAngleVertical(def.angleVertical)
+    , mParticlePower(def.power)
+    , mParticleGravity(def.gravity)
+    , mParticleRandomness(def.randomness)
+    , mParticleBounce(def.bounce)
+    , mParticleFollow(def.follow)
+    , mParticleTarget(target)
+    , mParticleAcceleration(def.acceleration)
+    , mParticleDieDistance(def.dieDistance)
+    , mParticleMomentum(def.momentum)
+    , mParticleLifetime(def.lifetime)
+    , mParticleFadeOut(def.fadeOut)
+    , mParticleFadeIn(def.fadeIn)
+    , mMap(map)
+    , mOutput(def.output)
+    , mOutputPause(def.outputPause)
+    , mParticleAlpha(def.alpha)
 {
-    mMap = map;
-    mParticleTarget = target;
-
-    for (auto propertyNode : emitterNode.children())
+    if (def.rotatable)
     {
-        if (propertyNode.name() == "property")
-        {
-            std::string name = propertyNode.getProperty("name", "");
-
-            if (name == "position-x")
-            {
-                mParticlePosX = readParticleEmitterProp(propertyNode, 0.0f);
-            }
-            else if (name == "position-y")
-            {
-                mParticlePosY = readParticleEmitterProp(propertyNode, 0.0f);
-                mParticlePosY.minVal *= SIN45;
-                mParticlePosY.maxVal *= SIN45;
-                mParticlePosY.changeAmplitude *= SIN45;
-             }
-            else if (name == "position-z")
-            {
-                mParticlePosZ = readParticleEmitterProp(propertyNode, 0.0f);
-                mParticlePosZ.minVal *= SIN45;
-                mParticlePosZ.maxVal *= SIN45;
-                mParticlePosZ.changeAmplitude *= SIN45;
-            }
-            else if (name == "image")
-            {
-                std::string image = propertyNode.getProperty("value", "");
-                if (!image.empty() && !mParticleImage)
-                {
-                    if (!dyePalettes.empty())
-                        Dye::instantiate(image, dyePalettes);
-
-                    ResourceManager *resman = ResourceManager::getInstance();
-                    mParticleImage = resman->getImage(image);
-                }
-            }
-            else if (name == "horizontal-angle")
-            {
-                mParticleAngleHorizontal = readParticleEmitterProp(propertyNode, 0.0f);
-                mParticleAngleHorizontal.minVal += rotation;
-                mParticleAngleHorizontal.minVal *= DEG_RAD_FACTOR;
-                mParticleAngleHorizontal.maxVal += rotation;
-                mParticleAngleHorizontal.maxVal *= DEG_RAD_FACTOR;
-                mParticleAngleHorizontal.changeAmplitude *= DEG_RAD_FACTOR;
-            }
-            else if (name == "vertical-angle")
-            {
-                mParticleAngleVertical = readParticleEmitterProp(propertyNode, 0.0f);
-                mParticleAngleVertical.minVal *= DEG_RAD_FACTOR;
-                mParticleAngleVertical.maxVal *= DEG_RAD_FACTOR;
-                mParticleAngleVertical.changeAmplitude *= DEG_RAD_FACTOR;
-            }
-            else if (name == "power")
-            {
-                mParticlePower = readParticleEmitterProp(propertyNode, 0.0f);
-            }
-            else if (name == "gravity")
-            {
-                mParticleGravity = readParticleEmitterProp(propertyNode, 0.0f);
-            }
-            else if (name == "randomnes" || name == "randomness") // legacy bug
-            {
-                mParticleRandomness = readParticleEmitterProp(propertyNode, 0);
-            }
-            else if (name == "bounce")
-            {
-                mParticleBounce = readParticleEmitterProp(propertyNode, 0.0f);
-            }
-            else if (name == "lifetime")
-            {
-                mParticleLifetime = readParticleEmitterProp(propertyNode, 0);
-                mParticleLifetime.minVal += 1;
-            }
-            else if (name == "output")
-            {
-                mOutput = readParticleEmitterProp(propertyNode, 0);
-                mOutput.maxVal +=1;
-            }
-            else if (name == "output-pause")
-            {
-                mOutputPause = readParticleEmitterProp(propertyNode, 0);
-                mOutputPauseLeft = mOutputPause.value(0);
-            }
-            else if (name == "acceleration")
-            {
-                mParticleAcceleration = readParticleEmitterProp(propertyNode, 0.0f);
-            }
-            else if (name == "die-distance")
-            {
-                mParticleDieDistance = readParticleEmitterProp(propertyNode, 0.0f);
-            }
-            else if (name == "momentum")
-            {
-                mParticleMomentum = readParticleEmitterProp(propertyNode, 1.0f);
-            }
-            else if (name == "fade-out")
-            {
-                mParticleFadeOut = readParticleEmitterProp(propertyNode, 0);
-            }
-            else if (name == "fade-in")
-            {
-                mParticleFadeIn = readParticleEmitterProp(propertyNode, 0);
-            }
-            else if (name == "alpha")
-            {
-                mParticleAlpha = readParticleEmitterProp(propertyNode, 1.0f);
-            }
-            else if (name == "follow-parent")
-            {
-                mParticleFollow = propertyNode.getBoolProperty("value", true);
-            }
-            else
-            {
-                Log::info("Particle Engine: Warning, unknown emitter property \"%s\"",
-                          name.c_str());
-            }
-        }
-        else if (propertyNode.name() == "emitter")
-        {
-            ParticleEmitter newEmitter(propertyNode, mParticleTarget, map,
-                                       rotation, dyePalettes);
-            mParticleChildEmitters.push_back(std::move(newEmitter));
-        }
-        else if (propertyNode.name() == "rotation")
-        {
-            mParticleRotation = Animation::fromXML(propertyNode);
-        }
-        else if (propertyNode.name() == "animation")
-        {
-            mParticleAnimation = Animation::fromXML(propertyNode);
-        }
-        else if (propertyNode.name() == "deatheffect")
-        {
-            mDeathEffect = propertyNode.textContent();
-
-            if (propertyNode.getBoolProperty("on-floor", true))
-            {
-                mDeathEffectConditions |= Particle::DEAD_FLOOR;
-            }
-            if (propertyNode.getBoolProperty("on-sky", true))
-            {
-                mDeathEffectConditions |= Particle::DEAD_SKY;
-            }
-            if (propertyNode.getBoolProperty("on-other", false))
-            {
-                mDeathEffectConditions |= Particle::DEAD_OTHER;
-            }
-            if (propertyNode.getBoolProperty("on-impact", true))
-            {
-                mDeathEffectConditions |= Particle::DEAD_IMPACT;
-            }
-            if (propertyNode.getBoolProperty("on-timeout", true))
-            {
-                mDeathEffectConditions |= Particle::DEAD_TIMEOUT;
-            }
-        }
+        mParticleAngleHorizontal.minVal += rotation * DEG_RAD_FACTOR;
+        mParticleAngleHorizontal.maxVal += rotation * DEG_RAD_FACTOR;
     }
 }
 
-ParticleEmitter::ParticleEmitter(const ParticleEmitter &o)
-{
-    *this = o;
-}
-
-ParticleEmitter & ParticleEmitter::operator=(const ParticleEmitter &o)
-{
-    mParticlePosX = o.mParticlePosX;
-    mParticlePosY = o.mParticlePosY;
-    mParticlePosZ = o.mParticlePosZ;
-    mParticleAngleHorizontal = o.mParticleAngleHorizontal;
-    mParticleAngleVertical = o.mParticleAngleVertical;
-    mParticlePower = o.mParticlePower;
-    mParticleGravity = o.mParticleGravity;
-    mParticleRandomness = o.mParticleRandomness;
-    mParticleBounce = o.mParticleBounce;
-    mParticleFollow = o.mParticleFollow;
-    mParticleTarget = o.mParticleTarget;
-    mParticleAcceleration = o.mParticleAcceleration;
-    mParticleDieDistance = o.mParticleDieDistance;
-    mParticleMomentum = o.mParticleMomentum;
-    mParticleLifetime = o.mParticleLifetime;
-    mParticleFadeOut = o.mParticleFadeOut;
-    mParticleFadeIn = o.mParticleFadeIn;
-    mParticleAlpha = o.mParticleAlpha;
-    mMap = o.mMap;
-    mOutput = o.mOutput;
-    mOutputPause = o.mOutputPause;
-    mParticleImage = o.mParticleImage;
-    mParticleAnimation = o.mParticleAnimation;
-    mParticleRotation = o.mParticleRotation;
-    mParticleChildEmitters = o.mParticleChildEmitters;
-
-    mOutputPauseLeft = 0;
-
-    return *this;
-}
-
-
-ParticleEmitter::~ParticleEmitter() = default;
-
-
-template <typename T> ParticleEmitterProp<T>
-ParticleEmitter::readParticleEmitterProp(XML::Node propertyNode, T def)
-{
-    def = propertyNode.getFloatProperty("value", (double) def);
-    const T min = (T) propertyNode.getFloatProperty("min", (double) def);
-    const T max = (T) propertyNode.getFloatProperty("max", (double) def);
-
-    ParticleEmitterProp<T> retval(min, max);
-
-    std::string change = propertyNode.getProperty("change-func", "none");
-    T amplitude = (T) propertyNode.getFloatProperty("change-amplitude", 0.0);
-    int period = propertyNode.getProperty("change-period", 0);
-    int phase = propertyNode.getProperty("change-phase", 0);
-    if (change == "saw" || change == "sawtooth")
-        retval.setFunction(FUNC_SAW, amplitude, period, phase);
-    else if (change == "sine" || change == "sinewave")
-        retval.setFunction(FUNC_SINE, amplitude, period, phase);
-    else if (change == "triangle")
-        retval.setFunction(FUNC_TRIANGLE, amplitude, period, phase);
-    else if (change == "square")
-        retval.setFunction(FUNC_SQUARE, amplitude, period, phase);
-
-    return retval;
-}
-
 
 std::list<Particle *> ParticleEmitter::createParticles(int tick)
 {
@@ -287,17 +83,17 @@ std::list<Particle *> ParticleEmitter::createParticles(int tick)
         if (Particle::particleCount > Particle::maxCount) break;
 
         Particle *newParticle;
-        if (mParticleImage)
+        if (mDef->image)
         {
-            newParticle = new ImageParticle(mParticleImage);
+            newParticle = new ImageParticle(mDef->image);
         }
-        else if (mParticleRotation.getLength() > 0)
+        else if (mDef->rotation.getLength() > 0)
         {
-            newParticle = new RotationalParticle(mParticleRotation);
+            newParticle = new RotationalParticle(mDef->rotation);
         }
-        else if (mParticleAnimation.getLength() > 0)
+        else if (mDef->animation.getLength() > 0)
         {
-            newParticle = new AnimationParticle(mParticleAnimation);
+            newParticle = new AnimationParticle(mDef->animation);
         }
         else
         {
@@ -335,11 +131,16 @@ std::list<Particle *> ParticleEmitter::createParticles(int tick)
         newParticle->setFadeIn(mParticleFadeIn.value(tick));
         newParticle->setAlpha(mParticleAlpha.value(tick));
 
-        for (auto &particleChildEmitter : mParticleChildEmitters)
-            newParticle->addEmitter(particleChildEmitter);
+        for (auto &childEmitter : mDef->childEmitters)
+        {
+            newParticle->addEmitter(ParticleEmitter(childEmitter, mEffect,
+                                                    mParticleTarget, mMap,
+                                                    mRotation));
+        }
 
-        if (!mDeathEffect.empty())
-            newParticle->setDeathEffect(mDeathEffect, mDeathEffectConditions);
+        if (!mDef->deathEffect.effect.empty())
+            newParticle->setDeathEffect(mDef->deathEffect.effect,
+                                        mDef->deathEffect.conditions);
 
         newParticles.push_back(newParticle);
     }
@@ -23,14 +23,11 @@
 
 #include "particleemitterprop.h"
 
-#include "resources/animation.h"
+#include "resources/particleeffectdef.h"
 #include "resources/resource.h"
 
-#include "utils/xml.h"
-
 #include <list>
 
-class Image;
 class Map;
 class Particle;
 
@@ -41,23 +38,16 @@ class Particle;
 class ParticleEmitter
 {
     public:
-        ParticleEmitter(XML::Node emitterNode,
-                        Particle *target,
-                        Map *map,
-                        int rotation = 0,
-                        const std::string &dyePalettes = std::string());
-
         /**
-         * Copy Constructor (necessary for reference counting of particle images)
+         * Creates an emitter from its definition. The \a effect keeps the
+         * definition, and the images it refers to, alive for as long as the
+         * emitter exists.
          */
-        ParticleEmitter(const ParticleEmitter &o);
-
-        /**
-         * Assignment operator that calls the copy constructor
-         */
-        ParticleEmitter & operator=(const ParticleEmitter &o);
-
-        ~ParticleEmitter();
+        ParticleEmitter(const ParticleEmitterDef &def,
+                        const ResourceRef<ParticleEffectDef> &effect,
+                        Particle *target,
+                        Map *map,
+                        int rotation = 0);
 
         /**
          * Spawns new particles
@@ -78,7 +68,9 @@ class ParticleEmitter
         void adjustSize(int w, int h);
 
     private:
-        template <typename T> ParticleEmitterProp<T> readParticleEmitterProp(XML::Node propertyNode, T def);
+        const ParticleEmitterDef *mDef;
+        ResourceRef<ParticleEffectDef> mEffect;
+        int mRotation;
 
         /**
          * initial position of particles:
@@ -101,43 +93,28 @@ class ParticleEmitter
         ParticleEmitterProp<float> mParticleGravity;
         ParticleEmitterProp<int> mParticleRandomness;
         ParticleEmitterProp<float> mParticleBounce;
-        bool mParticleFollow = false;
+        bool mParticleFollow;
 
         /*
          * Properties of targeting particles:
          */
         Particle *mParticleTarget;
         ParticleEmitterProp<float> mParticleAcceleration;
-        ParticleEmitterProp<float> mParticleDieDistance { -1.0f };
-        ParticleEmitterProp<float> mParticleMomentum { 1.0f };
+        ParticleEmitterProp<float> mParticleDieDistance;
+        ParticleEmitterProp<float> mParticleMomentum;
 
         /*
          * Behavior over time of the particles:
          */
-        ParticleEmitterProp<int> mParticleLifetime { -1 };
+        ParticleEmitterProp<int> mParticleLifetime;
         ParticleEmitterProp<int> mParticleFadeOut;
         ParticleEmitterProp<int> mParticleFadeIn;
 
         Map *mMap;             /**< Map the particles are spawned on */
 
-        ParticleEmitterProp<int> mOutput { 1 }; /**< Number of particles spawned per update */
+        ParticleEmitterProp<int> mOutput;       /**< Number of particles spawned per update */
         ParticleEmitterProp<int> mOutputPause;  /**< Pause in frames between two spawns */
         int mOutputPauseLeft = 0;
 
-        /*
-         * Graphical representation of the particles
-         */
-        ResourceRef<Image> mParticleImage; /**< Particle image, if used */
-        Animation mParticleAnimation; /**< Filename of particle animation file */
-        Animation mParticleRotation; /**< Filename of particle rotation file */
-        ParticleEmitterProp<float> mParticleAlpha { 1.0f }; /**< Opacity of the graphical representation of the particles */
-
-        /*
-         * Death effect of the particles
-         */
-        std::string mDeathEffect;
-        unsigned char mDeathEffectConditions = 0x00;
-
-        /** List of emitters the spawned particles are equipped with */
-        std::list<ParticleEmitter> mParticleChildEmitters;
+        ParticleEmitterProp<float> mParticleAlpha; /**< Opacity of the graphical representation of the particles */
 };
@@ -107,7 +107,7 @@ const std::string &BeingInfo::getSound(SoundEvent event) const
 const Attack &BeingInfo::getAttack(int id) const
 {
     static const Attack empty {
-        SpriteAction::ATTACK,
+        SpriteAction::ATTACK_ID,
         -1, // Default strike effect on monster
         paths.getIntValue("hitEffectId"),
         paths.getIntValue("criticalHitEffectId"),
@@ -33,7 +33,7 @@
 
 struct Attack
 {
-    std::string action = SpriteAction::ATTACK;
+    ActionId action = SpriteAction::ATTACK_ID;
     int effectId = 0;
     int hitEffectId = 0;
     int criticalHitEffectId = 0;
@@ -77,6 +77,9 @@ public:
     void addSound(SoundEvent event, const std::string &filename);
     const std::string &getSound(SoundEvent event) const;
 
+    const std::map<SoundEvent, std::vector<std::string>> &getSounds() const
+    { return mSounds; }
+
     void addAttack(int id, Attack attack);
     const Attack &getAttack(int id) const;
 
@@ -24,7 +24,10 @@
 #include "resources/dye.h"
 #include "resources/resourcemanager.h"
 
+#include "sdlgraphics.h"
+
 #ifdef USE_OPENGL
+#include "modernopenglgraphics.h"
 #include "openglgraphics.h"
 #endif
 
@@ -79,10 +82,20 @@ Image::Image(GLuint glimage, int width, int height, int texWidth, int texHeight)
 }
 #endif
 
+size_t Image::getMemorySize() const
+{
+#ifdef USE_OPENGL
+    if (mGLImage)
+        return static_cast<size_t>(mTexWidth) * mTexHeight * 4;
+#endif
+    return static_cast<size_t>(mBounds.w) * mBounds.h * 4;
+}
+
 Image::~Image()
 {
     if (mTexture)
     {
+        SDLGraphics::textureDeleted(mTexture);
         SDL_DestroyTexture(mTexture);
         mTexture = nullptr;
     }
@@ -90,6 +103,12 @@ Image::~Image()
 #ifdef USE_OPENGL
     if (mGLImage)
     {
+        ModernOpenGLGraphics::textureDeleted(mGLImage);
+
+        // The name may be reused by the next texture that is created
+        if (OpenGLGraphics::mLastImage == mGLImage)
+            OpenGLGraphics::mLastImage = 0;
+
         glDeleteTextures(1, &mGLImage);
         mGLImage = 0;
     }
@@ -264,7 +283,6 @@ Image *Image::_GLload(SDL_Surface *image)
                  0, GL_RGBA, GL_UNSIGNED_BYTE,
                  image->pixels);
 
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
     glTexParameteri(mTextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(mTextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
@@ -46,11 +46,14 @@ class Image : public Resource
     friend class SDLGraphics;
 #ifdef USE_OPENGL
     friend class OpenGLGraphics;
+    friend class ModernOpenGLGraphics;
 #endif
 
     public:
         ~Image() override;
 
+        size_t getMemorySize() const override;
+
         /**
          * Loads an image from an SDL_RWops structure.
          *
@@ -223,6 +226,11 @@ class SubImage : public Image
 
         ~SubImage() override;
 
+        /**
+         * Sub-images share the texture of their parent.
+         */
+        size_t getMemorySize() const override { return 0; }
+
     private:
         ResourceRef<Image> mParent;
 };
@@ -122,6 +122,7 @@ static uint8_t directionFromString(std::string_view name)
 void ItemDB::loadEmptyItemDefinition()
 {
     mUnknown->name = _("Unknown item");
+    mUnknown->normalizedName = normalize(mUnknown->name);
     mUnknown->display = SpriteDisplay();
     std::string errFile = paths.getStringValue("spriteErrorFile");
     mUnknown->setSprite(errFile, Gender::Male, 0);
@@ -299,7 +300,8 @@ void ItemDB::loadCommonRef(ItemInfo &itemInfo, XML::Node node, const std::string
     node.attribute("description", itemInfo.description);
     if (!node.attribute("use-text", itemInfo.useText))
         node.attribute("useButton", itemInfo.useText);  // supported for compatibility
-    node.attribute("attack-action", itemInfo.attackAction);
+    itemInfo.attackAction =
+            SpriteAction::getId(node.getProperty("attack-action", std::string()));
     node.attribute("attack-range", itemInfo.attackRange);
     node.attribute("missile-particle", itemInfo.missileParticleFile);
     itemInfo.hitEffectId = node.getProperty("hit-effect-id",
@@ -341,10 +343,11 @@ void ItemDB::addItem(ItemInfo *itemInfo)
 {
     std::string itemName = itemInfo->name;
     itemInfo->name = itemName.empty() ? _("unnamed") : itemName;
+    itemInfo->normalizedName = normalize(itemInfo->name);
     mItemInfos[itemInfo->id] = itemInfo;
     if (!itemName.empty())
     {
-        std::string temp = normalize(itemName);
+        const std::string &temp = itemInfo->normalizedName;
 
         auto itr = mNamedItemInfos.find(temp);
         if (itr == mNamedItemInfos.end())
@@ -370,7 +373,7 @@ static void checkParameter(int id, const T param, const T errorValue)
 void ItemDB::checkItemInfo(ItemInfo &itemInfo)
 {
     int id = itemInfo.id;
-    if (!itemInfo.attackAction.empty())
+    if (itemInfo.attackAction != SpriteAction::INVALID_ID)
         if (itemInfo.attackRange == 0)
             Log::info("ItemDB: Missing attack range from weapon %i!", id);
 
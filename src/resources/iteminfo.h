@@ -111,6 +111,7 @@ public:
 
     int id = 0;                         /**< Item ID */
     std::string name;
+    std::string normalizedName;         /**< Normalized name, for searching */
     SpriteDisplay display;              /**< Display info (like icon) */
     std::string description;            /**< Short description. */
     std::vector<std::string> effect;    /**< Description of effects. */
@@ -126,7 +127,7 @@ public:
      * See SpriteAction in spritedef.h for more info.
      * Attack action sub-types (bow, sword, ...) are defined in items.xml.
      */
-    std::string attackAction = SpriteAction::INVALID;
+    ActionId attackAction = SpriteAction::INVALID_ID;
 
     /** Attack range, will be equal to ATTACK_RANGE_NOT_SET if no weapon. */
     int attackRange = 0;
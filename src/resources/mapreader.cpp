@@ -259,7 +259,7 @@ static void setTile(Map *map, MapLayer *layer, int x, int y, unsigned gid)
         layer->setTile(x, y, img);
 
         if (TileAnimation *ani = map->getAnimationForGid(gid))
-            ani->addAffectedTile(layer, x + y * layer->getWidth());
+            layer->setAnimation(x, y, ani);
     }
     else
     {
@@ -0,0 +1,402 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/minimapgenerator.h"
+
+#include "log.h"
+#include "map.h"
+#include "tileset.h"
+
+#include "utils/filesystem.h"
+#include "utils/mkdir.h"
+#include "utils/sha256.h"
+
+#include <SDL_image.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Size in pixels of a tile on a generated minimap.
+ */
+static constexpr int MINIMAP_TILE_SIZE = 2;
+
+/**
+ * Changing this invalidates all cached minimaps.
+ */
+static constexpr const char *MINIMAP_VERSION = "1";
+
+/**
+ * A copy of everything needed from the map to generate its minimap, so that
+ * the worker thread doesn't need to access the map.
+ */
+struct MinimapJob
+{
+    struct Tile
+    {
+        int source;         /**< Index in the list of images */
+        SDL_Rect rect;      /**< Area of the tile in its image */
+    };
+
+    struct Layer
+    {
+        int x, y;
+        int width, height;
+        std::vector<int> tiles;     /**< Tile indices, -1 for no tile */
+    };
+
+    unsigned request = 0;
+    std::string mapPath;
+    int width = 0;
+    int height = 0;
+    std::vector<std::string> sources;
+    std::vector<Tile> tiles;
+    std::vector<Layer> layers;
+};
+
+struct TileColor
+{
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 0.0f;
+};
+
+static SDL_Surface *loadRGBA(SDL_RWops *rw)
+{
+    if (!rw)
+        return nullptr;
+
+    SDL_Surface *loaded = IMG_Load_RW(rw, 1);
+    if (!loaded)
+        return nullptr;
+
+    SDL_Surface *converted =
+            SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    return converted;
+}
+
+/**
+ * Averages the color of the given area, weighted by alpha. The alpha of the
+ * result is the average coverage of the area.
+ */
+static TileColor averageColor(const SDL_Surface *surface, const SDL_Rect &rect)
+{
+    TileColor color;
+
+    const SDL_Rect bounds = { 0, 0, surface->w, surface->h };
+    SDL_Rect area;
+    if (!SDL_IntersectRect(&rect, &bounds, &area))
+        return color;
+
+    float alphaSum = 0.0f;
+    for (int y = area.y; y < area.y + area.h; y++)
+    {
+        auto row = static_cast<const Uint8*>(surface->pixels) + y * surface->pitch;
+        for (int x = area.x; x < area.x + area.w; x++)
+        {
+            const Uint8 *pixel = row + x * 4;
+            const float alpha = pixel[3] / 255.0f;
+            color.r += pixel[0] * alpha;
+            color.g += pixel[1] * alpha;
+            color.b += pixel[2] * alpha;
+            alphaSum += alpha;
+        }
+    }
+
+    if (alphaSum > 0.0f)
+    {
+        color.r /= alphaSum;
+        color.g /= alphaSum;
+        color.b /= alphaSum;
+        color.a = alphaSum / (area.w * area.h);
+    }
+
+    return color;
+}
+
+static SDL_Surface *renderMinimap(const MinimapJob &job)
+{
+    // Determine the average color of each tile, loading each image once
+    std::vector<TileColor> colors(job.tiles.size());
+
+    for (size_t source = 0; source < job.sources.size(); source++)
+    {
+        SDL_Surface *surface = loadRGBA(FS::openRWops(job.sources[source]));
+        if (!surface)
+        {
+            Log::warn("Minimap generator failed to load %s",
+                      job.sources[source].c_str());
+            continue;
+        }
+
+        for (size_t i = 0; i < job.tiles.size(); i++)
+            if (job.tiles[i].source == static_cast<int>(source))
+                colors[i] = averageColor(surface, job.tiles[i].rect);
+
+        SDL_FreeSurface(surface);
+    }
+
+    SDL_Surface *minimap = SDL_CreateRGBSurfaceWithFormat(
+                0,
+                job.width * MINIMAP_TILE_SIZE,
+                job.height * MINIMAP_TILE_SIZE,
+                32, SDL_PIXELFORMAT_RGBA32);
+    if (!minimap)
+        return nullptr;
+
+    for (int y = 0; y < job.height; y++)
+    {
+        for (int x = 0; x < job.width; x++)
+        {
+            // Blend the layers from bottom to top, premultiplied by alpha
+            TileColor result;
+            for (const auto &layer : job.layers)
+            {
+                const int lx = x - layer.x;
+                const int ly = y - layer.y;
+                if (lx < 0 || ly < 0 || lx >= layer.width || ly >= layer.height)
+                    continue;
+
+                const int tile = layer.tiles[lx + ly * layer.width];
+                if (tile < 0)
+                    continue;
+
+                const TileColor &c = colors[tile];
+                result.r = c.r * c.a + result.r * (1.0f - c.a);
+                result.g = c.g * c.a + result.g * (1.0f - c.a);
+                result.b = c.b * c.a + result.b * (1.0f - c.a);
+                result.a = c.a + result.a * (1.0f - c.a);
+            }
+
+            Uint8 pixel[4] = { 0, 0, 0, 0 };
+            if (result.a > 0.0f)
+            {
+                pixel[0] = static_cast<Uint8>(result.r / result.a);
+                pixel[1] = static_cast<Uint8>(result.g / result.a);
+                pixel[2] = static_cast<Uint8>(result.b / result.a);
+                pixel[3] = static_cast<Uint8>(result.a * 255.0f);
+            }
+
+            for (int py = 0; py < MINIMAP_TILE_SIZE; py++)
+            {
+                auto row = static_cast<Uint8*>(minimap->pixels)
+                        + (y * MINIMAP_TILE_SIZE + py) * minimap->pitch;
+                for (int px = 0; px < MINIMAP_TILE_SIZE; px++)
+                    SDL_memcpy(row + (x * MINIMAP_TILE_SIZE + px) * 4, pixel, 4);
+            }
+        }
+    }
+
+    return minimap;
+}
+
+/**
+ * Returns the cache key for the map at the given path, or an empty string
+ * when the map file could not be read.
+ */
+static std::string cacheKey(const std::string &mapPath)
+{
+    size_t size;
+    void *data = FS::loadFile(mapPath, size);
+    if (!data)
+        return std::string();
+
+    std::string contents(static_cast<const char*>(data), size);
+    SDL_free(data);
+
+    return sha256(contents + MINIMAP_VERSION);
+}
+
+MinimapGenerator::MinimapGenerator(const std::string &cacheDir)
+    : mCacheDir(cacheDir)
+{
+    if (mkdir_r(mCacheDir.c_str()))
+        Log::warn("Failed to create minimap cache directory %s",
+                  mCacheDir.c_str());
+
+    mThread = SDL_CreateThread(generatorThread, "MinimapGenerator", this);
+}
+
+MinimapGenerator::~MinimapGenerator()
+{
+    {
+        MutexLocker lock(&mMutex);
+        mQuit = true;
+        mWakeUp.signal();
+    }
+
+    if (mThread)
+        SDL_WaitThread(mThread, nullptr);
+
+    if (mResult)
+        SDL_FreeSurface(mResult);
+}
+
+void MinimapGenerator::generate(const Map *map)
+{
+    auto job = std::make_unique<MinimapJob>();
+    job->mapPath = map->getProperty("_filename");
+    job->width = map->getWidth();
+    job->height = map->getHeight();
+
+    // Assign an index to each tile, and collect the images they are from
+    std::unordered_map<const Image*, int> tileIndices;
+    std::map<std::string, int> sourceIndices;
+
+    for (const Tileset *tileset : map->getTilesets())
+    {
+        std::string path = tileset->getImagePath();
+        path = path.substr(0, path.find('|'));  // Strip dye
+
+        auto [it, inserted] = sourceIndices.try_emplace(path, job->sources.size());
+        if (inserted)
+            job->sources.push_back(path);
+
+        for (size_t i = 0; i < tileset->size(); i++)
+        {
+            tileIndices[tileset->get(i)] = job->tiles.size();
+            job->tiles.push_back({ it->second, tileset->getTileRect(i) });
+        }
+    }
+
+    for (const MapLayer *mapLayer : map->getLayers())
+    {
+        // Alternative layers are only shown on demand
+        if ((mapLayer->getMask() & 1) == 0)
+            continue;
+
+        MinimapJob::Layer &layer = job->layers.emplace_back();
+        layer.x = mapLayer->getX();
+        layer.y = mapLayer->getY();
+        layer.width = mapLayer->getWidth();
+        layer.height = mapLayer->getHeight();
+        layer.tiles.reserve(layer.width * layer.height);
+
+        for (int y = 0; y < layer.height; y++)
+        {
+            for (int x = 0; x < layer.width; x++)
+            {
+                auto it = tileIndices.find(mapLayer->getTile(x, y));
+                layer.tiles.push_back(it == tileIndices.end() ? -1 : it->second);
+            }
+        }
+    }
+
+    MutexLocker lock(&mMutex);
+    job->request = ++mRequest;
+    mJob = std::move(job);
+
+    if (mResult)
+    {
+        SDL_FreeSurface(mResult);
+        mResult = nullptr;
+    }
+    mDone = false;
+
+    mWakeUp.signal();
+}
+
+void MinimapGenerator::cancel()
+{
+    MutexLocker lock(&mMutex);
+    ++mRequest;
+    mJob.reset();
+
+    if (mResult)
+    {
+        SDL_FreeSurface(mResult);
+        mResult = nullptr;
+    }
+    mDone = false;
+}
+
+bool MinimapGenerator::takeResult(SDL_Surface *&result)
+{
+    MutexLocker lock(&mMutex);
+    if (!mDone)
+        return false;
+
+    result = mResult;
+    mResult = nullptr;
+    mDone = false;
+    return true;
+}
+
+int MinimapGenerator::generatorThread(void *data)
+{
+    auto generator = static_cast<MinimapGenerator*>(data);
+
+    while (true)
+    {
+        std::unique_ptr<MinimapJob> job;
+        {
+            MutexLocker lock(&generator->mMutex);
+
+            while (!generator->mJob && !generator->mQuit)
+                generator->mWakeUp.wait(generator->mMutex);
+
+            if (generator->mQuit)
+                break;
+
+            job = std::move(generator->mJob);
+        }
+
+        const std::string key = cacheKey(job->mapPath);
+        const std::string cachePath = generator->mCacheDir + "/" + key + ".png";
+
+        SDL_Surface *minimap = nullptr;
+        if (!key.empty())
+            minimap = loadRGBA(SDL_RWFromFile(cachePath.c_str(), "rb"));
+
+        if (!minimap)
+        {
+            minimap = renderMinimap(*job);
+
+            if (minimap && !key.empty() &&
+                    IMG_SavePNG(minimap, cachePath.c_str()) != 0)
+            {
+                Log::warn("Failed to save minimap %s: %s",
+                          cachePath.c_str(), IMG_GetError());
+            }
+        }
+
+        MutexLocker lock(&generator->mMutex);
+
+        // Drop the result when another request came in meanwhile
+        if (job->request != generator->mRequest)
+        {
+            if (minimap)
+                SDL_FreeSurface(minimap);
+            continue;
+        }
+
+        // A failure is reported as well, so the window can stop waiting
+        if (!minimap)
+            Log::warn("Failed to generate minimap for %s", job->mapPath.c_str());
+
+        generator->mResult = minimap;
+        generator->mDone = true;
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "utils/mutex.h"
+
+#include <SDL.h>
+
+#include <memory>
+#include <string>
+
+class Map;
+struct MinimapJob;
+
+/**
+ * Generates minimap images for maps that don't come with one.
+ *
+ * The average color of each tile is drawn at a few pixels per tile, using the
+ * layers of the map from bottom to top. The work is done on a worker thread,
+ * and the results are cached on disk by the hash of the map file.
+ */
+class MinimapGenerator
+{
+public:
+    /**
+     * Creates the generator, caching generated minimaps in the given
+     * directory.
+     */
+    MinimapGenerator(const std::string &cacheDir);
+    ~MinimapGenerator();
+
+    /**
+     * Starts generating the minimap for the given map. The map is only
+     * accessed during this call. Any unfinished request is dropped.
+     */
+    void generate(const Map *map);
+
+    /**
+     * Drops any unfinished request.
+     */
+    void cancel();
+
+    /**
+     * Returns whether the last request is done, in which case the minimap is
+     * returned through <code>result</code>. The result is
+     * <code>nullptr</code> when the minimap could not be generated. The
+     * caller takes ownership of the returned surface.
+     */
+    bool takeResult(SDL_Surface *&result);
+
+private:
+    static int generatorThread(void *data);
+
+    Mutex mMutex;
+    Condition mWakeUp;
+    std::unique_ptr<MinimapJob> mJob;   /**< Request not yet started */
+    SDL_Surface *mResult = nullptr;
+    bool mDone = false;                 /**< Whether a result is available */
+    unsigned mRequest = 0;              /**< Id of the last request */
+    std::string mCacheDir;
+    SDL_Thread *mThread = nullptr;
+    bool mQuit = false;
+};
@@ -133,7 +133,8 @@ void MonsterDB::readMonsterNode(XML::Node node, const std::string &filename)
             attack.missileParticleFilename =
                 spriteNode.getProperty("missile-particle", "");
 
-            attack.action = spriteNode.getProperty("action", "attack");
+            attack.action = SpriteAction::getId(
+                        spriteNode.getProperty("action", SpriteAction::ATTACK));
 
             currentInfo->addAttack(id, std::move(attack));
         }
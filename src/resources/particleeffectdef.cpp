@@ -0,0 +1,278 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/particleeffectdef.h"
+
+#include "log.h"
+#include "particle.h"
+
+#include "resources/dye.h"
+#include "resources/image.h"
+#include "resources/resourcemanager.h"
+
+#define SIN45 0.707106781f
+#define DEG_RAD_FACTOR 0.017453293f
+
+template <typename T>
+static ParticleEmitterProp<T> readParticleEmitterProp(XML::Node propertyNode,
+                                                      T def)
+{
+    def = propertyNode.getFloatProperty("value", (double) def);
+    const T min = (T) propertyNode.getFloatProperty("min", (double) def);
+    const T max = (T) propertyNode.getFloatProperty("max", (double) def);
+
+    ParticleEmitterProp<T> retval(min, max);
+
+    std::string change = propertyNode.getProperty("change-func", "none");
+    T amplitude = (T) propertyNode.getFloatProperty("change-amplitude", 0.0);
+    int period = propertyNode.getProperty("change-period", 0);
+    int phase = propertyNode.getProperty("change-phase", 0);
+    if (change == "saw" || change == "sawtooth")
+        retval.setFunction(FUNC_SAW, amplitude, period, phase);
+    else if (change == "sine" || change == "sinewave")
+        retval.setFunction(FUNC_SINE, amplitude, period, phase);
+    else if (change == "triangle")
+        retval.setFunction(FUNC_TRIANGLE, amplitude, period, phase);
+    else if (change == "square")
+        retval.setFunction(FUNC_SQUARE, amplitude, period, phase);
+
+    return retval;
+}
+
+template <typename T>
+static void scale(ParticleEmitterProp<T> &prop, T factor)
+{
+    prop.minVal *= factor;
+    prop.maxVal *= factor;
+    prop.changeAmplitude *= factor;
+}
+
+static ParticleDeathEffect readDeathEffect(XML::Node node)
+{
+    ParticleDeathEffect deathEffect;
+    deathEffect.effect = node.textContent();
+
+    if (node.getBoolProperty("on-floor", true))
+        deathEffect.conditions |= Particle::DEAD_FLOOR;
+    if (node.getBoolProperty("on-sky", true))
+        deathEffect.conditions |= Particle::DEAD_SKY;
+    if (node.getBoolProperty("on-other", false))
+        deathEffect.conditions |= Particle::DEAD_OTHER;
+    if (node.getBoolProperty("on-impact", true))
+        deathEffect.conditions |= Particle::DEAD_IMPACT;
+    if (node.getBoolProperty("on-timeout", true))
+        deathEffect.conditions |= Particle::DEAD_TIMEOUT;
+
+    return deathEffect;
+}
+
+static ResourceRef<Image> loadImage(std::string image,
+                                    const std::string &dyePalettes)
+{
+    if (!dyePalettes.empty())
+        Dye::instantiate(image, dyePalettes);
+
+    return ResourceManager::getInstance()->getImage(image);
+}
+
+void ParticleEmitterDef::load(XML::Node emitterNode,
+                              const std::string &dyePalettes)
+{
+    for (auto propertyNode : emitterNode.children())
+    {
+        if (propertyNode.name() == "property")
+        {
+            std::string name = propertyNode.getProperty("name", "");
+
+            if (name == "position-x")
+            {
+                posX = readParticleEmitterProp(propertyNode, 0.0f);
+            }
+            else if (name == "position-y")
+            {
+                posY = readParticleEmitterProp(propertyNode, 0.0f);
+                scale(posY, SIN45);
+            }
+            else if (name == "position-z")
+            {
+                posZ = readParticleEmitterProp(propertyNode, 0.0f);
+                scale(posZ, SIN45);
+            }
+            else if (name == "image")
+            {
+                std::string imagePath = propertyNode.getProperty("value", "");
+                if (!imagePath.empty() && !image)
+                    image = loadImage(imagePath, dyePalettes);
+            }
+            else if (name == "horizontal-angle")
+            {
+                angleHorizontal = readParticleEmitterProp(propertyNode, 0.0f);
+                scale(angleHorizontal, DEG_RAD_FACTOR);
+                rotatable = true;
+            }
+            else if (name == "vertical-angle")
+            {
+                angleVertical = readParticleEmitterProp(propertyNode, 0.0f);
+                scale(angleVertical, DEG_RAD_FACTOR);
+            }
+            else if (name == "power")
+            {
+                power = readParticleEmitterProp(propertyNode, 0.0f);
+            }
+            else if (name == "gravity")
+            {
+                gravity = readParticleEmitterProp(propertyNode, 0.0f);
+            }
+            else if (name == "randomnes" || name == "randomness") // legacy bug
+            {
+                randomness = readParticleEmitterProp(propertyNode, 0);
+            }
+            else if (name == "bounce")
+            {
+                bounce = readParticleEmitterProp(propertyNode, 0.0f);
+            }
+            else if (name == "lifetime")
+            {
+                lifetime = readParticleEmitterProp(propertyNode, 0);
+                lifetime.minVal += 1;
+            }
+            else if (name == "output")
+            {
+                output = readParticleEmitterProp(propertyNode, 0);
+                output.maxVal +=1;
+            }
+            else if (name == "output-pause")
+            {
+                outputPause = readParticleEmitterProp(propertyNode, 0);
+            }
+            else if (name == "acceleration")
+            {
+                acceleration = readParticleEmitterProp(propertyNode, 0.0f);
+            }
+            else if (name == "die-distance")
+            {
+                dieDistance = readParticleEmitterProp(propertyNode, 0.0f);
+            }
+            else if (name == "momentum")
+            {
+                momentum = readParticleEmitterProp(propertyNode, 1.0f);
+            }
+            else if (name == "fade-out")
+            {
+                fadeOut = readParticleEmitterProp(propertyNode, 0);
+            }
+            else if (name == "fade-in")
+            {
+                fadeIn = readParticleEmitterProp(propertyNode, 0);
+            }
+            else if (name == "alpha")
+            {
+                alpha = readParticleEmitterProp(propertyNode, 1.0f);
+            }
+            else if (name == "follow-parent")
+            {
+                follow = propertyNode.getBoolProperty("value", true);
+            }
+            else
+            {
+                Log::info("Particle Engine: Warning, unknown emitter property \"%s\"",
+                          name.c_str());
+            }
+        }
+        else if (propertyNode.name() == "emitter")
+        {
+            childEmitters.emplace_back().load(propertyNode, dyePalettes);
+        }
+        else if (propertyNode.name() == "rotation")
+        {
+            rotation = Animation::fromXML(propertyNode);
+        }
+        else if (propertyNode.name() == "animation")
+        {
+            animation = Animation::fromXML(propertyNode);
+        }
+        else if (propertyNode.name() == "deatheffect")
+        {
+            deathEffect = readDeathEffect(propertyNode);
+        }
+    }
+}
+
+ParticleEffectDef *ParticleEffectDef::load(const std::string &effectFile)
+{
+    std::string::size_type pos = effectFile.find('|');
+    std::string dyePalettes;
+    if (pos != std::string::npos)
+        dyePalettes = effectFile.substr(pos + 1);
+
+    XML::Document doc(effectFile.substr(0, pos));
+    XML::Node rootNode = doc.rootNode();
+
+    if (!rootNode || rootNode.name() != "effect")
+        return nullptr;
+
+    auto *def = new ParticleEffectDef;
+
+    for (auto effectChildNode : rootNode.children())
+    {
+        // We're only interested in particles
+        if (effectChildNode.name() != "particle")
+            continue;
+
+        ParticleDef &particle = def->mParticles.emplace_back();
+
+        // Determine the exact particle type
+        XML::Node node;
+
+        if ((node = effectChildNode.findFirstChildByName("animation")))
+        {
+            particle.type = ParticleType::Animation;
+            particle.animation = Animation::fromXML(node, dyePalettes);
+        }
+        else if ((node = effectChildNode.findFirstChildByName("rotation")))
+        {
+            particle.type = ParticleType::Rotational;
+            particle.animation = Animation::fromXML(node, dyePalettes);
+        }
+        else if ((node = effectChildNode.findFirstChildByName("image")))
+        {
+            particle.type = ParticleType::Image;
+            particle.image = loadImage(std::string(node.textContent()), dyePalettes);
+        }
+
+        particle.offsetX = effectChildNode.getFloatProperty("position-x", 0);
+        particle.offsetY = effectChildNode.getFloatProperty("position-y", 0);
+        particle.offsetZ = effectChildNode.getFloatProperty("position-z", 0);
+        particle.lifetime = effectChildNode.getProperty("lifetime", -1);
+        particle.sizeAdjustable =
+                "false" != effectChildNode.getProperty("size-adjustable", "false");
+
+        // Look for additional emitters for this particle
+        for (auto emitterNode : effectChildNode.children())
+        {
+            if (emitterNode.name() == "emitter")
+                particle.emitters.emplace_back().load(emitterNode, dyePalettes);
+            else if (emitterNode.name() == "deatheffect")
+                particle.deathEffect = readDeathEffect(emitterNode);
+        }
+    }
+
+    return def;
+}
@@ -0,0 +1,135 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "particleemitterprop.h"
+
+#include "resources/animation.h"
+#include "resources/resource.h"
+
+#include "utils/xml.h"
+
+#include <string>
+#include <vector>
+
+class Image;
+
+/**
+ * An effect spawned when a particle dies in one of the given ways.
+ */
+struct ParticleDeathEffect
+{
+    std::string effect;
+    unsigned char conditions = 0;   /**< Bitfield of Particle::AliveStatus */
+};
+
+/**
+ * The parameters of a particle emitter, as read from an effect file.
+ */
+struct ParticleEmitterDef
+{
+    void load(XML::Node emitterNode, const std::string &dyePalettes);
+
+    ParticleEmitterProp<float> posX, posY, posZ;
+
+    /** In radians, without the rotation of the effect applied. */
+    ParticleEmitterProp<float> angleHorizontal, angleVertical;
+
+    /** Whether the horizontal angle follows the rotation of the effect. */
+    bool rotatable = false;
+
+    ParticleEmitterProp<float> power;
+    ParticleEmitterProp<float> gravity;
+    ParticleEmitterProp<int> randomness;
+    ParticleEmitterProp<float> bounce;
+    bool follow = false;
+
+    ParticleEmitterProp<float> acceleration;
+    ParticleEmitterProp<float> dieDistance { -1.0f };
+    ParticleEmitterProp<float> momentum { 1.0f };
+
+    ParticleEmitterProp<int> lifetime { -1 };
+    ParticleEmitterProp<int> fadeOut;
+    ParticleEmitterProp<int> fadeIn;
+
+    ParticleEmitterProp<int> output { 1 };
+    ParticleEmitterProp<int> outputPause;
+
+    ResourceRef<Image> image;
+    Animation animation;
+    Animation rotation;
+    ParticleEmitterProp<float> alpha { 1.0f };
+
+    ParticleDeathEffect deathEffect;
+
+    std::vector<ParticleEmitterDef> childEmitters;
+};
+
+enum class ParticleType
+{
+    Plain,
+    Image,
+    Animation,
+    Rotational
+};
+
+/**
+ * A particle of an effect, as read from an effect file.
+ */
+struct ParticleDef
+{
+    ParticleType type = ParticleType::Plain;
+    ResourceRef<Image> image;
+    Animation animation;
+
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    float offsetZ = 0.0f;
+    int lifetime = -1;
+    bool sizeAdjustable = false;
+
+    std::vector<ParticleEmitterDef> emitters;
+    ParticleDeathEffect deathEffect;
+};
+
+/**
+ * A particle effect file, parsed once with its images loaded and dyed, so
+ * that spawning the effect does not need to touch the XML again.
+ *
+ * @see Particle::addEffect
+ */
+class ParticleEffectDef : public Resource
+{
+    public:
+        /**
+         * Loads a particle effect file. Dye palettes can be appended to the
+         * path, separated by a '|'.
+         */
+        static ParticleEffectDef *load(const std::string &effectFile);
+
+        const std::vector<ParticleDef> &getParticles() const
+        { return mParticles; }
+
+    private:
+        ParticleEffectDef() = default;
+
+        std::vector<ParticleDef> mParticles;
+};
@@ -21,7 +21,8 @@
 
 #pragma once
 
-#include <ctime>
+#include <cstddef>
+#include <list>
 #include <string>
 
 template<typename T> class ResourceRef;
@@ -43,6 +44,12 @@ class Resource
         const std::string &getIdPath() const
         { return mIdPath; }
 
+        /**
+         * Returns an estimate of the memory in bytes held by this resource,
+         * including GPU memory.
+         */
+        virtual size_t getMemorySize() const { return 0; }
+
     protected:
         virtual ~Resource() = default;
 
@@ -59,8 +66,11 @@ class Resource
                            OrphanPolicy orphanPolicy = DeleteLater);
 
         std::string mIdPath;    /**< Path identifying this resource. */
-        time_t mTimeStamp = 0;  /**< Time at which the resource was orphaned. */
         unsigned mRefCount = 0; /**< Reference count. */
+        size_t mMemorySize = 0; /**< Memory size accounted for this resource. */
+
+        /** Position in the orphaned resources, when orphaned. */
+        std::list<Resource *>::iterator mOrphanPos;
 };
 
 /**
@@ -22,20 +22,26 @@
 #include "resources/resourcemanager.h"
 
 #include "client.h"
+#include "configuration.h"
+#include "game.h"
 #include "log.h"
 
 #include "resources/dye.h"
 #include "resources/image.h"
 #include "resources/imageset.h"
 #include "resources/music.h"
+#include "resources/particleeffectdef.h"
 #include "resources/soundeffect.h"
 #include "resources/spritedef.h"
 
 #include "utils/filesystem.h"
+#include "utils/mutex.h"
 
 #include <SDL_image.h>
 
+#include <algorithm>
 #include <cassert>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -43,6 +49,30 @@
 
 ResourceManager *ResourceManager::instance = nullptr;
 
+/**
+ * Memory accounted for each resource in addition to its own estimate, so that
+ * resources without a known size still count towards the budget.
+ */
+static constexpr size_t RESOURCE_OVERHEAD = 1024;
+
+/**
+ * Images decoded by prefetchImage, which may run on other threads.
+ */
+static Mutex prefetchMutex;
+static std::map<std::string, SDL_Surface *> prefetchedImages;
+
+static SDL_Surface *takePrefetchedImage(const std::string &path)
+{
+    MutexLocker lock(&prefetchMutex);
+    auto it = prefetchedImages.find(path);
+    if (it == prefetchedImages.end())
+        return nullptr;
+
+    SDL_Surface *surface = it->second;
+    prefetchedImages.erase(it);
+    return surface;
+}
+
 ResourceManager::ResourceManager()
 {
     Log::info("Initializing resource manager...");
@@ -50,6 +80,11 @@ ResourceManager::ResourceManager()
 
 ResourceManager::~ResourceManager()
 {
+    // Resources are deleted below regardless of the budget
+    mEvicting = true;
+
+    clearPrefetchedImages();
+
     // Deleting a resource orphans the resources it references, so keep
     // deleting unreferenced resources until none are left (SpriteDef
     // references ImageSet, which references Image).
@@ -59,6 +94,7 @@ ResourceManager::~ResourceManager()
         do
         {
             mResources.merge(mOrphanedResources);
+            mOrphanOrder.clear();
 
             // Collect the unreferenced resources first, since deleting a
             // resource may release or remove other resources from the map,
@@ -115,42 +151,33 @@ void ResourceManager::cleanUp(Resource *res)
     delete res;
 }
 
-void ResourceManager::cleanOrphans()
+void ResourceManager::evictOrphans()
 {
-    // Delete orphaned resources after 30 seconds.
-    time_t oldest = time(nullptr);
-    const time_t threshold = oldest - 30;
-
-    if (mOrphanedResources.empty() || mOldestOrphan >= threshold)
+    // Deleting a resource may release the resources it references. These
+    // are handled by the loop that is already running.
+    if (mEvicting)
         return;
 
-    // Collect the expired orphans first, since deleting a resource may orphan
-    // the resources it references, which would invalidate the iterator.
-    std::vector<Resource *> expired;
-    for (auto iter = mOrphanedResources.begin(); iter != mOrphanedResources.end(); )
-    {
-        Resource *res = iter->second;
-        const time_t t = res->mTimeStamp;
-        if (t >= threshold)
-        {
-            if (t < oldest)
-                oldest = t;
-            ++iter;
-        }
-        else
-        {
-            expired.push_back(res);
-            iter = mOrphanedResources.erase(iter);
-        }
-    }
+    mEvicting = true;
+
+    const size_t budget =
+            static_cast<size_t>(std::max(config.resourceCacheSize, 0)) * 1024 * 1024;
 
-    for (Resource *res : expired)
+    while (mStats.orphanedBytes > budget && !mOrphanOrder.empty())
     {
+        Resource *res = mOrphanOrder.front();
+        mOrphanOrder.pop_front();
+        mOrphanedResources.erase(res->mIdPath);
+
+        mStats.orphanedBytes -= res->mMemorySize;
+        mStats.residentBytes -= res->mMemorySize;
+        ++mStats.evictions;
+
         Log::info("Deleting orphaned resource: %s", res->mIdPath.c_str());
         delete res;
     }
 
-    mOldestOrphan = oldest;
+    mEvicting = false;
 }
 
 bool ResourceManager::addToSearchPath(const std::string &path, bool append)
@@ -186,6 +213,36 @@ void ResourceManager::searchAndAddArchives(const std::string &path,
     }
 }
 
+void ResourceManager::prefetchImage(const std::string &path)
+{
+    {
+        MutexLocker lock(&prefetchMutex);
+        if (prefetchedImages.count(path))
+            return;
+    }
+
+    SDL_RWops *rw = FS::openRWops(path);
+    if (!rw)
+        return;
+
+    SDL_Surface *surface = IMG_Load_RW(rw, 1);
+    if (!surface)
+        return;
+
+    MutexLocker lock(&prefetchMutex);
+    auto [it, inserted] = prefetchedImages.try_emplace(path, surface);
+    if (!inserted)
+        SDL_FreeSurface(surface);
+}
+
+void ResourceManager::clearPrefetchedImages()
+{
+    MutexLocker lock(&prefetchMutex);
+    for (auto &[_, surface] : prefetchedImages)
+        SDL_FreeSurface(surface);
+    prefetchedImages.clear();
+}
+
 std::string ResourceManager::getPath(const std::string &file)
 {
     // Get the real directory of the file
@@ -218,6 +275,8 @@ Resource *ResourceManager::find(const std::string &idPath)
     if (resIter != mOrphanedResources.end())
     {
         Resource *res = resIter->second;
+        mOrphanOrder.erase(res->mOrphanPos);
+        mStats.orphanedBytes -= res->mMemorySize;
         mResources.insert(mOrphanedResources.extract(resIter));
         return res;
     }
@@ -230,8 +289,9 @@ Resource *ResourceManager::insert(const std::string &idPath, Resource *resource)
     if (resource)
     {
         resource->mIdPath = idPath;
+        resource->mMemorySize = resource->getMemorySize() + RESOURCE_OVERHEAD;
         mResources[idPath] = resource;
-        cleanOrphans();
+        mStats.residentBytes += resource->mMemorySize;
     }
 
     return resource;
@@ -257,6 +317,21 @@ ResourceRef<SoundEffect> ResourceManager::getSoundEffect(const std::string &path
     }));
 }
 
+ResourceRef<SoundEffect> ResourceManager::addSoundEffect(const std::string &path,
+                                                         SoundEffect *soundEffect)
+{
+    bool added = false;
+    ResourceRef<SoundEffect> result = static_cast<SoundEffect*>(get(path, [&] () -> Resource * {
+        added = true;
+        return soundEffect;
+    }));
+
+    if (!added)
+        delete soundEffect;
+
+    return result;
+}
+
 ResourceRef<Image> ResourceManager::getImage(const std::string &idPath)
 {
     return static_cast<Image*>(get(idPath, [&] () -> Resource * {
@@ -268,6 +343,13 @@ ResourceRef<Image> ResourceManager::getImage(const std::string &idPath)
             d = std::make_unique<Dye>(path.substr(p + 1));
             path = path.substr(0, p);
         }
+        else if (SDL_Surface *surface = takePrefetchedImage(path))
+        {
+            Image *image = Image::load(surface);
+            SDL_FreeSurface(surface);
+            return image;
+        }
+
         SDL_RWops *rw = FS::openRWops(path);
         if (!rw)
             return nullptr;
@@ -302,6 +384,22 @@ ResourceRef<SpriteDef> ResourceManager::getSprite(const std::string &path, int v
     }));
 }
 
+ResourceRef<ParticleEffectDef> ResourceManager::getParticleEffect(const std::string &path)
+{
+    std::string idPath = path;
+
+    // Animation frame offsets depend on the tile size of the current map
+    if (Game *game = Game::instance())
+    {
+        idPath += "[" + std::to_string(game->getCurrentTileWidth()) + "x" +
+                std::to_string(game->getCurrentTileHeight()) + "]";
+    }
+
+    return static_cast<ParticleEffectDef*>(get(idPath, [&] () -> Resource * {
+        return ParticleEffectDef::load(path);
+    }));
+}
+
 void ResourceManager::release(Resource *res)
 {
     auto resIter = mResources.find(res->mIdPath);
@@ -309,18 +407,17 @@ void ResourceManager::release(Resource *res)
     // The resource has to exist
     assert(resIter != mResources.end() && resIter->second == res);
 
-    const time_t timestamp = time(nullptr);
-
-    res->mTimeStamp = timestamp;
-    if (mOrphanedResources.empty())
-        mOldestOrphan = timestamp;
-
     mOrphanedResources.insert(mResources.extract(resIter));
+    res->mOrphanPos = mOrphanOrder.insert(mOrphanOrder.end(), res);
+    mStats.orphanedBytes += res->mMemorySize;
+
+    evictOrphans();
 }
 
 void ResourceManager::remove(Resource *res)
 {
-    mResources.erase(res->mIdPath);
+    if (mResources.erase(res->mIdPath))
+        mStats.residentBytes -= res->mMemorySize;
 }
 
 ResourceManager *ResourceManager::getInstance()
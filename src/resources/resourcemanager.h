@@ -23,24 +23,38 @@
 
 #include "resources/resource.h"
 
-#include <ctime>
+#include <list>
 #include <string>
 #include <unordered_map>
 
 class Image;
 class ImageSet;
 class Music;
+class ParticleEffectDef;
 class SoundEffect;
 class SpriteDef;
 
 /**
  * A class for loading and managing resources.
+ *
+ * Resources that are no longer referenced are kept around, so that they can
+ * be reused quickly. When the memory used by these orphaned resources exceeds
+ * the configured budget, the least recently released ones are deleted.
  */
 class ResourceManager
 {
     friend class Resource;
 
     public:
+        struct Stats
+        {
+            unsigned hits = 0;          /**< Requests for loaded resources */
+            unsigned misses = 0;        /**< Requests that needed loading */
+            unsigned evictions = 0;     /**< Orphans deleted for the budget */
+            size_t residentBytes = 0;   /**< Memory of all loaded resources */
+            size_t orphanedBytes = 0;   /**< Memory of unreferenced resources */
+        };
+
         ResourceManager();
 
         /**
@@ -74,6 +88,17 @@ class ResourceManager
          */
         static std::string getPath(const std::string &file);
 
+        /**
+         * Decodes the image at the given path ahead of time, so that loading
+         * it later only needs to upload it. Can be called from any thread.
+         */
+        static void prefetchImage(const std::string &path);
+
+        /**
+         * Frees the prefetched images that have not been loaded.
+         */
+        static void clearPrefetchedImages();
+
         /**
          * Loads the Image resource found at the given identifier path. The
          * path can include a dye specification after a '|' character.
@@ -90,6 +115,14 @@ class ResourceManager
          */
         ResourceRef<SoundEffect> getSoundEffect(const std::string &path);
 
+        /**
+         * Adds a SoundEffect that was loaded in advance. When the sound
+         * effect at the given path has been loaded in the meantime, the
+         * given one is deleted and the existing one is returned.
+         */
+        ResourceRef<SoundEffect> addSoundEffect(const std::string &path,
+                                                SoundEffect *soundEffect);
+
         /**
          * Loads a image set based on the image referenced by the given path
          * and the supplied sprite sizes.
@@ -101,6 +134,17 @@ class ResourceManager
          */
         ResourceRef<SpriteDef> getSprite(const std::string &path, int variant = 0);
 
+        /**
+         * Loads a particle effect definition. The path can include dye
+         * palettes after a '|' character.
+         */
+        ResourceRef<ParticleEffectDef> getParticleEffect(const std::string &path);
+
+        /**
+         * Returns the resource usage statistics.
+         */
+        const Stats &getStats() const { return mStats; }
+
         /**
          * Returns an instance of the class, creating one if it does not
          * already exist.
@@ -127,7 +171,11 @@ class ResourceManager
         Resource *get(const std::string &idPath, Generator &&generator)
         {
             if (Resource *resource = find(idPath))
+            {
+                ++mStats.hits;
                 return resource;
+            }
+            ++mStats.misses;
             return insert(idPath, generator());
         }
 
@@ -161,10 +209,19 @@ class ResourceManager
          */
         static void cleanUp(Resource *resource);
 
-        void cleanOrphans();
+        /**
+         * Deletes the least recently released orphans until their memory
+         * fits within the configured budget.
+         */
+        void evictOrphans();
 
         static ResourceManager *instance;
         std::unordered_map<std::string, Resource *> mResources;
         std::unordered_map<std::string, Resource *> mOrphanedResources;
-        time_t mOldestOrphan = 0;
+
+        /** Orphaned resources, least recently released first */
+        std::list<Resource *> mOrphanOrder;
+
+        Stats mStats;
+        bool mEvicting = false;
 };
@@ -55,6 +55,13 @@ class SoundEffect : public Resource
          */
         int play(int loops, int volume, int channel = -1);
 
+        /**
+         * Returns the size of the decoded sample in bytes.
+         */
+        unsigned getSize() const { return mChunk->alen; }
+
+        size_t getMemorySize() const override { return getSize(); }
+
     protected:
         SoundEffect(Mix_Chunk *soundEffect): mChunk(soundEffect) {}
 
@@ -31,13 +31,72 @@
 
 #include "configuration.h"
 
+#include "utils/mutex.h"
 #include "utils/xml.h"
 
 #include <algorithm>
+#include <deque>
 #include <set>
+#include <unordered_map>
 
 static std::set<std::string> processedFiles;
 
+namespace SpriteAction {
+
+struct ActionRegistry
+{
+    ActionRegistry()
+    {
+        // Registered in the order of the predefined identifiers
+        for (const std::string &name : { STAND, SIT, SLEEP, DEAD, MOVE,
+                                         ATTACK, HURT, USE_ABILITY,
+                                         CAST_MAGIC, USE_ITEM })
+        {
+            ids.emplace(name, static_cast<ActionId>(names.size()));
+            names.push_back(name);
+        }
+    }
+
+    Mutex mutex;
+    std::deque<std::string> names;  // deque keeps references stable
+    std::unordered_map<std::string, ActionId> ids;
+};
+
+static ActionRegistry &registry()
+{
+    static ActionRegistry instance;
+    return instance;
+}
+
+ActionId getId(const std::string &action)
+{
+    if (action.empty())
+        return INVALID_ID;
+
+    ActionRegistry &r = registry();
+    MutexLocker lock(&r.mutex);
+
+    auto [it, inserted] = r.ids.emplace(action,
+                                        static_cast<ActionId>(r.names.size()));
+    if (inserted)
+        r.names.push_back(action);
+
+    return it->second;
+}
+
+const std::string &getName(ActionId id)
+{
+    ActionRegistry &r = registry();
+    MutexLocker lock(&r.mutex);
+
+    if (id < 0 || id >= static_cast<ActionId>(r.names.size()))
+        return INVALID;
+
+    return r.names[id];
+}
+
+} // namespace SpriteAction
+
 
 Action::~Action() = default;
 
@@ -78,17 +137,15 @@ static SpriteDirection makeSpriteDirection(const std::string &direction)
     return DIRECTION_INVALID;
 }
 
-Action *SpriteDef::getAction(const std::string &action) const
+Action *SpriteDef::getAction(ActionId action) const
 {
-    auto i = mActions.find(action);
-
-    if (i == mActions.end())
-    {
-        Log::warn("No action \"%s\" defined!", action.c_str());
-        return nullptr;
-    }
+    if (action >= 0 && action < static_cast<ActionId>(mActions.size()))
+        if (Action *a = mActions[action])
+            return a;
 
-    return i->second;
+    Log::warn("No action \"%s\" defined!",
+              SpriteAction::getName(action).c_str());
+    return nullptr;
 }
 
 SpriteDef *SpriteDef::load(const std::string &animationFile, int variant)
@@ -125,16 +182,23 @@ SpriteDef *SpriteDef::load(const std::string &animationFile, int variant)
     return def;
 }
 
-void SpriteDef::substituteAction(const std::string &complete, const std::string &with)
+void SpriteDef::substituteAction(ActionId complete, ActionId with)
 {
-    if (mActions.find(complete) == mActions.end())
-    {
-        auto i = mActions.find(with);
-        if (i != mActions.end())
-        {
-            mActions[complete] = i->second;
-        }
-    }
+    const auto size = static_cast<ActionId>(mActions.size());
+
+    if (complete < size && mActions[complete])
+        return;
+
+    if (with < size && mActions[with])
+        setAction(complete, mActions[with]);
+}
+
+void SpriteDef::setAction(ActionId id, Action *action)
+{
+    if (id >= static_cast<ActionId>(mActions.size()))
+        mActions.resize(id + 1);
+
+    mActions[id] = action;
 }
 
 void SpriteDef::updateMinOffsetY()
@@ -143,7 +207,7 @@ void SpriteDef::updateMinOffsetY()
 
     // Only consider the stand action, since other actions (like attack) may
     // temporarily move the sprite far away from its resting position.
-    const Action *action = getAction(SpriteAction::STAND);
+    const Action *action = getAction(SpriteAction::STAND_ID);
     if (!action)
         return;
 
@@ -165,15 +229,15 @@ void SpriteDef::updateMinOffsetY()
 
 void SpriteDef::substituteActions()
 {
-    substituteAction(SpriteAction::STAND, SpriteAction::DEFAULT);
-    substituteAction(SpriteAction::MOVE, SpriteAction::STAND);
-    substituteAction(SpriteAction::ATTACK, SpriteAction::STAND);
-    substituteAction(SpriteAction::CAST_MAGIC, SpriteAction::ATTACK);
-    substituteAction(SpriteAction::USE_ITEM, SpriteAction::CAST_MAGIC);
-    substituteAction(SpriteAction::SIT, SpriteAction::STAND);
-    substituteAction(SpriteAction::SLEEP, SpriteAction::SIT);
-    substituteAction(SpriteAction::HURT, SpriteAction::STAND);
-    substituteAction(SpriteAction::DEAD, SpriteAction::HURT);
+    substituteAction(SpriteAction::STAND_ID, SpriteAction::DEFAULT_ID);
+    substituteAction(SpriteAction::MOVE_ID, SpriteAction::STAND_ID);
+    substituteAction(SpriteAction::ATTACK_ID, SpriteAction::STAND_ID);
+    substituteAction(SpriteAction::CAST_MAGIC_ID, SpriteAction::ATTACK_ID);
+    substituteAction(SpriteAction::USE_ITEM_ID, SpriteAction::CAST_MAGIC_ID);
+    substituteAction(SpriteAction::SIT_ID, SpriteAction::STAND_ID);
+    substituteAction(SpriteAction::SLEEP_ID, SpriteAction::SIT_ID);
+    substituteAction(SpriteAction::HURT_ID, SpriteAction::STAND_ID);
+    substituteAction(SpriteAction::DEAD_ID, SpriteAction::HURT_ID);
 }
 
 void SpriteDef::loadSprite(XML::Node spriteNode, int variant,
@@ -247,20 +311,23 @@ void SpriteDef::loadAction(XML::Node node, int variant_offset)
     }
     ImageSet *imageSet = si->second;
 
-    if (actionName == SpriteAction::INVALID)
+    const ActionId actionId = SpriteAction::getId(actionName);
+    if (actionId == SpriteAction::INVALID_ID)
     {
         Log::warn("Unknown action \"%s\" defined in %s",
                   actionName.c_str(), getIdPath().c_str());
         return;
     }
-    auto *action = new Action;
-    mActions[actionName] = action;
 
     // When first action set it as default direction
-    if (mActions.size() == 1)
-    {
-        mActions[SpriteAction::DEFAULT] = action;
-    }
+    const bool first = std::none_of(mActions.begin(), mActions.end(),
+                                    [](Action *a) { return a != nullptr; });
+
+    auto *action = new Action;
+    setAction(actionId, action);
+
+    if (first)
+        setAction(SpriteAction::DEFAULT_ID, action);
 
     // Load animations
     for (auto animationNode : node.children())
@@ -384,8 +451,9 @@ SpriteDef::~SpriteDef()
 {
     // Actions are shared, so ensure they are deleted only once.
     std::set<Action*> actions;
-    for (const auto &[_, action] : mActions)
-        actions.insert(action);
+    for (auto action : mActions)
+        if (action)
+            actions.insert(action);
 
     for (auto action : actions)
         delete action;
@@ -32,6 +32,8 @@
 class Animation;
 class ImageSet;
 
+using ActionId = int;
+
 struct SpriteReference
 {
     std::string sprite;
@@ -68,6 +70,39 @@ namespace SpriteAction
     static const std::string CAST_MAGIC = "magic";
     static const std::string USE_ITEM = "item";
     static const std::string INVALID;
+
+    /**
+     * Identifiers of the main actions above. Action names are interned to
+     * small integers, so that playing an action does not involve looking up
+     * strings. Other action names get an identifier when first seen.
+     */
+    enum : ActionId
+    {
+        INVALID_ID = -1,
+        STAND_ID,
+        SIT_ID,
+        SLEEP_ID,
+        DEAD_ID,
+        MOVE_ID,
+        ATTACK_ID,
+        HURT_ID,
+        USE_ABILITY_ID,
+        CAST_MAGIC_ID,
+        USE_ITEM_ID,
+
+        DEFAULT_ID = STAND_ID
+    };
+
+    /**
+     * Returns the identifier of the given action name, registering it when
+     * it was not seen before. An empty name maps to INVALID_ID.
+     */
+    ActionId getId(const std::string &action);
+
+    /**
+     * Returns the name of the given action identifier.
+     */
+    const std::string &getName(ActionId id);
 }
 
 enum SpriteDirection
@@ -113,7 +148,9 @@ class SpriteDef : public Resource
         /**
          * Returns the specified action.
          */
-        Action *getAction(const std::string &action) const;
+        Action *getAction(ActionId action) const;
+        Action *getAction(const std::string &action) const
+        { return getAction(SpriteAction::getId(action)); }
 
         /**
          * Returns the smallest vertical offset used by any frame of the
@@ -169,9 +206,15 @@ class SpriteDef : public Resource
          * When there are no animations defined for the action "complete", its
          * animations become a copy of those of the action "with".
          */
-        void substituteAction(const std::string &complete, const std::string &with);
+        void substituteAction(ActionId complete, ActionId with);
+
+        /**
+         * Sets the action for the given identifier, growing the action table
+         * as needed.
+         */
+        void setAction(ActionId id, Action *action);
 
         std::map<std::string, ResourceRef<ImageSet>> mImageSets;
-        std::map<std::string, Action *> mActions;
+        std::vector<Action *> mActions;     /**< Indexed by ActionId */
         int mMinOffsetY = 0;
 };
@@ -32,11 +32,13 @@
 #include "resources/resourcemanager.h"
 
 #include "utils/filesystem.h"
+#include "utils/stringutils.h"
 
 #include <guichan/font.hpp>
 #include <guichan/widget.hpp>
 
 #include <algorithm>
+#include <set>
 
 /**
  * Initializes the directory in which the client looks for GUI themes, which at
@@ -117,6 +119,9 @@ Skin::~Skin()
 void Skin::addState(SkinState state)
 {
     mStates.emplace_back(std::move(state));
+
+    // The cached geometry refers to the parts of the states
+    mGeometryCache.clear();
 }
 
 void Skin::draw(Graphics *graphics, const WidgetState &state) const
@@ -126,44 +131,97 @@ void Skin::draw(Graphics *graphics, const WidgetState &state) const
     if (!skinState)
         return;
 
-    for (const auto &part : skinState->parts)
+    const Geometry &geometry = getGeometry(*skinState, state.width, state.height);
+
+    for (const auto &batch : geometry.batches)
+    {
+        if (batch.image)
+        {
+            graphics->drawImageQuads(batch.image,
+                                     geometry.quads.data() + batch.firstQuad,
+                                     batch.quadCount,
+                                     state.x, state.y);
+            continue;
+        }
+
+        const auto &part = *batch.part;
+        const auto &data = std::get<ColoredRectangle>(part.data);
+        const auto color = graphics->getColor();
+        // TODO: Take GUI alpha into account
+        if (!data.useCurrentColor)
+            graphics->setColor(data.color);
+
+        const gcn::Rectangle rect(state.x + part.offsetX,
+                                  state.y + part.offsetY,
+                                  state.width,
+                                  state.height);
+
+        if (data.filled)
+            graphics->fillRectangle(rect);
+        else
+            graphics->drawRectangle(rect);
+
+        graphics->setColor(color);
+    }
+}
+
+const Skin::Geometry &Skin::getGeometry(const SkinState &skinState,
+                                        int width, int height) const
+{
+    constexpr size_t MAX_CACHED_GEOMETRIES = 256;
+
+    const auto stateIndex = static_cast<uint64_t>(&skinState - mStates.data());
+    const uint64_t key = stateIndex << 48 |
+            static_cast<uint64_t>(width & 0xFFFFFF) << 24 |
+            static_cast<uint64_t>(height & 0xFFFFFF);
+
+    auto it = mGeometryCache.find(key);
+    if (it != mGeometryCache.end())
+        return it->second;
+
+    if (mGeometryCache.size() >= MAX_CACHED_GEOMETRIES)
+        mGeometryCache.clear();
+
+    Geometry &geometry = mGeometryCache[key];
+
+    for (const auto &part : skinState.parts)
     {
-        std::visit([&](const auto &data) {
-            using T = std::decay_t<decltype(data)>;
-
-            if constexpr (std::is_same_v<T, ImageRect>)
-            {
-                graphics->drawImageRect(data,
-                                        state.x + part.offsetX,
-                                        state.y + part.offsetY,
-                                        state.width,
-                                        state.height);
-            }
-            else if constexpr (std::is_same_v<T, Image*>)
-            {
-                graphics->drawImage(data, state.x + part.offsetX, state.y + part.offsetY);
-            }
-            else if constexpr (std::is_same_v<T, ColoredRectangle>)
-            {
-                const auto color = graphics->getColor();
-                // TODO: Take GUI alpha into account
-                if (!data.useCurrentColor)
-                    graphics->setColor(data.color);
-
-                const gcn::Rectangle rect(state.x + part.offsetX,
-                                          state.y + part.offsetY,
-                                          state.width,
-                                          state.height);
-
-                if (data.filled)
-                    graphics->fillRectangle(rect);
-                else
-                    graphics->drawRectangle(rect);
-
-                graphics->setColor(color);
-            }
-        }, part.data);
+        const size_t firstQuad = geometry.quads.size();
+        const Image *image = nullptr;
+
+        if (auto imageRect = std::get_if<ImageRect>(&part.data))
+        {
+            image = imageRect->image.get();
+            imageRect->appendQuads(geometry.quads,
+                                   part.offsetX, part.offsetY,
+                                   width, height);
+        }
+        else if (auto img = std::get_if<Image *>(&part.data))
+        {
+            image = *img;
+            geometry.quads.push_back({ 0, 0,
+                                       image->getWidth(), image->getHeight(),
+                                       part.offsetX, part.offsetY,
+                                       image->getWidth(), image->getHeight() });
+        }
+        else
+        {
+            geometry.batches.push_back({ nullptr, &part, 0, 0 });
+            continue;
+        }
+
+        const size_t quadCount = geometry.quads.size() - firstQuad;
+        if (quadCount == 0)
+            continue;
+
+        // Consecutive parts using the same image are drawn together
+        if (!geometry.batches.empty() && geometry.batches.back().image == image)
+            geometry.batches.back().quadCount += quadCount;
+        else
+            geometry.batches.push_back({ image, &part, firstQuad, quadCount });
     }
+
+    return geometry;
 }
 
 const SkinState *Skin::getState(uint8_t flags) const
@@ -282,6 +340,26 @@ std::vector<ThemeInfo> Theme::getAvailableThemes()
     return themes;
 }
 
+void Theme::prefetchImages(const ThemeInfo &themeInfo)
+{
+    const std::string themePath = themeInfo.getFullPath();
+
+    std::set<std::string> files;
+    for (const std::string &dir : { themePath, defaultThemePath })
+        for (auto file : FS::enumerateFiles(dir))
+            if (endsWith(file, ".png"))
+                files.insert(file);
+
+    // Use the same paths as resolvePath, so the images are found later
+    for (const std::string &file : files)
+    {
+        if (FS::exists(themePath + "/" + file))
+            ResourceManager::prefetchImage(themePath + "/" + file);
+        else
+            ResourceManager::prefetchImage(defaultThemePath + "/" + file);
+    }
+}
+
 std::string Theme::resolvePath(const std::string &path) const
 {
     // Need to strip off any dye info for the existence tests
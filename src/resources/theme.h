@@ -35,6 +35,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 
 namespace gcn {
@@ -192,7 +193,38 @@ class Skin
         bool showButtons = true;
 
     private:
+        /**
+         * A range of quads drawn with the same image, or a colored rectangle
+         * part when there is no image.
+         */
+        struct GeometryBatch
+        {
+            const Image *image = nullptr;
+            const SkinPart *part = nullptr;
+            size_t firstQuad = 0;
+            size_t quadCount = 0;
+        };
+
+        /**
+         * The precomputed quads for drawing a skin state at a certain size,
+         * relative to the position of the widget.
+         */
+        struct Geometry
+        {
+            std::vector<ImageQuad> quads;
+            std::vector<GeometryBatch> batches;
+        };
+
+        const Geometry &getGeometry(const SkinState &skinState,
+                                    int width, int height) const;
+
         std::vector<SkinState> mStates;
+
+        /**
+         * Geometry by state index and size. Cleared when it grows too large,
+         * since resizing a window passes through many sizes.
+         */
+        mutable std::unordered_map<uint64_t, Geometry> mGeometryCache;
 };
 
 class Theme : public EventListener
@@ -201,6 +233,12 @@ class Theme : public EventListener
         static std::string prepareThemePath();
         static std::vector<ThemeInfo> getAvailableThemes();
 
+        /**
+         * Decodes the images of the given theme ahead of time, see
+         * ResourceManager::prefetchImage. Can be called from any thread.
+         */
+        static void prefetchImages(const ThemeInfo &themeInfo);
+
         Theme(const ThemeInfo &themeInfo);
         ~Theme() override;
 
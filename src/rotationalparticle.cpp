@@ -29,12 +29,6 @@ RotationalParticle::RotationalParticle(Animation animation):
     mAnimation(std::move(animation))
 {}
 
-RotationalParticle::RotationalParticle(XML::Node animationNode,
-                                       const std::string &dyePalettes):
-    ImageParticle(nullptr),
-    mAnimation(animationNode, dyePalettes)
-{}
-
 RotationalParticle::~RotationalParticle() = default;
 
 bool RotationalParticle::update()
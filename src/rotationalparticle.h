@@ -24,8 +24,6 @@
 #include "imageparticle.h"
 #include "simpleanimation.h"
 
-#include "utils/xml.h"
-
 class Animation;
 class Map;
 class SimpleAnimation;
@@ -34,8 +32,6 @@ class RotationalParticle : public ImageParticle
 {
     public:
         explicit RotationalParticle(Animation animation);
-        explicit RotationalParticle(XML::Node animationNode,
-                                    const std::string &dyePalettes = std::string());
 
         ~RotationalParticle() override;
 
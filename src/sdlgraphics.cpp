@@ -31,6 +31,8 @@
 
 #include <cmath>
 
+static SDLGraphics *currentGraphics;
+
 std::unique_ptr<Graphics> SDLGraphics::create(SDL_Window *window, const VideoSettings &settings)
 {
     int rendererFlags = 0;
@@ -51,6 +53,8 @@ std::unique_ptr<Graphics> SDLGraphics::create(SDL_Window *window, const VideoSet
 SDLGraphics::SDLGraphics(SDL_Renderer *renderer)
     : mRenderer(renderer)
 {
+    currentGraphics = this;
+
     Image::setRenderer(mRenderer);
 
     SDL_GetRendererOutputSize(mRenderer, &mWidth, &mHeight);
@@ -82,9 +86,23 @@ SDLGraphics::SDLGraphics(SDL_Renderer *renderer)
 
 SDLGraphics::~SDLGraphics()
 {
+    if (currentGraphics == this)
+        currentGraphics = nullptr;
+
     SDL_DestroyRenderer(mRenderer);
 }
 
+void SDLGraphics::textureDeleted(SDL_Texture *texture)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (currentGraphics && currentGraphics->mBatchTexture == texture)
+    {
+        currentGraphics->flush();
+        currentGraphics->mBatchTexture = nullptr;
+    }
+#endif
+}
+
 void SDLGraphics::setVSync(bool sync)
 {
 #if SDL_VERSION_ATLEAST(2, 0, 18)
@@ -94,6 +112,8 @@ void SDLGraphics::setVSync(bool sync)
 
 void SDLGraphics::updateSize(int windowWidth, int windowHeight, float scale)
 {
+    flush();
+
     SDL_GetRendererOutputSize(mRenderer, &mWidth, &mHeight);
 
     float displayScaleX = windowWidth > 0 ? static_cast<float>(mWidth) / windowWidth : 1.0f;
@@ -105,6 +125,8 @@ void SDLGraphics::updateSize(int windowWidth, int windowHeight, float scale)
     mWidth = std::ceil(mWidth / scaleX);
     mHeight = std::ceil(mHeight / scaleY);
     mScale = scaleX;
+    mScaleX = scaleX;
+    mScaleY = scaleY;
 
     SDL_RenderSetScale(mRenderer, scaleX, scaleY);
 }
@@ -134,8 +156,18 @@ bool SDLGraphics::drawRescaledImage(const Image *image,
     dstRect.w = desiredWidth;
     dstRect.h = desiredHeight;
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    addQuad(image, srcRect, SDL_FRect {
+                static_cast<float>(dstRect.x),
+                static_cast<float>(dstRect.y),
+                static_cast<float>(dstRect.w),
+                static_cast<float>(dstRect.h)
+            });
+    return true;
+#else
     setColorAlphaMod(image);
     return SDL_RenderCopy(mRenderer, image->mTexture, &srcRect, &dstRect) != 0;
+#endif
 }
 
 #if SDL_VERSION_ATLEAST(2, 0, 10)
@@ -164,8 +196,13 @@ bool SDLGraphics::drawRescaledImageF(const Image *image,
     dstRect.w = desiredWidth;
     dstRect.h = desiredHeight;
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    addQuad(image, srcRect, dstRect);
+    return true;
+#else
     setColorAlphaMod(image);
     return SDL_RenderCopyF(mRenderer, image->mTexture, &srcRect, &dstRect) == 0;
+#endif
 }
 #endif
 
@@ -184,7 +221,9 @@ void SDLGraphics::drawRescaledImagePattern(const Image *image,
     if (scaledHeight <= 0 || scaledWidth <= 0)
         return;
 
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
     setColorAlphaMod(image);
+#endif
 
     SDL_Rect srcRect;
     srcRect.x = image->mBounds.x + srcX;
@@ -204,14 +243,58 @@ void SDLGraphics::drawRescaledImagePattern(const Image *image,
             srcRect.w = srcW * dstRect.w / scaledWidth;
             srcRect.h = srcH * dstRect.h / scaledHeight;
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+            addQuad(image, srcRect, SDL_FRect {
+                        static_cast<float>(dstRect.x),
+                        static_cast<float>(dstRect.y),
+                        static_cast<float>(dstRect.w),
+                        static_cast<float>(dstRect.h)
+                    });
+#else
             if (SDL_RenderCopy(mRenderer, image->mTexture, &srcRect, &dstRect))
                 return;
+#endif
         }
     }
 }
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void SDLGraphics::drawImageQuads(const Image *image,
+                                 const ImageQuad *quads, size_t count,
+                                 int x, int y)
+{
+    // Check that preconditions for blitting are met.
+    if (!image || !image->mTexture)
+        return;
+
+    x += mClipStack.top().xOffset;
+    y += mClipStack.top().yOffset;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ImageQuad &quad = quads[i];
+
+        const SDL_Rect srcRect {
+            image->mBounds.x + quad.srcX,
+            image->mBounds.y + quad.srcY,
+            quad.srcW,
+            quad.srcH
+        };
+
+        addQuad(image, srcRect, SDL_FRect {
+                    static_cast<float>(x + quad.dstX),
+                    static_cast<float>(y + quad.dstY),
+                    static_cast<float>(quad.dstW),
+                    static_cast<float>(quad.dstH)
+                });
+    }
+}
+#endif
+
 void SDLGraphics::updateScreen()
 {
+    flush();
+
     SDL_RenderPresent(mRenderer);
 
     // When the SDL renderer uses an OpenGL backend, call glFinish() to
@@ -260,6 +343,8 @@ SDL_Surface *SDLGraphics::getScreenshot()
 #endif
     int amask = 0x00000000;
 
+    flush();
+
     int width, height;
     if (SDL_GetRendererOutputSize(mRenderer, &width, &height) != 0)
         return nullptr;
@@ -279,8 +364,80 @@ SDL_Surface *SDLGraphics::getScreenshot()
     return screenshot;
 }
 
+std::unique_ptr<Image> SDLGraphics::createRenderTarget(int width, int height)
+{
+    if (!SDL_RenderTargetSupported(mRenderer))
+        return {};
+
+    const int pixelWidth = std::ceil(width * mScaleX);
+    const int pixelHeight = std::ceil(height * mScaleY);
+
+    SDL_Texture *texture = SDL_CreateTexture(mRenderer,
+                                             SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_TARGET,
+                                             pixelWidth, pixelHeight);
+    if (!texture)
+        return {};
+
+    // The target ends up with premultiplied alpha, since the alpha channel
+    // is accumulated the same way as the color channels
+    const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+            SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+            SDL_BLENDOPERATION_ADD);
+
+    if (SDL_SetTextureBlendMode(texture, premultiplied) != 0)
+    {
+        SDL_DestroyTexture(texture);
+        return {};
+    }
+
+    return std::unique_ptr<Image>(new Image(texture, pixelWidth, pixelHeight));
+}
+
+void SDLGraphics::drawRenderTarget(const Image *target,
+                                   int x, int y,
+                                   int width, int height)
+{
+    flush();
+
+    const gcn::ClipRectangle &top = mClipStack.top();
+    const SDL_Rect dstRect = {
+        x + top.xOffset,
+        y + top.yOffset,
+        width,
+        height
+    };
+
+    // With premultiplied alpha, the color needs to be faded as well
+    const auto alpha = static_cast<Uint8>(target->getAlpha() * 255);
+    SDL_SetTextureColorMod(target->mTexture, alpha, alpha, alpha);
+    SDL_SetTextureAlphaMod(target->mTexture, alpha);
+
+    SDL_RenderCopy(mRenderer, target->mTexture, nullptr, &dstRect);
+}
+
+void SDLGraphics::setRenderTarget(Image *target)
+{
+    flush();
+
+    SDL_SetRenderTarget(mRenderer, target ? target->mTexture : nullptr);
+
+    if (target)
+    {
+        // Changing the target resets the scale
+        SDL_RenderSetScale(mRenderer, mScaleX, mScaleY);
+
+        SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 0);
+        SDL_RenderClear(mRenderer);
+    }
+}
+
 void SDLGraphics::updateClipRect()
 {
+    flush();
+
     if (mClipRects.empty())
     {
         SDL_RenderSetClipRect(mRenderer, nullptr);
@@ -313,6 +470,7 @@ void SDLGraphics::drawPoint(int x, int y)
     if (!top.isPointInRect(x, y))
         return;
 
+    flush();
     SDL_SetRenderDrawColor(mRenderer,
                            (Uint8)(mColor.r),
                            (Uint8)(mColor.g),
@@ -335,6 +493,7 @@ void SDLGraphics::drawLine(int x1, int y1, int x2, int y2)
     x2 += top.xOffset;
     y2 += top.yOffset;
 
+    flush();
     SDL_SetRenderDrawColor(mRenderer,
                            (Uint8)(mColor.r),
                            (Uint8)(mColor.g),
@@ -358,6 +517,7 @@ void SDLGraphics::drawRectangle(const gcn::Rectangle &rectangle)
     rect.w = rectangle.width;
     rect.h = rectangle.height;
 
+    flush();
     SDL_SetRenderDrawColor(mRenderer,
                            (Uint8)(mColor.r),
                            (Uint8)(mColor.g),
@@ -390,6 +550,7 @@ void SDLGraphics::fillRectangle(const gcn::Rectangle &rectangle)
     rect.w = area.width;
     rect.h = area.height;
 
+    flush();
     SDL_SetRenderDrawColor(mRenderer,
                            (Uint8)(mColor.r),
                            (Uint8)(mColor.g),
@@ -398,18 +559,120 @@ void SDLGraphics::fillRectangle(const gcn::Rectangle &rectangle)
     SDL_RenderFillRect(mRenderer, &rect);
 }
 
-void SDLGraphics::setColorAlphaMod(const Image *image) const
+void SDLGraphics::fillRectangles(const std::vector<gcn::Rectangle> &rectangles)
 {
-    Uint8 r = 255, g = 255, b = 255, a = 255;
+    if (mClipStack.empty())
+    {
+        throw GCN_EXCEPTION("Clip stack is empty, perhaps you called a draw function outside of _beginDraw() and _endDraw()?");
+    }
+
+    const gcn::ClipRectangle &top = mClipStack.top();
+
+    mRects.clear();
+    for (const auto &rectangle : rectangles)
+    {
+        gcn::Rectangle area = rectangle;
+        area.x += top.xOffset;
+        area.y += top.yOffset;
+
+        if (area.isIntersecting(top))
+            mRects.push_back({ area.x, area.y, area.width, area.height });
+    }
+
+    if (mRects.empty())
+        return;
+
+    flush();
+    SDL_SetRenderDrawColor(mRenderer,
+                           (Uint8)(mColor.r),
+                           (Uint8)(mColor.g),
+                           (Uint8)(mColor.b),
+                           (Uint8)(mColor.a));
+    SDL_RenderFillRects(mRenderer, mRects.data(), mRects.size());
+}
+
+SDL_Color SDLGraphics::imageColor(const Image *image) const
+{
+    SDL_Color color = { 255, 255, 255, 255 };
     if (image->useColor())
     {
-        r = static_cast<Uint8>(mColor.r);
-        g = static_cast<Uint8>(mColor.g);
-        b = static_cast<Uint8>(mColor.b);
-        a = static_cast<Uint8>(mColor.a);
+        color.r = static_cast<Uint8>(mColor.r);
+        color.g = static_cast<Uint8>(mColor.g);
+        color.b = static_cast<Uint8>(mColor.b);
+        color.a = static_cast<Uint8>(mColor.a);
     }
 
+    color.a = static_cast<Uint8>(color.a * image->getAlpha());
+    return color;
+}
+
+void SDLGraphics::setColorAlphaMod(const Image *image) const
+{
+    const SDL_Color color = imageColor(image);
+
     SDL_Texture *texture = image->mTexture;
-    SDL_SetTextureColorMod(texture, r, g, b);
-    SDL_SetTextureAlphaMod(texture, static_cast<Uint8>(a * image->getAlpha()));
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void SDLGraphics::addQuad(const Image *image, const SDL_Rect &srcRect,
+                          const SDL_FRect &dstRect)
+{
+    SDL_Texture *texture = image->mTexture;
+    if (texture != mBatchTexture)
+    {
+        flush();
+
+        int width, height;
+        if (SDL_QueryTexture(texture, nullptr, nullptr, &width, &height) != 0)
+            return;
+
+        mBatchTexture = texture;
+        mTexelWidth = 1.0f / width;
+        mTexelHeight = 1.0f / height;
+    }
+
+    const SDL_Color color = imageColor(image);
+
+    const float left = dstRect.x;
+    const float top = dstRect.y;
+    const float right = dstRect.x + dstRect.w;
+    const float bottom = dstRect.y + dstRect.h;
+
+    const float texLeft = srcRect.x * mTexelWidth;
+    const float texTop = srcRect.y * mTexelHeight;
+    const float texRight = (srcRect.x + srcRect.w) * mTexelWidth;
+    const float texBottom = (srcRect.y + srcRect.h) * mTexelHeight;
+
+    mVertices.push_back({ { left, top }, color, { texLeft, texTop } });
+    mVertices.push_back({ { right, top }, color, { texRight, texTop } });
+    mVertices.push_back({ { left, bottom }, color, { texLeft, texBottom } });
+    mVertices.push_back({ { right, bottom }, color, { texRight, texBottom } });
+}
+#endif
+
+void SDLGraphics::flush()
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (mVertices.empty())
+        return;
+
+    // The indices only depend on the number of quads, so they are kept
+    const size_t indexCount = mVertices.size() / 4 * 6;
+    while (mIndices.size() < indexCount)
+    {
+        const int vertex = mIndices.size() / 6 * 4;
+        mIndices.insert(mIndices.end(), {
+                            vertex, vertex + 1, vertex + 2,
+                            vertex + 2, vertex + 1, vertex + 3
+                        });
+    }
+
+    SDL_RenderGeometry(mRenderer, mBatchTexture,
+                       mVertices.data(), mVertices.size(),
+                       mIndices.data(), indexCount);
+
+    mVertices.clear();
+#endif
 }
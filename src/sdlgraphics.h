@@ -24,9 +24,16 @@
 #include "graphics.h"
 
 #include <memory>
+#include <vector>
 
 struct VideoSettings;
 
+/**
+ * A renderer using the SDL render API.
+ *
+ * With SDL 2.0.18 or newer, consecutive images using the same texture are
+ * collected and drawn with a single SDL_RenderGeometry call.
+ */
 class SDLGraphics final : public Graphics
 {
 public:
@@ -36,6 +43,12 @@ public:
     SDLGraphics(SDL_Renderer *renderer);
     ~SDLGraphics() override;
 
+    /**
+     * Called before a texture is destroyed, so that any pending images
+     * using it are drawn first.
+     */
+    static void textureDeleted(SDL_Texture *texture);
+
     void setVSync(bool sync) override;
 
     void updateSize(int windowWidth, int windowHeight, float scale) override;
@@ -62,6 +75,12 @@ public:
                                   int scaledWidth,
                                   int scaledHeight) override;
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    void drawImageQuads(const Image *image,
+                        const ImageQuad *quads, size_t count,
+                        int x, int y) override;
+#endif
+
     void updateScreen() override;
 
     void windowToLogical(int windowX, int windowY,
@@ -69,6 +88,12 @@ public:
 
     SDL_Surface *getScreenshot() override;
 
+    std::unique_ptr<Image> createRenderTarget(int width, int height) override;
+
+    void drawRenderTarget(const Image *target,
+                          int x, int y,
+                          int width, int height) override;
+
     void drawPoint(int x, int y) override;
 
     void drawLine(int x1, int y1, int x2, int y2) override;
@@ -77,11 +102,41 @@ public:
 
     void fillRectangle(const gcn::Rectangle &rectangle) override;
 
+    void fillRectangles(const std::vector<gcn::Rectangle> &rectangles) override;
+
 protected:
     void updateClipRect() override;
+    void setRenderTarget(Image *target) override;
 
 private:
+    SDL_Color imageColor(const Image *image) const;
     void setColorAlphaMod(const Image *image) const;
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    /**
+     * Adds an image to the current batch, starting a new batch when it
+     * uses a different texture. The source rectangle is in texture pixels.
+     */
+    void addQuad(const Image *image, const SDL_Rect &srcRect,
+                 const SDL_FRect &dstRect);
+#endif
+
+    /**
+     * Draws the pending images. Needs to be called before anything else
+     * is drawn or any renderer state is changed.
+     */
+    void flush() override;
+
     SDL_Renderer *mRenderer = nullptr;
+    std::vector<SDL_Rect> mRects;   /**< Reused by fillRectangles */
+    float mScaleX = 1.0f;
+    float mScaleY = 1.0f;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+    SDL_Texture *mBatchTexture = nullptr;
+    float mTexelWidth = 1.0f;       /**< Inverse width of the batch texture */
+    float mTexelHeight = 1.0f;      /**< Inverse height of the batch texture */
+#endif
 };
@@ -30,11 +30,36 @@
 #include "resources/resourcemanager.h"
 #include "resources/soundeffect.h"
 
+#include "utils/filesystem.h"
+#include "utils/mutex.h"
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+/**
+ * The amount of decoded sound effect data that is kept around for sound
+ * effects that are not currently playing.
+ */
+static constexpr size_t SFX_CACHE_BUDGET = 32 * 1024 * 1024;
+
+/**
+ * Sound effects at a lower volume are not played, since they are too far away
+ * to be heard.
+ */
+static constexpr int SFX_MIN_VOLUME = 8;
+
+/**
+ * The maximum number of channels playing the same sound effect at once.
+ */
+static constexpr int MAX_CHANNELS_PER_SFX = 4;
+
 /**
- * This will be set to true when the music that was playing can be freed.
+ * These are set from the audio thread when the music or a channel has
+ * finished playing and can be freed.
  */
-static bool sMusicFinished;
-static bool sChannelFinished[Sound::CHANNEL_COUNT];
+static std::atomic<bool> sMusicFinished;
+static std::atomic<bool> sChannelFinished[Sound::CHANNEL_COUNT];
 
 static void musicFinishedCallBack()
 {
@@ -46,6 +71,111 @@ static void channelFinishedCallBack(int channel)
     sChannelFinished[channel] = true;
 }
 
+/**
+ * Loads and decodes sound effects on a separate thread.
+ */
+class SfxLoader
+{
+public:
+    using Loaded = std::vector<std::pair<std::string, SoundEffect *>>;
+
+    SfxLoader();
+    ~SfxLoader();
+
+    /**
+     * Queues the sound effect at the given path for loading.
+     */
+    void load(const std::string &path);
+
+    /**
+     * Moves the loaded sound effects to the given list. A failed load is
+     * reported with a <code>nullptr</code> sound effect.
+     */
+    void takeLoaded(Loaded &loaded);
+
+private:
+    static int loaderThread(void *data);
+
+    Mutex mMutex;
+    Condition mWakeUp;
+    std::deque<std::string> mQueue;
+    Loaded mLoaded;
+    SDL_Thread *mThread = nullptr;
+    bool mQuit = false;
+};
+
+SfxLoader::SfxLoader()
+{
+    mThread = SDL_CreateThread(loaderThread, "SfxLoader", this);
+}
+
+SfxLoader::~SfxLoader()
+{
+    {
+        MutexLocker lock(&mMutex);
+        mQuit = true;
+        mWakeUp.signal();
+    }
+
+    if (mThread)
+        SDL_WaitThread(mThread, nullptr);
+
+    for (auto &[_, sfx] : mLoaded)
+        delete sfx;
+}
+
+void SfxLoader::load(const std::string &path)
+{
+    MutexLocker lock(&mMutex);
+    mQueue.push_back(path);
+    mWakeUp.signal();
+}
+
+void SfxLoader::takeLoaded(Loaded &loaded)
+{
+    MutexLocker lock(&mMutex);
+    loaded.swap(mLoaded);
+}
+
+int SfxLoader::loaderThread(void *data)
+{
+    auto loader = static_cast<SfxLoader*>(data);
+
+    while (true)
+    {
+        std::string path;
+        {
+            MutexLocker lock(&loader->mMutex);
+
+            while (loader->mQueue.empty() && !loader->mQuit)
+                loader->mWakeUp.wait(loader->mMutex);
+
+            if (loader->mQuit)
+                break;
+
+            path = std::move(loader->mQueue.front());
+            loader->mQueue.pop_front();
+        }
+
+        SoundEffect *sfx = nullptr;
+        if (SDL_RWops *rw = FS::openBufferedRWops(path))
+            sfx = SoundEffect::load(rw);
+
+        MutexLocker lock(&loader->mMutex);
+        loader->mLoaded.emplace_back(std::move(path), sfx);
+    }
+
+    return 0;
+}
+
+static std::string sfxPath(const std::string &path)
+{
+    if (!path.compare(0, 4, "sfx/"))
+        return path;
+
+    return paths.getValue("sfx", "sfx/") + path;
+}
+
 Sound::Sound()
 {
     Mix_HookMusicFinished(musicFinishedCallBack);
@@ -91,6 +221,7 @@ void Sound::init()
 
     info();
 
+    mSfxLoader = std::make_unique<SfxLoader>();
     mInstalled = true;
 
     if (!mCurrentMusicFile.empty())
@@ -243,6 +374,9 @@ void Sound::logic()
             mSounds[i] = nullptr;
         }
     }
+
+    if (mInstalled)
+        receivePreloadedSfx();
 }
 
 void Sound::playSfx(const std::string &path, int x, int y)
@@ -250,34 +384,155 @@ void Sound::playSfx(const std::string &path, int x, int y)
     if (!mInstalled || path.empty())
         return;
 
-    std::string tmpPath;
-    if (!path.compare(0, 4, "sfx/"))
-        tmpPath = path;
-    else
-        tmpPath = paths.getValue("sfx", "sfx/") + path;
+    int vol = 120;
+
+    if (local_player && (x > 0 || y > 0))
+    {
+        const Vector &pos = local_player->getPosition();
+        const int dx = std::abs((int) pos.x - x);
+        const int dy = std::abs((int) pos.y - y);
+        const int dist = std::max(dx, dy);
+
+        // Volume goes down one level with each 4 pixels
+        vol -= std::min(120, dist / 4);
+    }
+
+    if (vol < SFX_MIN_VOLUME)
+        return;
+
+    ResourceRef<SoundEffect> sfx = getSfx(sfxPath(path));
+    if (!sfx)
+        return;
+
+    // The volume doubles as priority, so that nearby sounds are preferred
+    int channel = findSfxChannel(sfx, vol);
+    if (channel == -1)
+        return;
+
+    Log::info("Sound::playSfx() Playing: %s", path.c_str());
+
+    channel = sfx->play(0, vol, channel);
+    if (channel != -1)
+    {
+        sChannelFinished[channel] = false;
+        mSounds[channel] = sfx;
+        mSoundPriorities[channel] = vol;
+    }
+}
+
+void Sound::preloadSfx(const std::string &path)
+{
+    if (!mInstalled || path.empty())
+        return;
+
+    std::string fullPath = sfxPath(path);
+    if (mSfxCacheIndex.count(fullPath) || mPendingSfx.count(fullPath))
+        return;
+
+    mSfxLoader->load(fullPath);
+    mPendingSfx.insert(std::move(fullPath));
+}
+
+ResourceRef<SoundEffect> Sound::getSfx(const std::string &path)
+{
+    auto it = mSfxCacheIndex.find(path);
+    if (it != mSfxCacheIndex.end())
+    {
+        // Move to the front, as the most recently used sound effect
+        mSfxCache.splice(mSfxCache.begin(), mSfxCache, it->second);
+        return it->second->sfx;
+    }
 
     ResourceManager *resman = ResourceManager::getInstance();
+    ResourceRef<SoundEffect> sfx = resman->getSoundEffect(path);
+    if (sfx)
+        cacheSfx(path, sfx);
+
+    return sfx;
+}
+
+void Sound::cacheSfx(const std::string &path, ResourceRef<SoundEffect> sfx)
+{
+    mSfxCacheSize += sfx->getSize();
+    mSfxCache.push_front({ path, std::move(sfx) });
+    mSfxCacheIndex[path] = mSfxCache.begin();
 
-    if (ResourceRef<SoundEffect> sound = resman->getSoundEffect(tmpPath))
+    // Keep at least the sound effect that was just added
+    while (mSfxCacheSize > SFX_CACHE_BUDGET && mSfxCache.size() > 1)
     {
-        Log::info("Sound::playSfx() Playing: %s", path.c_str());
-        int vol = 120;
+        const CachedSfx &last = mSfxCache.back();
+        mSfxCacheSize -= last.sfx->getSize();
+        mSfxCacheIndex.erase(last.path);
+        mSfxCache.pop_back();
+    }
+}
 
-        if (local_player && (x > 0 || y > 0))
-        {
-            const Vector &pos = local_player->getPosition();
-            const int dx = std::abs((int) pos.x - x);
-            const int dy = std::abs((int) pos.y - y);
-            const int dist = std::max(dx, dy);
+void Sound::receivePreloadedSfx()
+{
+    SfxLoader::Loaded loaded;
+    mSfxLoader->takeLoaded(loaded);
+
+    ResourceManager *resman = ResourceManager::getInstance();
+
+    for (auto &[path, sfx] : loaded)
+    {
+        mPendingSfx.erase(path);
+
+        if (!sfx)
+            continue;
+
+        // May have been loaded in the meantime when it was played
+        ResourceRef<SoundEffect> resource = resman->addSoundEffect(path, sfx);
+        if (!mSfxCacheIndex.count(path))
+            cacheSfx(path, std::move(resource));
+    }
+}
+
+int Sound::findSfxChannel(const SoundEffect *sfx, int priority)
+{
+    int freeChannel = -1;
+    int weakestChannel = -1;
+    int weakestSameChannel = -1;
+    int sameCount = 0;
 
-            // Volume goes down one level with each 4 pixels
-            vol -= std::min(120, dist / 4);
+    for (int i = CHANNEL_RESERVED_COUNT; i < CHANNEL_COUNT; i++)
+    {
+        if (!Mix_Playing(i))
+        {
+            if (freeChannel == -1)
+                freeChannel = i;
+            continue;
         }
 
-        int channel = sound->play(0, vol);
-        if (channel != -1)
-            mSounds[channel] = sound;
+        if (weakestChannel == -1 ||
+            mSoundPriorities[i] < mSoundPriorities[weakestChannel])
+            weakestChannel = i;
+
+        if (mSounds[i] == sfx)
+        {
+            sameCount++;
+            if (weakestSameChannel == -1 ||
+                mSoundPriorities[i] < mSoundPriorities[weakestSameChannel])
+                weakestSameChannel = i;
+        }
     }
+
+    // Many instances of the same sound mostly add up to noise
+    int channel = freeChannel;
+    if (sameCount >= MAX_CHANNELS_PER_SFX)
+        channel = weakestSameChannel;
+    else if (channel == -1)
+        channel = weakestChannel;
+
+    if (channel == -1 || channel == freeChannel)
+        return channel;
+
+    // Only steal the channel from a sound that is not more important
+    if (mSoundPriorities[channel] > priority)
+        return -1;
+
+    Mix_HaltChannel(channel);
+    return channel;
 }
 
 void Sound::playNotification(const std::string &path)
@@ -300,11 +555,18 @@ void Sound::close()
 
     haltMusic();
 
+    mSfxLoader.reset();
+    mPendingSfx.clear();
+
     // Release the sound effect references now, while the ResourceManager is
     // still alive (~Sound runs after it, during static destruction).
     for (auto &soundEffect : mSounds)
         soundEffect = nullptr;
 
+    mSfxCache.clear();
+    mSfxCacheIndex.clear();
+    mSfxCacheSize = 0;
+
     Log::info("Sound::close() Shutting down sound...");
     Mix_CloseAudio();
 
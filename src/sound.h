@@ -25,9 +25,14 @@
 
 #include <SDL_mixer.h>
 
+#include <list>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 
 class Music;
+class SfxLoader;
 class SoundEffect;
 
 /** Sound engine
@@ -101,6 +106,14 @@ class Sound
          */
         void playSfx(const std::string &path, int x = 0, int y = 0);
 
+        /**
+         * Starts loading a sound effect in the background, so that it is
+         * ready when it is played.
+         *
+         * @param path The resource path to the sound file.
+         */
+        void preloadSfx(const std::string &path);
+
         /**
          * Plays a sound on the notification channel.
          *
@@ -130,6 +143,29 @@ class Sound
         /** Halts and frees currently playing music. */
         void haltMusic();
 
+        /**
+         * Returns the sound effect at the given path, loading it when it is
+         * not in the cache.
+         */
+        ResourceRef<SoundEffect> getSfx(const std::string &path);
+
+        /**
+         * Adds a sound effect to the cache, dropping the least recently used
+         * ones when the cache exceeds its budget.
+         */
+        void cacheSfx(const std::string &path, ResourceRef<SoundEffect> sfx);
+
+        /** Moves the sound effects loaded in the background to the cache. */
+        void receivePreloadedSfx();
+
+        /**
+         * Returns the channel to play a sound effect with the given priority
+         * on. When all channels are busy, or the sound effect is already
+         * playing on too many channels, the channel with the lowest priority
+         * is stopped. Returns -1 when the sound effect should not be played.
+         */
+        int findSfxChannel(const SoundEffect *sfx, int priority);
+
         /**
          * When calling fadeOutAndPlayMusic(),
          * the music file below will then be played
@@ -145,6 +181,21 @@ class Sound
         std::string mCurrentMusicFile;
         ResourceRef<Music> mMusic;
         ResourceRef<SoundEffect> mSounds[CHANNEL_COUNT];
+        int mSoundPriorities[CHANNEL_COUNT] = {};
+
+        struct CachedSfx
+        {
+            std::string path;
+            ResourceRef<SoundEffect> sfx;
+        };
+
+        /** Recently played and preloaded sound effects, most recent first */
+        std::list<CachedSfx> mSfxCache;
+        std::unordered_map<std::string, std::list<CachedSfx>::iterator> mSfxCacheIndex;
+        size_t mSfxCacheSize = 0;
+
+        std::set<std::string> mPendingSfx;  /**< Being loaded in the background */
+        std::unique_ptr<SfxLoader> mSfxLoader;
 };
 
 extern Sound sound;
@@ -35,7 +35,7 @@ Sprite::Sprite(SpriteDef *sprite):
     assert(mSprite);
 
     // Play the stand animation by default
-    play(SpriteAction::STAND);
+    play(SpriteAction::STAND_ID);
 }
 
 Sprite *Sprite::load(const std::string &filename, int variant)
@@ -64,6 +64,11 @@ bool Sprite::reset()
 }
 
 bool Sprite::play(const std::string &spriteAction)
+{
+    return play(SpriteAction::getId(spriteAction));
+}
+
+bool Sprite::play(ActionId spriteAction)
 {
     Action *action = mSprite->getAction(spriteAction);
     if (!action)
@@ -94,7 +99,7 @@ bool Sprite::update(int dt)
     if (!updateCurrentAnimation(dt))
     {
         // Animation finished, reset to default
-        play(SpriteAction::STAND);
+        play(SpriteAction::STAND_ID);
     }
 
     // Make sure something actually changed
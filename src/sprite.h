@@ -64,6 +64,7 @@ class Sprite
          *
          * @returns true if the sprite changed, false otherwise
          */
+        bool play(ActionId action);
         bool play(const std::string &action);
 
         /**
@@ -110,6 +111,16 @@ class Sprite
          */
         const Image *getImage() const;
 
+        /**
+         * Returns the current frame, or nullptr when there is none.
+         */
+        const Frame *getFrame() const { return mFrame; }
+
+        /**
+         * Returns the sprite definition.
+         */
+        SpriteDef *getSpriteDef() const { return mSprite; }
+
         /**
          * Sets the direction.
          *
@@ -71,6 +71,10 @@ class Text
         int mWidth;            /**< The width of the text. */
         int mHeight;           /**< The height of the text. */
         int mXOffset;          /**< The offset of mX from the desired x. */
+        int mWantedX;          /**< The x-value requested by the owner. */
+        int mWantedY;          /**< The y-value requested by the owner. */
+        bool mPending = false; /**< Whether the text needs to be placed. */
+        bool mIndexed = false; /**< Whether the text is in the spatial index. */
         static int mInstances; /**< Instances of text. */
         std::string mText;     /**< The text to display. */
         const gcn::Color *mColor;     /**< The color of the text. */
@@ -23,29 +23,57 @@
 
 #include "text.h"
 
+#include <algorithm>
 #include <cstring>
 
 TextManager *textManager = nullptr;
 
+/**
+ * Width in pixels of the columns used to look up nearby texts.
+ */
+static constexpr int COLUMN_WIDTH = 64;
+
+static int columnAt(int x)
+{
+    return x >= 0 ? x / COLUMN_WIDTH : (x - COLUMN_WIDTH + 1) / COLUMN_WIDTH;
+}
+
 TextManager::TextManager()
 {
 }
 
 void TextManager::addText(Text *text)
 {
-    place(text, nullptr, text->mX, text->mY, text->mHeight);
+    text->mWantedX = text->mX;
+    text->mWantedY = text->mY;
+    text->mPending = true;
+    mPending.push_back(text);
     mTextList.push_back(text);
 }
 
 void TextManager::moveText(Text *text, int x, int y)
 {
-    text->mX = x;
-    text->mY = y;
-    place(text, text, text->mX, text->mY, text->mHeight);
+    // Keep the current placement when the owner didn't move
+    if (text->mWantedX == x && text->mWantedY == y)
+        return;
+
+    text->mWantedX = x;
+    text->mWantedY = y;
+
+    if (!text->mPending)
+    {
+        text->mPending = true;
+        mPending.push_back(text);
+    }
 }
 
-void TextManager::removeText(const Text *text)
+void TextManager::removeText(Text *text)
 {
+    removeFromIndex(text);
+
+    if (text->mPending)
+        mPending.erase(std::find(mPending.begin(), mPending.end(), text));
+
     for (auto ptr = mTextList.begin(),
              pEnd = mTextList.end(); ptr != pEnd; ++ptr)
     {
@@ -61,15 +89,79 @@ TextManager::~TextManager() = default;
 
 void TextManager::draw(gcn::Graphics *graphics, int xOff, int yOff)
 {
+    placePending();
+
     for (auto text : mTextList)
     {
         text->draw(graphics, xOff, yOff);
     }
 }
 
-void TextManager::place(const Text *textObj, const Text *omit,
-                        int &x, int &y, int h)
+void TextManager::placePending()
+{
+    for (auto text : mPending)
+    {
+        if (text->mX != text->mWantedX)
+        {
+            removeFromIndex(text);
+            text->mX = text->mWantedX;
+        }
+
+        text->mY = text->mWantedY;
+        text->mPending = false;
+
+        place(text);
+        addToIndex(text);
+    }
+
+    mPending.clear();
+}
+
+void TextManager::addToIndex(Text *text)
 {
+    if (text->mIndexed)
+        return;
+
+    const int first = columnAt(text->mX);
+    const int last = columnAt(text->mX + text->mWidth - 1);
+    for (int column = first; column <= last; ++column)
+        mColumns[column].push_back(text);
+
+    text->mIndexed = true;
+}
+
+void TextManager::removeFromIndex(Text *text)
+{
+    if (!text->mIndexed)
+        return;
+
+    const int first = columnAt(text->mX);
+    const int last = columnAt(text->mX + text->mWidth - 1);
+    for (int column = first; column <= last; ++column)
+    {
+        auto it = mColumns.find(column);
+        if (it == mColumns.end())
+            continue;
+
+        auto &texts = it->second;
+        auto textIt = std::find(texts.begin(), texts.end(), text);
+        if (textIt != texts.end())
+        {
+            *textIt = texts.back();
+            texts.pop_back();
+        }
+
+        if (texts.empty())
+            mColumns.erase(it);
+    }
+
+    text->mIndexed = false;
+}
+
+void TextManager::place(Text *textObj)
+{
+    const int h = textObj->mHeight;
+    int &y = textObj->mY;
     int xLeft = textObj->mX;
     int xRight = xLeft + textObj->mWidth - 1;
     const int TEST = 100; // Number of lines to test for text
@@ -78,22 +170,33 @@ void TextManager::place(const Text *textObj, const Text *omit,
     int wantedTop = (TEST - h) / 2; // Entry in occupied at top of text
     int occupiedTop = y - wantedTop; // Line in map representing to of occupied
 
-    for (auto text : mTextList)
+    // Texts covering several columns may be visited more than once, which
+    // doesn't matter for marking the occupied lines
+    const int firstColumn = columnAt(xLeft);
+    const int lastColumn = columnAt(xRight);
+    for (int column = firstColumn; column <= lastColumn; ++column)
     {
-        if (text != omit &&
-            text->mX <= xRight &&
-            text->mX + text->mWidth > xLeft)
+        auto it = mColumns.find(column);
+        if (it == mColumns.end())
+            continue;
+
+        for (auto text : it->second)
         {
-            int from = text->mY - occupiedTop;
-            int to = from + text->mHeight - 1;
-            if (to < 0 || from >= TEST) // out of range considered
-                continue;
-            if (from < 0)
-                from = 0;
-            if (to >= TEST)
-                to = TEST - 1;
-            for (int i = from; i <= to; ++i)
-                occupied[i] = true;
+            if (text != textObj &&
+                text->mX <= xRight &&
+                text->mX + text->mWidth > xLeft)
+            {
+                int from = text->mY - occupiedTop;
+                int to = from + text->mHeight - 1;
+                if (to < 0 || from >= TEST) // out of range considered
+                    continue;
+                if (from < 0)
+                    from = 0;
+                if (to >= TEST)
+                    to = TEST - 1;
+                for (int i = from; i <= to; ++i)
+                    occupied[i] = true;
+            }
         }
     }
     bool ok = true;
@@ -22,11 +22,20 @@
 #pragma once
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 #include "guichanfwd.h"
 
 class Text;
 
+/**
+ * Keeps texts on the map from overlapping each other.
+ *
+ * Texts are placed once per frame, before drawing, and only when their
+ * owner moved them. Nearby texts are found through an index of the texts
+ * by the columns they cover.
+ */
 class TextManager
 {
     public:
@@ -45,7 +54,7 @@ class TextManager
         /**
          * Remove the text from the manager
          */
-        void removeText(const Text *text);
+        void removeText(Text *text);
 
         /**
          * Destroy the manager
@@ -58,13 +67,24 @@ class TextManager
         void draw(gcn::Graphics *graphics, int xOff, int yOff);
 
     private:
+        /**
+         * Places the texts that were added or moved since the last frame.
+         */
+        void placePending();
+
         /**
          * Position the text so as to avoid conflict
          */
-        void place(const Text *textObj, const Text *omit,
-        int &x, int &y, int h);
+        void place(Text *text);
+
+        void addToIndex(Text *text);
+        void removeFromIndex(Text *text);
 
         std::list<Text *> mTextList;
+        std::vector<Text *> mPending;
+
+        /** Texts by the columns they cover */
+        std::unordered_map<int, std::vector<Text *>> mColumns;
 };
 
 extern TextManager *textManager;
@@ -21,8 +21,11 @@
 
 #pragma once
 
+#include "resources/image.h"
 #include "resources/imageset.h"
 
+#include <string>
+
 /**
  * A tileset, which is basically just an image set but it stores a firstgid.
  */
@@ -32,8 +35,13 @@ class Tileset : public ImageSet
         Tileset(Image *img, int w, int h, unsigned firstGid,
                 int margin, int spacing):
             ImageSet(img, w, h, margin, spacing),
-            mFirstGid(firstGid)
+            mFirstGid(firstGid),
+            mImagePath(img->getIdPath()),
+            mMargin(margin),
+            mSpacing(spacing)
         {
+            for (int x = margin; x + w <= img->getWidth() - margin; x += w + spacing)
+                mColumns++;
         }
 
         /**
@@ -44,6 +52,34 @@ class Tileset : public ImageSet
             return mFirstGid;
         }
 
+        /**
+         * Returns the path of the image this tileset was created from.
+         */
+        const std::string &getImagePath() const
+        {
+            return mImagePath;
+        }
+
+        /**
+         * Returns the area of the tile with the given index within the
+         * tileset image.
+         */
+        SDL_Rect getTileRect(size_t index) const
+        {
+            const int column = mColumns > 0 ? index % mColumns : 0;
+            const int row = mColumns > 0 ? index / mColumns : 0;
+            return {
+                mMargin + column * (getWidth() + mSpacing),
+                mMargin + row * (getHeight() + mSpacing),
+                getWidth(),
+                getHeight()
+            };
+        }
+
     private:
         unsigned mFirstGid;
+        std::string mImagePath;
+        int mMargin;
+        int mSpacing;
+        int mColumns = 0;
 };
@@ -0,0 +1,581 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/contentpack.h"
+
+#include "log.h"
+
+#include "utils/contentpackformat.h"
+#include "utils/mappedfile.h"
+#include "utils/mutex.h"
+
+#include <SDL_endian.h>
+#include <SDL_rwops.h>
+
+#include <physfs.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace ContentPackFormat;
+
+namespace {
+
+/**
+ * The largest size a file in a content pack may have once uncompressed.
+ * Packs are downloaded from update hosts, so their sizes can't be trusted.
+ */
+constexpr uint64_t MAX_ENTRY_SIZE = 256 * 1024 * 1024;
+
+/**
+ * The maximum compression ratio of zlib's deflate.
+ */
+constexpr uint64_t MAX_COMPRESSION_RATIO = 1032;
+
+/**
+ * Reads the whole archive into the file, for when it can't be mapped, for
+ * example because it is itself inside an archive.
+ */
+bool readFile(PHYSFS_Io *io, MappedFile &file)
+{
+    const PHYSFS_sint64 length = io->length(io);
+    if (length <= 0 || !io->seek(io, 0))
+        return false;
+
+    std::vector<uint8_t> buffer(static_cast<size_t>(length));
+    if (io->read(io, buffer.data(), buffer.size()) != length)
+        return false;
+
+    file.assign(std::move(buffer));
+    return true;
+}
+
+/**
+ * A mounted content pack.
+ */
+struct Pack : std::enable_shared_from_this<Pack>
+{
+    ~Pack()
+    {
+        if (io)
+            io->destroy(io);
+    }
+
+    const Entry *find(std::string_view path) const;
+    std::string_view entryName(const Entry &entry) const;
+    const std::vector<std::string> *findDirectory(std::string_view path) const;
+
+    void addToDirectory(std::string_view path);
+
+    std::string name;
+    PHYSFS_Io *io = nullptr;
+    MappedFile file;
+    const Entry *entries = nullptr;
+    uint32_t entryCount = 0;
+    const char *names = nullptr;
+
+    /** Maps directory paths to the names of the files and directories
+        they contain. The root directory has an empty path. */
+    std::unordered_map<std::string, std::vector<std::string>> directories;
+};
+
+const Entry *Pack::find(std::string_view path) const
+{
+    const uint64_t hash = hashPath(path);
+    const Entry *end = entries + entryCount;
+    auto it = std::lower_bound(entries, end, hash,
+                               [] (const Entry &entry, uint64_t hash) {
+        return entry.hash < hash;
+    });
+
+    for (; it != end && it->hash == hash; ++it)
+        if (entryName(*it) == path)
+            return it;
+
+    return nullptr;
+}
+
+std::string_view Pack::entryName(const Entry &entry) const
+{
+    return std::string_view(names + entry.nameOffset, entry.nameLength);
+}
+
+const std::vector<std::string> *Pack::findDirectory(std::string_view path) const
+{
+    auto it = directories.find(std::string(path));
+    return it != directories.end() ? &it->second : nullptr;
+}
+
+void Pack::addToDirectory(std::string_view path)
+{
+    const auto slash = path.rfind('/');
+    const std::string_view parent = slash == std::string_view::npos
+            ? std::string_view() : path.substr(0, slash);
+    const std::string_view child = slash == std::string_view::npos
+            ? path : path.substr(slash + 1);
+
+    auto [it, inserted] = directories.try_emplace(std::string(parent));
+    it->second.emplace_back(child);
+
+    // A newly seen directory needs to be listed in its own parent
+    if (inserted && !parent.empty())
+        addToDirectory(parent);
+}
+
+Mutex packsMutex;
+std::vector<std::shared_ptr<Pack>> packs;
+
+std::shared_ptr<Pack> findPack(const char *name)
+{
+    MutexLocker lock(&packsMutex);
+    for (auto &pack : packs)
+        if (pack->name == name)
+            return pack;
+    return nullptr;
+}
+
+/**
+ * The state of a read-only view on a block of memory. The owner keeps the
+ * memory alive.
+ */
+struct MemoryView
+{
+    std::shared_ptr<const void> owner;
+    const uint8_t *data;
+    uint64_t size;
+    uint64_t pos = 0;
+};
+
+//
+// PHYSFS_Io implementation
+//
+
+PHYSFS_Io *createIo(std::shared_ptr<const void> owner,
+                    const uint8_t *data, uint64_t size);
+
+PHYSFS_sint64 ioRead(PHYSFS_Io *io, void *buffer, PHYSFS_uint64 len)
+{
+    auto view = static_cast<MemoryView *>(io->opaque);
+    const uint64_t n = std::min(len, view->size - view->pos);
+    std::memcpy(buffer, view->data + view->pos, n);
+    view->pos += n;
+    return static_cast<PHYSFS_sint64>(n);
+}
+
+PHYSFS_sint64 ioWrite(PHYSFS_Io *, const void *, PHYSFS_uint64)
+{
+    PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+    return -1;
+}
+
+int ioSeek(PHYSFS_Io *io, PHYSFS_uint64 offset)
+{
+    auto view = static_cast<MemoryView *>(io->opaque);
+    if (offset > view->size)
+    {
+        PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+        return 0;
+    }
+    view->pos = offset;
+    return 1;
+}
+
+PHYSFS_sint64 ioTell(PHYSFS_Io *io)
+{
+    return static_cast<MemoryView *>(io->opaque)->pos;
+}
+
+PHYSFS_sint64 ioLength(PHYSFS_Io *io)
+{
+    return static_cast<MemoryView *>(io->opaque)->size;
+}
+
+PHYSFS_Io *ioDuplicate(PHYSFS_Io *io)
+{
+    auto view = static_cast<MemoryView *>(io->opaque);
+    return createIo(view->owner, view->data, view->size);
+}
+
+int ioFlush(PHYSFS_Io *)
+{
+    return 1;
+}
+
+void ioDestroy(PHYSFS_Io *io)
+{
+    delete static_cast<MemoryView *>(io->opaque);
+    delete io;
+}
+
+PHYSFS_Io *createIo(std::shared_ptr<const void> owner,
+                    const uint8_t *data, uint64_t size)
+{
+    auto io = new PHYSFS_Io;
+    io->version = 0;
+    io->opaque = new MemoryView { std::move(owner), data, size };
+    io->read = ioRead;
+    io->write = ioWrite;
+    io->seek = ioSeek;
+    io->tell = ioTell;
+    io->length = ioLength;
+    io->duplicate = ioDuplicate;
+    io->flush = ioFlush;
+    io->destroy = ioDestroy;
+    return io;
+}
+
+//
+// PHYSFS_Archiver implementation
+//
+
+void *archiveOpen(PHYSFS_Io *io, const char *name, int forWrite, int *claimed)
+{
+    Header header;
+    if (!io->seek(io, 0) ||
+            io->read(io, &header, sizeof(header)) != sizeof(header) ||
+            std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+        return nullptr;
+    }
+
+    *claimed = 1;
+
+    if (forWrite)
+    {
+        PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+        return nullptr;
+    }
+
+    if (SDL_BYTEORDER != SDL_LIL_ENDIAN || header.version != VERSION)
+    {
+        Log::warn("Unsupported content pack: %s", name);
+        PHYSFS_setErrorCode(PHYSFS_ERR_UNSUPPORTED);
+        return nullptr;
+    }
+
+    auto pack = std::make_shared<Pack>();
+    if (!pack->file.map(name) && !readFile(io, pack->file))
+    {
+        PHYSFS_setErrorCode(PHYSFS_ERR_IO);
+        return nullptr;
+    }
+
+    // Validate the index before trusting any offsets in it
+    const uint64_t size = pack->file.size();
+    const uint64_t indexSize = uint64_t(header.entryCount) * sizeof(Entry);
+    if (header.indexOffset > size || indexSize > size - header.indexOffset ||
+            header.indexOffset % alignof(Entry) != 0 ||
+            header.namesOffset > size || header.namesSize > size - header.namesOffset)
+    {
+        Log::warn("Corrupt content pack: %s", name);
+        PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+        return nullptr;
+    }
+
+    const uint8_t *data = pack->file.data();
+    pack->entries = reinterpret_cast<const Entry *>(data + header.indexOffset);
+    pack->entryCount = header.entryCount;
+    pack->names = reinterpret_cast<const char *>(data + header.namesOffset);
+
+    pack->directories.try_emplace(std::string());
+
+    for (uint32_t i = 0; i < pack->entryCount; ++i)
+    {
+        const Entry &entry = pack->entries[i];
+        const bool compressed = entry.flags & ENTRY_COMPRESSED;
+        if (entry.offset > size || entry.size > size - entry.offset ||
+                uint64_t(entry.nameOffset) + entry.nameLength > header.namesSize ||
+                entry.originalSize > MAX_ENTRY_SIZE ||
+                (compressed && entry.originalSize > entry.size * MAX_COMPRESSION_RATIO) ||
+                (!compressed && entry.originalSize != entry.size))
+        {
+            Log::warn("Corrupt content pack: %s", name);
+            PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+            return nullptr;
+        }
+
+        pack->addToDirectory(pack->entryName(entry));
+    }
+
+    // The pack takes ownership of the io once it was opened successfully
+    pack->name = name;
+    pack->io = io;
+
+    Log::info("Mapped content pack %s (%u entries)", name, pack->entryCount);
+
+    MutexLocker lock(&packsMutex);
+    packs.push_back(pack);
+    return pack.get();
+}
+
+PHYSFS_EnumerateCallbackResult archiveEnumerate(void *opaque,
+                                         const char *dirname,
+                                         PHYSFS_EnumerateCallback cb,
+                                         const char *origdir,
+                                         void *callbackdata)
+{
+    auto pack = static_cast<const Pack *>(opaque);
+    auto children = pack->findDirectory(dirname);
+    if (!children)
+        return PHYSFS_ENUM_OK;
+
+    for (const std::string &child : *children)
+    {
+        auto result = cb(callbackdata, origdir, child.c_str());
+        if (result == PHYSFS_ENUM_ERROR)
+            PHYSFS_setErrorCode(PHYSFS_ERR_APP_CALLBACK);
+        if (result != PHYSFS_ENUM_OK)
+            return result;
+    }
+
+    return PHYSFS_ENUM_OK;
+}
+
+PHYSFS_Io *archiveOpenRead(void *opaque, const char *path)
+{
+    auto pack = static_cast<Pack *>(opaque);
+    const Entry *entry = pack->find(path);
+    if (!entry)
+    {
+        PHYSFS_setErrorCode(pack->findDirectory(path) ? PHYSFS_ERR_NOT_A_FILE
+                                                      : PHYSFS_ERR_NOT_FOUND);
+        return nullptr;
+    }
+
+    const uint8_t *data = pack->file.data() + entry->offset;
+
+    if (!(entry->flags & ENTRY_COMPRESSED))
+    {
+        // Keep the pack alive for as long as the file is open
+        return createIo(pack->shared_from_this(), data, entry->size);
+    }
+
+    std::shared_ptr<std::vector<uint8_t>> buffer;
+    try
+    {
+        buffer = std::make_shared<std::vector<uint8_t>>(entry->originalSize);
+    }
+    catch (const std::bad_alloc &)
+    {
+        PHYSFS_setErrorCode(PHYSFS_ERR_OUT_OF_MEMORY);
+        return nullptr;
+    }
+
+    uLongf length = static_cast<uLongf>(entry->originalSize);
+    if (uncompress(buffer->data(), &length, data,
+                   static_cast<uLong>(entry->size)) != Z_OK ||
+            length != entry->originalSize)
+    {
+        Log::warn("Corrupt entry in content pack %s: %s",
+                  pack->name.c_str(), path);
+        PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+        return nullptr;
+    }
+
+    const uint8_t *uncompressed = buffer->data();
+    return createIo(std::move(buffer), uncompressed, length);
+}
+
+PHYSFS_Io *archiveOpenWrite(void *, const char *)
+{
+    PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+    return nullptr;
+}
+
+int archiveRemove(void *, const char *)
+{
+    PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+    return 0;
+}
+
+int archiveStat(void *opaque, const char *path, PHYSFS_Stat *stat)
+{
+    auto pack = static_cast<const Pack *>(opaque);
+
+    stat->modtime = -1;
+    stat->createtime = -1;
+    stat->accesstime = -1;
+    stat->readonly = 1;
+
+    if (const Entry *entry = pack->find(path))
+    {
+        stat->filesize = static_cast<PHYSFS_sint64>(entry->originalSize);
+        stat->filetype = PHYSFS_FILETYPE_REGULAR;
+        return 1;
+    }
+
+    if (pack->findDirectory(path))
+    {
+        stat->filesize = 0;
+        stat->filetype = PHYSFS_FILETYPE_DIRECTORY;
+        return 1;
+    }
+
+    PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+    return 0;
+}
+
+void archiveClose(void *opaque)
+{
+    // Open files may still hold on to the pack
+    MutexLocker lock(&packsMutex);
+    packs.erase(std::remove_if(packs.begin(), packs.end(),
+                               [opaque] (const std::shared_ptr<Pack> &pack) {
+        return pack.get() == opaque;
+    }), packs.end());
+}
+
+//
+// SDL_RWops implementation
+//
+
+Sint64 rwSize(SDL_RWops *rw)
+{
+    return static_cast<MemoryView *>(rw->hidden.unknown.data1)->size;
+}
+
+Sint64 rwSeek(SDL_RWops *rw, Sint64 offset, int whence)
+{
+    auto view = static_cast<MemoryView *>(rw->hidden.unknown.data1);
+    Sint64 pos;
+    switch (whence)
+    {
+    case RW_SEEK_SET: pos = offset; break;
+    case RW_SEEK_CUR: pos = static_cast<Sint64>(view->pos) + offset; break;
+    case RW_SEEK_END: pos = static_cast<Sint64>(view->size) + offset; break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    if (pos < 0 || static_cast<uint64_t>(pos) > view->size)
+        return SDL_SetError("Attempt to seek outside of content pack entry");
+
+    view->pos = static_cast<uint64_t>(pos);
+    return pos;
+}
+
+size_t rwRead(SDL_RWops *rw, void *ptr, size_t size, size_t maxnum)
+{
+    auto view = static_cast<MemoryView *>(rw->hidden.unknown.data1);
+    if (size == 0)
+        return 0;
+
+    const size_t num = std::min<uint64_t>(maxnum, (view->size - view->pos) / size);
+    std::memcpy(ptr, view->data + view->pos, num * size);
+    view->pos += num * size;
+    return num;
+}
+
+size_t rwWrite(SDL_RWops *, const void *, size_t, size_t)
+{
+    SDL_SetError("Content pack entries are read-only");
+    return 0;
+}
+
+int rwClose(SDL_RWops *rw)
+{
+    delete static_cast<MemoryView *>(rw->hidden.unknown.data1);
+    SDL_FreeRW(rw);
+    return 0;
+}
+
+PHYSFS_Archiver archiver = {
+    0,
+    {
+        "manapak",
+        "Mana content pack",
+        "The Mana Developers",
+        "https://www.manasource.org/",
+        0,
+    },
+    archiveOpen,
+    archiveEnumerate,
+    archiveOpenRead,
+    archiveOpenWrite,
+    archiveOpenWrite,
+    archiveRemove,
+    archiveRemove,
+    archiveStat,
+    archiveClose,
+};
+
+} // anonymous namespace
+
+namespace ContentPack {
+
+bool registerArchiver()
+{
+    if (!PHYSFS_registerArchiver(&archiver))
+    {
+        Log::warn("Failed to register content pack archiver: %s",
+                  PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+        return false;
+    }
+    return true;
+}
+
+SDL_RWops *openRWops(const std::string &path)
+{
+    {
+        MutexLocker lock(&packsMutex);
+        if (packs.empty())
+            return nullptr;
+    }
+
+    const char *realDir = PHYSFS_getRealDir(path.c_str());
+    if (!realDir)
+        return nullptr;
+
+    auto pack = findPack(realDir);
+    if (!pack)
+        return nullptr;
+
+    std::string_view entryPath = path;
+    while (!entryPath.empty() && entryPath.front() == '/')
+        entryPath.remove_prefix(1);
+
+    const Entry *entry = pack->find(entryPath);
+    if (!entry || (entry->flags & ENTRY_COMPRESSED))
+        return nullptr;
+
+    SDL_RWops *rw = SDL_AllocRW();
+    if (!rw)
+        return nullptr;
+
+    const uint8_t *data = pack->file.data() + entry->offset;
+
+    rw->type = SDL_RWOPS_UNKNOWN;
+    rw->size = rwSize;
+    rw->seek = rwSeek;
+    rw->read = rwRead;
+    rw->write = rwWrite;
+    rw->close = rwClose;
+    rw->hidden.unknown.data1 = new MemoryView { std::move(pack), data, entry->size };
+    return rw;
+}
+
+} // namespace ContentPack
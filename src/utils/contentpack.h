@@ -0,0 +1,52 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+struct SDL_RWops;
+
+/**
+ * Support for Mana content packs (.manapak), see utils/contentpackformat.h
+ * for the format and tools/packcmd for creating them.
+ *
+ * Packs are memory mapped when they are added to the search path. Entries
+ * are found by hash, and uncompressed entries are read straight from the
+ * mapping without any copying.
+ */
+namespace ContentPack {
+
+/**
+ * Registers the PhysFS archiver for content packs, so that they can be
+ * added to the search path like zip archives. Needs to be called after
+ * PHYSFS_init.
+ */
+bool registerArchiver();
+
+/**
+ * Opens the given file as a read-only view on the memory of the content pack
+ * that provides it. Returns nullptr when the file is not provided by a content
+ * pack or is stored compressed, in which case the caller should fall back
+ * to reading it through PhysFS.
+ */
+SDL_RWops *openRWops(const std::string &path);
+
+} // namespace ContentPack
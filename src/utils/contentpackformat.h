@@ -0,0 +1,90 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Layout of a Mana content pack. This header is shared with the packcmd tool
+ * and should not depend on anything else.
+ *
+ * A pack starts with a Header, followed by the data of the entries, the
+ * index of Entry records and finally the entry paths. All numbers are
+ * stored in little-endian byte order.
+ *
+ * The index is sorted by the hash of the entry paths, so that an entry can be
+ * found with a binary search. The data of each entry starts at a multiple of
+ * ALIGNMENT, so that it can be used directly from a memory mapping of the
+ * pack.
+ */
+namespace ContentPackFormat {
+
+constexpr char MAGIC[8] = { 'M', 'A', 'N', 'A', 'P', 'A', 'K', '\0' };
+constexpr uint32_t VERSION = 1;
+constexpr uint64_t ALIGNMENT = 4096;
+
+enum EntryFlags : uint32_t
+{
+    ENTRY_COMPRESSED = 1,   /**< The data is zlib compressed */
+};
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t indexOffset;   /**< Offset of the first Entry */
+    uint64_t namesOffset;   /**< Offset of the entry paths */
+    uint64_t namesSize;     /**< Total size of the entry paths */
+};
+
+struct Entry
+{
+    uint64_t hash;          /**< Hash of the path, see hashPath() */
+    uint64_t offset;        /**< Offset of the data */
+    uint64_t size;          /**< Size of the stored data */
+    uint64_t originalSize;  /**< Size of the data when uncompressed */
+    uint32_t nameOffset;    /**< Offset of the path, relative to namesOffset */
+    uint32_t nameLength;    /**< Length of the path, not null-terminated */
+    uint32_t flags;         /**< See EntryFlags */
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 40, "Unexpected Header size");
+static_assert(sizeof(Entry) == 48, "Unexpected Entry size");
+
+/**
+ * Returns the 64-bit FNV-1a hash of the given path. Paths use '/' as
+ * separator and have no leading slash.
+ */
+constexpr uint64_t hashPath(std::string_view path)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : path)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace ContentPackFormat
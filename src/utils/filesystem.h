@@ -23,6 +23,7 @@
 // Suppress deprecation warnings for PHYSFS_getUserDir
 #define PHYSFS_DEPRECATED
 
+#include "utils/contentpack.h"
 #include "utils/physfsrwops.h"
 
 #include <optional>
@@ -36,7 +37,12 @@ namespace FS {
 
 inline bool init(const char *argv0)
 {
-    return PHYSFS_init(argv0) != 0;
+    if (PHYSFS_init(argv0) == 0)
+        return false;
+
+    // Content packs are optional, so failing to register them is not fatal
+    ContentPack::registerArchiver();
+    return true;
 }
 
 inline void deinit()
@@ -258,8 +264,15 @@ inline const char *getLastError()
 // Helper functions for loading files through SDL_RWops
 //
 
+/**
+ * Opens a file for reading. Uncompressed files in content packs are read
+ * directly from memory.
+ */
 inline SDL_RWops *openRWops(const std::string &path)
 {
+    if (auto rw = ContentPack::openRWops(path))
+        return rw;
+
     return PHYSFSRWOPS_openRead(path.c_str());
 }
 
@@ -274,6 +287,10 @@ inline SDL_RWops *openRWops(const std::string &path)
 inline SDL_RWops *openBufferedRWops(const std::string &path,
                                     PHYSFS_uint64 bufferSize = 2048)
 {
+    // Reading from a content pack does not need buffering
+    if (auto rw = ContentPack::openRWops(path))
+        return rw;
+
     if (auto file = PHYSFS_openRead(path.c_str()))
     {
         PHYSFS_setBuffer(file, bufferSize);
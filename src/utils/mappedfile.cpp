@@ -0,0 +1,131 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+bool MappedFile::map(const std::string &path)
+{
+    unmap();
+
+#ifdef _WIN32
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (length <= 0)
+        return false;
+
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The mapping keeps the file open
+    mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mMapping)
+        return false;
+
+    void *data = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+        return false;
+    }
+
+    mSize = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after closing the file
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    mSize = static_cast<uint64_t>(st.st_size);
+#endif
+
+    mData = static_cast<const uint8_t *>(data);
+    mMapped = true;
+    return true;
+}
+
+void MappedFile::assign(std::vector<uint8_t> buffer)
+{
+    unmap();
+
+    mBuffer = std::move(buffer);
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+}
+
+void MappedFile::unmap()
+{
+    if (mMapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+#else
+        munmap(const_cast<uint8_t *>(mData), mSize);
+#endif
+        mMapped = false;
+    }
+
+    mBuffer.clear();
+    mBuffer.shrink_to_fit();
+    mData = nullptr;
+    mSize = 0;
+}
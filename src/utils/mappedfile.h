@@ -0,0 +1,68 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * A read-only memory mapping of a file. When a file can't be mapped, its
+ * contents can be assigned from memory instead.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * Maps the file at the given path, replacing any previous contents.
+     * Empty files can't be mapped.
+     */
+    bool map(const std::string &path);
+
+    /**
+     * Replaces the contents with the given buffer.
+     */
+    void assign(std::vector<uint8_t> buffer);
+
+    /**
+     * Releases the mapping or buffer.
+     */
+    void unmap();
+
+    const uint8_t *data() const { return mData; }
+    uint64_t size() const { return mSize; }
+
+private:
+    const uint8_t *mData = nullptr;
+    uint64_t mSize = 0;
+    std::vector<uint8_t> mBuffer;
+    bool mMapped = false;
+
+#ifdef _WIN32
+    void *mMapping = nullptr;   // HANDLE, kept opaque to avoid windows.h
+#endif
+};
@@ -25,6 +25,8 @@
 
 #include <SDL_thread.h>
 
+#include <cstdint>
+
 /**
  * A mutex provides mutual exclusion of access to certain data that is
  * accessed by multiple threads.
@@ -42,9 +44,38 @@ public:
     void unlock();
 
 private:
+    friend class Condition;
+
     SDL_mutex *mMutex;
 };
 
+/**
+ * A condition variable, which allows a thread to wait until it is signaled
+ * by another thread. The given mutex must be locked when waiting.
+ */
+class Condition
+{
+public:
+    Condition();
+    ~Condition();
+    Condition(const Condition&) = delete;   // prevent copying
+    Condition& operator=(const Condition&) = delete;
+
+    void wait(Mutex &mutex);
+
+    /**
+     * Waits for at most the given amount of milliseconds. Returns whether
+     * the condition was signaled.
+     */
+    bool wait(Mutex &mutex, uint32_t timeoutMs);
+
+    void signal();
+    void broadcast();
+
+private:
+    SDL_cond *mCondition;
+};
+
 /**
  * A convenience class for locking a mutex.
  */
@@ -85,6 +116,38 @@ inline void Mutex::unlock()
 }
 
 
+inline Condition::Condition()
+{
+    mCondition = SDL_CreateCond();
+}
+
+inline Condition::~Condition()
+{
+    SDL_DestroyCond(mCondition);
+}
+
+inline void Condition::wait(Mutex &mutex)
+{
+    if (SDL_CondWait(mCondition, mutex.mMutex) == -1)
+        Log::info("Condition waiting failed: %s", SDL_GetError());
+}
+
+inline bool Condition::wait(Mutex &mutex, uint32_t timeoutMs)
+{
+    return SDL_CondWaitTimeout(mCondition, mutex.mMutex, timeoutMs) == 0;
+}
+
+inline void Condition::signal()
+{
+    SDL_CondSignal(mCondition);
+}
+
+inline void Condition::broadcast()
+{
+    SDL_CondBroadcast(mCondition);
+}
+
+
 inline MutexLocker::MutexLocker(Mutex *mutex):
     mMutex(mutex)
 {
@@ -0,0 +1,233 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/taskgraph.h"
+
+#include "log.h"
+
+#include <SDL_cpuinfo.h>
+
+#include <algorithm>
+
+/**
+ * The upper limit of worker threads. Startup tasks are mostly bound by I/O
+ * and decoding, so more threads don't help much.
+ */
+static constexpr int MAX_WORKER_THREADS = 4;
+
+/**
+ * How often the idle function is called while waiting for workers.
+ */
+static constexpr uint32_t IDLE_INTERVAL_MS = 16;
+
+static double toMs(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+TaskGraph::TaskId TaskGraph::add(std::string name, Thread thread,
+                                 std::function<void()> function,
+                                 std::vector<TaskId> dependencies)
+{
+    const TaskId id = static_cast<TaskId>(mTasks.size());
+
+    Task &task = mTasks.emplace_back();
+    task.name = std::move(name);
+    task.thread = thread;
+    task.function = std::move(function);
+    task.pendingDependencies = static_cast<int>(dependencies.size());
+
+    // Dependencies need to be added first, which also rules out cycles
+    for (TaskId dependency : dependencies)
+        mTasks.at(dependency).dependents.push_back(id);
+
+    return id;
+}
+
+void TaskGraph::run(const std::function<void(float progress)> &idle)
+{
+    mStart = Clock::now();
+
+    const bool hasWorkerTasks = std::any_of(mTasks.begin(), mTasks.end(),
+                                            [] (const Task &task) {
+        return task.thread == Thread::Worker;
+    });
+
+    std::vector<SDL_Thread *> threads;
+    if (hasWorkerTasks)
+    {
+        const int count = std::clamp(SDL_GetCPUCount() - 1, 1, MAX_WORKER_THREADS);
+        for (int i = 0; i < count; ++i)
+            if (SDL_Thread *thread = SDL_CreateThread(workerThread, "TaskGraph", this))
+                threads.push_back(thread);
+
+        if (threads.empty())
+            Log::warn("Failed to create task threads, running tasks serially");
+    }
+
+    mMutex.lock();
+
+    for (TaskId id = 0; id < static_cast<TaskId>(mTasks.size()); ++id)
+    {
+        const Task &task = mTasks[id];
+        if (task.pendingDependencies > 0)
+            continue;
+
+        if (task.thread == Thread::Main || threads.empty())
+            mReadyMain.push_back(id);
+        else
+            mReadyWorker.push_back(id);
+    }
+    mWorkerWakeUp.broadcast();
+
+    while (mFinished < mTasks.size())
+    {
+        if (!mReadyMain.empty())
+        {
+            const TaskId id = mReadyMain.front();
+            mReadyMain.pop_front();
+            ++mRunning;
+
+            mMutex.unlock();
+            execute(id);
+            mMutex.lock();
+
+            finish(id);
+            continue;
+        }
+
+        if (mRunning == 0 && mReadyWorker.empty())
+        {
+            Log::error("TaskGraph: %zu tasks can't run",
+                       mTasks.size() - mFinished);
+            break;
+        }
+
+        if (threads.empty())
+        {
+            // Without workers, the worker tasks run on this thread as well
+            mReadyMain.insert(mReadyMain.end(),
+                              mReadyWorker.begin(), mReadyWorker.end());
+            mReadyWorker.clear();
+            continue;
+        }
+
+        if (idle)
+        {
+            const float progress = static_cast<float>(mFinished) / mTasks.size();
+            mMutex.unlock();
+            idle(progress);
+            mMutex.lock();
+
+            if (!mReadyMain.empty() || mFinished == mTasks.size())
+                continue;
+        }
+
+        mMainWakeUp.wait(mMutex, IDLE_INTERVAL_MS);
+    }
+
+    mQuit = true;
+    mWorkerWakeUp.broadcast();
+    mMutex.unlock();
+
+    for (SDL_Thread *thread : threads)
+        SDL_WaitThread(thread, nullptr);
+
+    mTotalMs = toMs(Clock::now() - mStart);
+}
+
+std::vector<TaskGraph::Timing> TaskGraph::getTimings() const
+{
+    std::vector<Timing> timings;
+    timings.reserve(mTasks.size());
+
+    for (const Task &task : mTasks)
+    {
+        timings.push_back({ task.name,
+                            task.thread,
+                            toMs(task.start - mStart),
+                            toMs(task.end - task.start) });
+    }
+
+    return timings;
+}
+
+int TaskGraph::workerThread(void *data)
+{
+    auto graph = static_cast<TaskGraph *>(data);
+    MutexLocker lock(&graph->mMutex);
+
+    while (true)
+    {
+        while (!graph->mQuit && graph->mReadyWorker.empty())
+            graph->mWorkerWakeUp.wait(graph->mMutex);
+
+        if (graph->mQuit)
+            break;
+
+        const TaskId id = graph->mReadyWorker.front();
+        graph->mReadyWorker.pop_front();
+        ++graph->mRunning;
+
+        graph->mMutex.unlock();
+        graph->execute(id);
+        graph->mMutex.lock();
+
+        graph->finish(id);
+    }
+
+    return 0;
+}
+
+void TaskGraph::execute(TaskId id)
+{
+    Task &task = mTasks[id];
+    task.start = Clock::now();
+    task.function();
+    task.end = Clock::now();
+}
+
+void TaskGraph::finish(TaskId id)
+{
+    --mRunning;
+    ++mFinished;
+
+    bool wakeWorkers = false;
+    for (TaskId dependentId : mTasks[id].dependents)
+    {
+        Task &dependent = mTasks[dependentId];
+        if (--dependent.pendingDependencies > 0)
+            continue;
+
+        if (dependent.thread == Thread::Main)
+        {
+            mReadyMain.push_back(dependentId);
+        }
+        else
+        {
+            mReadyWorker.push_back(dependentId);
+            wakeWorkers = true;
+        }
+    }
+
+    if (wakeWorkers)
+        mWorkerWakeUp.broadcast();
+    mMainWakeUp.signal();
+}
@@ -0,0 +1,120 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "utils/mutex.h"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Runs a set of tasks that may depend on each other. Tasks run on a pool of
+ * worker threads as soon as their dependencies are done, except for tasks
+ * that need to run on the main thread (for example because they use the
+ * renderer), which are run from run().
+ *
+ * Tasks should not throw exceptions.
+ */
+class TaskGraph
+{
+public:
+    enum class Thread
+    {
+        Main,
+        Worker
+    };
+
+    using TaskId = int;
+
+    struct Timing
+    {
+        std::string name;
+        Thread thread;
+        double startMs;     /**< Relative to the start of run() */
+        double durationMs;
+    };
+
+    TaskGraph() = default;
+    ~TaskGraph() = default;
+
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    /**
+     * Adds a task, which will only run after the given tasks are done.
+     */
+    TaskId add(std::string name, Thread thread,
+               std::function<void()> function,
+               std::vector<TaskId> dependencies = {});
+
+    /**
+     * Runs all tasks and returns when they are done. While waiting for
+     * worker threads, \a idle is called regularly on the main thread with
+     * the fraction of tasks that are done.
+     */
+    void run(const std::function<void(float progress)> &idle = {});
+
+    /**
+     * Returns the timings of the tasks, in the order they were added.
+     */
+    std::vector<Timing> getTimings() const;
+
+    /**
+     * Returns the time run() took in milliseconds.
+     */
+    double getTotalMs() const { return mTotalMs; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task
+    {
+        std::string name;
+        Thread thread;
+        std::function<void()> function;
+        std::vector<TaskId> dependents;
+        int pendingDependencies = 0;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    static int workerThread(void *data);
+
+    void execute(TaskId id);
+    void finish(TaskId id);
+
+    std::vector<Task> mTasks;
+    std::deque<TaskId> mReadyMain;
+    std::deque<TaskId> mReadyWorker;
+    size_t mRunning = 0;
+    size_t mFinished = 0;
+    bool mQuit = false;
+
+    Clock::time_point mStart;
+    double mTotalMs = 0.0;
+
+    Mutex mMutex;
+    Condition mMainWakeUp;
+    Condition mWorkerWakeUp;
+};
@@ -26,6 +26,7 @@
 #include "utils/stringutils.h"
 
 #ifdef USE_OPENGL
+#include "modernopenglgraphics.h"
 #include "openglgraphics.h"
 #endif
 
@@ -151,7 +152,18 @@ Graphics *Video::initialize(const VideoSettings &settings)
     SDL_GetWindowSize(mWindow, &mSettings.width, &mSettings.height);
 
 #ifdef USE_OPENGL
-    if (mSettings.openGL)
+    if (mSettings.openGL && mSettings.modernOpenGL)
+    {
+        mGraphics = ModernOpenGLGraphics::create(mWindow, mSettings);
+        if (!mGraphics)
+        {
+            Log::info("Failed to create OpenGL 3.3 renderer, falling back to legacy OpenGL: %s",
+                        SDL_GetError());
+            mSettings.modernOpenGL = false;
+        }
+    }
+
+    if (mSettings.openGL && !mGraphics)
     {
         mGraphics = OpenGLGraphics::create(mWindow, mSettings);
         if (!mGraphics)
@@ -266,6 +278,16 @@ void Video::present()
     }
 }
 
+int Video::refreshRate() const
+{
+    SDL_DisplayMode mode;
+    const int displayIndex = SDL_GetWindowDisplayIndex(mWindow);
+    if (displayIndex < 0 || SDL_GetCurrentDisplayMode(displayIndex, &mode) != 0)
+        return 0;
+
+    return mode.refresh_rate;
+}
+
 bool Video::initDisplayModes()
 {
     const int displayIndex = mSettings.display;
@@ -51,6 +51,7 @@ struct VideoSettings
     int userScale = 0;
     bool vsync = true;
     bool openGL = false;
+    bool modernOpenGL = false;  /**< Prefer the OpenGL 3.3 renderer */
 
     int scale() const;
     int autoScale() const;
@@ -64,7 +65,8 @@ struct VideoSettings
                 display == other.display &&
                 userScale == other.userScale &&
                 vsync == other.vsync &&
-                openGL == other.openGL;
+                openGL == other.openGL &&
+                modernOpenGL == other.modernOpenGL;
     }
 };
 
@@ -98,6 +100,12 @@ public:
      */
     void present();
 
+    /**
+     * Returns the refresh rate of the display showing the window, or 0 when
+     * it is unknown.
+     */
+    int refreshRate() const;
+
     const DisplayMode &desktopDisplayMode() const
     {
         return mDesktopDisplayMode;
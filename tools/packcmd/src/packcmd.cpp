@@ -0,0 +1,243 @@
+/*
+ *  The Mana Client
+ *  Copyright (C) 2026  The Mana Developers
+ *
+ *  This file is part of The Mana Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/contentpackformat.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace ContentPackFormat;
+
+// return values
+enum ReturnValues
+{
+    RETURN_OK = 0,
+    INVALID_PARAMETER_LIST = 100,
+    INVALID_SOURCE_DIRECTORY = 101,
+    INVALID_TARGET_PACK = 102,
+    READ_ERROR = 103,
+    COMPRESSION_ERROR = 104,
+    TOO_MANY_FILES = 105,
+};
+
+struct PackFile
+{
+    std::string name;
+    fs::path path;
+};
+
+static bool readFile(const fs::path &path, std::vector<unsigned char> &data)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+/**
+ * Compresses the data when that saves at least a quarter of its size.
+ * Returns whether the data was compressed.
+ */
+static bool compress(std::vector<unsigned char> &data, bool &error)
+{
+    error = false;
+
+    uLongf length = compressBound(static_cast<uLong>(data.size()));
+    std::vector<unsigned char> compressed(length);
+    if (compress2(compressed.data(), &length, data.data(),
+                  static_cast<uLong>(data.size()), Z_BEST_COMPRESSION) != Z_OK)
+    {
+        error = true;
+        return false;
+    }
+
+    if (length > data.size() - data.size() / 4)
+        return false;
+
+    compressed.resize(length);
+    data.swap(compressed);
+    return true;
+}
+
+static void pad(std::ofstream &out, uint64_t &offset, uint64_t alignment)
+{
+    static const char zeros[ALIGNMENT] = {};
+    const uint64_t padding = (alignment - offset % alignment) % alignment;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+    offset += padding;
+}
+
+int main(int argc, char *argv[])
+{
+    bool compressFiles = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--compress") == 0)
+            compressFiles = true;
+        else
+            args.emplace_back(argv[i]);
+    }
+
+    if (args.size() != 2)
+    {
+        std::cout << "Usage: packcmd [--compress] <source_directory> <target_pack>"
+                  << std::endl;
+        return INVALID_PARAMETER_LIST;
+    }
+
+    const fs::path sourceDir = args[0];
+    const fs::path target = args[1];
+
+    std::error_code ec;
+    if (!fs::is_directory(sourceDir, ec))
+    {
+        std::cout << "Source is not a directory: " << sourceDir << std::endl;
+        return INVALID_SOURCE_DIRECTORY;
+    }
+
+    std::vector<PackFile> files;
+    for (auto &entry : fs::recursive_directory_iterator(sourceDir, ec))
+    {
+        if (!entry.is_regular_file())
+            continue;
+
+        // Don't pack the target when it is written into the source directory
+        std::error_code equivalentError;
+        if (fs::equivalent(entry.path(), target, equivalentError))
+            continue;
+
+        files.push_back({ fs::relative(entry.path(), sourceDir).generic_string(),
+                          entry.path() });
+    }
+
+    if (ec)
+    {
+        std::cout << "Error reading " << sourceDir << ": " << ec.message()
+                  << std::endl;
+        return INVALID_SOURCE_DIRECTORY;
+    }
+
+    if (files.size() > UINT32_MAX)
+        return TOO_MANY_FILES;
+
+    std::ofstream out(target, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "Could not open " << target << " for writing" << std::endl;
+        return INVALID_TARGET_PACK;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(files.size());
+
+    // The header is written again at the end, once the offsets are known
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    std::vector<Entry> entries;
+    std::string names;
+    uint64_t totalSize = 0;
+    uint64_t storedSize = 0;
+
+    for (const PackFile &file : files)
+    {
+        std::vector<unsigned char> data;
+        if (!readFile(file.path, data))
+        {
+            std::cout << "Could not read " << file.path << std::endl;
+            return READ_ERROR;
+        }
+
+        Entry entry = {};
+        entry.hash = hashPath(file.name);
+        entry.originalSize = data.size();
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(file.name.size());
+        names += file.name;
+
+        bool error = false;
+        if (compressFiles && !data.empty() && compress(data, error))
+            entry.flags |= ENTRY_COMPRESSED;
+        if (error)
+        {
+            std::cout << "Could not compress " << file.path << std::endl;
+            return COMPRESSION_ERROR;
+        }
+
+        pad(out, offset, ALIGNMENT);
+        entry.offset = offset;
+        entry.size = data.size();
+        out.write(reinterpret_cast<const char *>(data.data()),
+                  static_cast<std::streamsize>(data.size()));
+        offset += data.size();
+
+        totalSize += entry.originalSize;
+        storedSize += entry.size;
+        entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [&names] (const Entry &a, const Entry &b) {
+        if (a.hash != b.hash)
+            return a.hash < b.hash;
+        return names.compare(a.nameOffset, a.nameLength,
+                             names, b.nameOffset, b.nameLength) < 0;
+    });
+
+    pad(out, offset, alignof(Entry));
+    header.indexOffset = offset;
+    out.write(reinterpret_cast<const char *>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    offset += entries.size() * sizeof(Entry);
+
+    header.namesOffset = offset;
+    header.namesSize = names.size();
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if (!out.flush())
+    {
+        std::cout << "Error writing " << target << std::endl;
+        return INVALID_TARGET_PACK;
+    }
+
+    std::cout << "Packed " << entries.size() << " files (" << totalSize
+              << " bytes, " << storedSize << " bytes stored) into " << target
+              << std::endl;
+
+    return RETURN_OK;
+}